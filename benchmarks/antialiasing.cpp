@@ -0,0 +1,137 @@
+// Compares per-primitive anti-aliasing with FXAA over the whole scene on a
+// heavy scene of small shapes. Build with -DCRIDGEON_BUILD_BENCHMARKS=ON and
+// run from the build directory so resources/ is found.
+
+#include "gl-basic.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace cridgeon;
+
+static const int WIDTH = 1920;
+static const int HEIGHT = 1080;
+static const int WARMUP_FRAMES = 30;
+static const int MEASURED_FRAMES = 200;
+
+static void drawScene(int frame) {
+    // Small shapes are where per-primitive AA costs the most: the edge
+    // padding is a large share of each quad
+    for (int i = 0; i < 20000; ++i) {
+        float x = static_cast<float>((i * 37 + frame) % WIDTH);
+        float y = static_cast<float>((i * 53) % HEIGHT);
+        float radius = 3.0f + (i % 10);
+        Render::circleFilled(x, y, radius, 0.9f, 0.5f + (i % 5) * 0.1f, 0.2f, 0.8f);
+    }
+    for (int i = 0; i < 3000; ++i) {
+        float x = static_cast<float>((i * 71) % WIDTH);
+        float y = static_cast<float>((i * 29 + frame) % HEIGHT);
+        Render::roundedRect(x, y, 24.0f, 14.0f, 4.0f, 0.2f, 0.6f, 0.9f, 0.8f);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        float x = static_cast<float>((i * 97) % WIDTH);
+        float y = static_cast<float>((i * 61) % HEIGHT);
+        Render::cubicCurve(x, y, x + 40.0f, y + 80.0f, x + 80.0f, y - 80.0f, x + 120.0f, y,
+                           2.0f, 1.0f, 1.0f, 1.0f, 0.7f);
+    }
+
+    // GL_LINES: aliased unless FXAA smooths them
+    std::vector<float> vertices;
+    for (int i = 0; i < 128; ++i) {
+        vertices.push_back(0.0f);
+        vertices.push_back(static_cast<float>(i * 8));
+        vertices.push_back(static_cast<float>(WIDTH));
+        vertices.push_back(static_cast<float>(i * 8 + 200 + frame % 100));
+    }
+    Render::lines(vertices, 0.8f, 0.8f, 0.3f, 1.0f);
+}
+
+struct Result {
+    double gpuMs;
+    double cpuMs;
+};
+
+static Result run(RenderingSystem& rs, PostProcessor& post, bool shapeAntiAliasing, bool fxaa) {
+    Render::setShapeAntiAliasing(shapeAntiAliasing);
+    post.setFXAAEnabled(fxaa);
+
+    unsigned int query = 0;
+    glGenQueries(1, &query);
+    double gpuTotal = 0.0, cpuTotal = 0.0;
+    int measured = 0;
+
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES && rs.shouldContinue(); ++frame) {
+        rs.beginFrame();
+        auto start = std::chrono::steady_clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, query);
+
+        post.beginRender();
+        drawScene(frame);
+        post.endRender();
+
+        glEndQuery(GL_TIME_ELAPSED);
+        auto end = std::chrono::steady_clock::now();
+
+        // Waiting for the result stalls the pipeline, which is fine here
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        rs.endFrame();
+
+        if (frame >= WARMUP_FRAMES) {
+            gpuTotal += nanoseconds / 1.0e6;
+            cpuTotal += std::chrono::duration<double, std::milli>(end - start).count();
+            ++measured;
+        }
+    }
+    glDeleteQueries(1, &query);
+
+    Result result = {0.0, 0.0};
+    if (measured > 0) {
+        result.gpuMs = gpuTotal / measured;
+        result.cpuMs = cpuTotal / measured;
+    }
+    return result;
+}
+
+int main() {
+    RenderingSystem& rs = RenderingSystem::getInstance();
+    if (!rs.initialize(WIDTH, HEIGHT, "Anti-aliasing benchmark")) {
+        return 1;
+    }
+    if (!glCapabilities().timerQuery) {
+        std::fprintf(stderr, "Timer queries need a GL 3.3 context\n");
+        return 1;
+    }
+
+    int result = 0;
+    {
+        PostProcessor post;
+        if (!post.initialize(rs.getWindowWidth(), rs.getWindowHeight()) ||
+            !post.loadEffect("passthrough", "resources/shaders/postprocess/passthrough.frag")) {
+            result = 1;
+        } else {
+            struct Mode {
+                const char* name;
+                bool shapeAntiAliasing;
+                bool fxaa;
+            };
+            const Mode modes[] = {
+                {"no anti-aliasing", false, false},
+                {"per-primitive", true, false},
+                {"FXAA", false, true},
+                {"per-primitive + FXAA", true, true},
+            };
+
+            std::printf("%-24s %10s %10s\n", "mode", "GPU ms", "CPU ms");
+            for (const Mode& mode : modes) {
+                Result timing = run(rs, post, mode.shapeAntiAliasing, mode.fxaa);
+                std::printf("%-24s %10.3f %10.3f\n", mode.name, timing.gpuMs, timing.cpuMs);
+            }
+        }
+    }
+
+    Render::destroyAllShaders();
+    rs.shutdown();
+    return result;
+}
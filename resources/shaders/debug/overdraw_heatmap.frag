@@ -0,0 +1,30 @@
+#version 130
+in vec2 pixelCoord;
+out vec4 color;
+
+uniform sampler2D counts;       // Fragment count / 255 per pixel
+uniform vec2 resolution;
+uniform float maxCount;         // Count shown at the hot end of the ramp
+
+void main() {
+    float count = texture(counts, pixelCoord / resolution).r * 255.0;
+    if (count < 0.5) {
+        color = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // Blue (drawn once) through green and yellow to red, then white past maxCount
+    float t = clamp((count - 1.0) / max(maxCount - 1.0, 1.0), 0.0, 1.0);
+    vec3 ramp;
+    if (t < 0.33) {
+        ramp = mix(vec3(0.0, 0.2, 1.0), vec3(0.0, 1.0, 0.2), t / 0.33);
+    } else if (t < 0.66) {
+        ramp = mix(vec3(0.0, 1.0, 0.2), vec3(1.0, 1.0, 0.0), (t - 0.33) / 0.33);
+    } else {
+        ramp = mix(vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), (t - 0.66) / 0.34);
+    }
+    if (count > maxCount) {
+        ramp = mix(ramp, vec3(1.0), clamp((count - maxCount) / maxCount, 0.0, 1.0));
+    }
+    color = vec4(ramp, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 130
+// Replays geometry captured by transform feedback without re-expanding it
+in vec4 capturedPosition;
+in vec4 capturedColor;
+in vec2 capturedEdge;
+
+out vec4 fragVertexColor;
+out vec2 edge;
+
+void main() {
+    gl_Position = capturedPosition;
+    fragVertexColor = capturedColor;
+    edge = capturedEdge;
+}
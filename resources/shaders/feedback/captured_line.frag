@@ -0,0 +1,13 @@
+#version 130
+in vec4 fragVertexColor;
+in vec2 edge;
+out vec4 fragColor;
+
+void main() {
+    // Coverage of the pixel across the line edge
+    float coverage = clamp(edge.y + 0.5 - abs(edge.x), 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    fragColor = vec4(fragVertexColor.rgb, fragVertexColor.a * coverage);
+}
@@ -0,0 +1,34 @@
+#version 130
+// Expands line segments into screen-space quads (two triangles per segment).
+// Output is captured with transform feedback and redrawn until invalidated.
+in vec4 segment;        // x1, y1, x2, y2 in pixels
+in vec2 corner;         // x: 0 = start, 1 = end; y: -1 / +1 = side
+in float width;         // Line width in screen pixels
+in vec4 vertexColor;
+
+uniform vec2 resolution;
+uniform vec2 viewOffset;
+uniform float viewScale;
+
+out vec4 capturedColor;
+out vec2 capturedEdge;  // Signed distance across the line, half width (pixels)
+
+void main() {
+    vec2 p0 = segment.xy * viewScale + viewOffset;
+    vec2 p1 = segment.zw * viewScale + viewOffset;
+
+    vec2 dir = p1 - p0;
+    float len = length(dir);
+    dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    // Half a pixel of padding on each side for the anti-aliased edge
+    float halfWidth = width * 0.5;
+    float extent = halfWidth + 0.5;
+    vec2 base = mix(p0, p1, corner.x) + dir * (corner.x * 2.0 - 1.0) * extent;
+    vec2 pixel = base + normal * corner.y * extent;
+
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+    capturedColor = vertexColor;
+    capturedEdge = vec2(corner.y * extent, halfWidth);
+}
@@ -0,0 +1,7 @@
+#version 130
+in vec4 fragVertexColor;
+out vec4 fragColor;
+
+void main() {
+    fragColor = fragVertexColor;
+}
@@ -0,0 +1,12 @@
+#version 130
+in vec2 position;
+in vec4 vertexColor;
+uniform vec2 resolution;
+out vec2 pixelCoord;
+out vec4 fragVertexColor;
+
+void main() {
+    gl_Position = vec4(position, 0.0, 1.0);
+    pixelCoord = ((position + 1.0) / 2.0) * resolution;
+    fragVertexColor = vertexColor;
+}
@@ -0,0 +1,44 @@
+#version 130
+// One segment (t0..t1) of a stroked cubic Bézier. The curve is evaluated
+// here, so neighbouring segments share exact end points and normals.
+in vec2 corner;         // x: 0 = t0, 1 = t1; y: 0 / 1 = side
+in vec4 points01;       // p0, p1 in pixels
+in vec4 points23;       // p2, p3 in pixels
+in vec4 segment;        // t0, t1, width, unused
+in vec4 color;
+
+uniform vec2 resolution;
+uniform float antialias;    // 1 with anti-aliasing, 0 without
+
+out vec4 fragVertexColor;
+out vec2 edge;          // Signed distance across the stroke, half width (pixels)
+
+void main() {
+    vec2 p0 = points01.xy;
+    vec2 p1 = points01.zw;
+    vec2 p2 = points23.xy;
+    vec2 p3 = points23.zw;
+
+    float t = mix(segment.x, segment.y, corner.x);
+    float mt = 1.0 - t;
+    vec2 position = mt * mt * mt * p0 + 3.0 * mt * mt * t * p1 + 3.0 * mt * t * t * p2 + t * t * t * p3;
+    vec2 tangent = 3.0 * mt * mt * (p1 - p0) + 6.0 * mt * t * (p2 - p1) + 3.0 * t * t * (p3 - p2);
+
+    // Coincident control points give a zero derivative at the ends
+    if (dot(tangent, tangent) < 1e-8) {
+        tangent = p3 - p0;
+    }
+    float len = length(tangent);
+    vec2 dir = len > 0.0 ? tangent / len : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    // Half a pixel of padding on each side for the anti-aliased edge
+    float halfWidth = segment.z * 0.5;
+    float extent = halfWidth + 0.5 * antialias;
+    float side = corner.y * 2.0 - 1.0;
+    vec2 pixel = position + normal * side * extent;
+
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+    fragVertexColor = color;
+    edge = vec2(side * extent, halfWidth);
+}
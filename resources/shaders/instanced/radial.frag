@@ -0,0 +1,45 @@
+#version 130
+in vec2 localPosition;
+in vec4 shapeParams;
+in vec4 sectorParams;
+in vec4 fragVertexColor;
+out vec4 fragColor;
+
+uniform float antialias;
+
+const float TWO_PI = 6.28318530718;
+const float PI = 3.14159265359;
+
+void main() {
+    float outerRadius = shapeParams.z;
+    float innerRadius = shapeParams.w;
+    float start = sectorParams.x;
+    float span = sectorParams.y;
+
+    // Signed distance to the annulus
+    float len = length(localPosition);
+    float distance = max(len - outerRadius, innerRadius - len);
+
+    if (span < TWO_PI) {
+        // Signed distance to the wedge between the start and end rays
+        float end = start + span;
+        float toStart = dot(localPosition, vec2(sin(start), -cos(start)));
+        float toEnd = dot(localPosition, vec2(-sin(end), cos(end)));
+        float wedge = span <= PI ? max(toStart, toEnd) : min(toStart, toEnd);
+        distance = max(distance, wedge);
+
+        if (sectorParams.z > 0.5) {
+            float middle = (outerRadius + innerRadius) * 0.5;
+            float capRadius = (outerRadius - innerRadius) * 0.5;
+            float startCap = length(localPosition - vec2(cos(start), sin(start)) * middle) - capRadius;
+            float endCap = length(localPosition - vec2(cos(end), sin(end)) * middle) - capRadius;
+            distance = min(distance, min(startCap, endCap));
+        }
+    }
+
+    float coverage = antialias > 0.5 ? clamp(0.5 - distance, 0.0, 1.0) : step(distance, 0.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    fragColor = vec4(fragVertexColor.rgb, fragVertexColor.a * coverage);
+}
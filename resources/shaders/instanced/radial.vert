@@ -0,0 +1,25 @@
+#version 130
+in vec2 corner;         // Unit quad corner (0..1)
+in vec4 bounds;         // min x, min y, max x, max y in pixels
+in vec4 shape;          // center x, center y, outer radius, inner radius
+in vec4 sector;         // start angle, span, round caps, unused
+in vec4 color;
+
+uniform vec2 resolution;
+uniform float antialias;    // Edge padding in pixels, 0 with anti-aliasing off
+
+out vec2 localPosition; // Pixels from the center
+out vec4 shapeParams;
+out vec4 sectorParams;
+out vec4 fragVertexColor;
+
+void main() {
+    // One pixel of padding around the bounds for the anti-aliased edge
+    vec2 pixel = mix(bounds.xy - antialias, bounds.zw + antialias, corner);
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+
+    localPosition = pixel - shape.xy;
+    shapeParams = shape;
+    sectorParams = sector;
+    fragVertexColor = color;
+}
@@ -0,0 +1,33 @@
+#version 130
+in vec2 localPosition;
+in vec2 halfSize;
+in vec4 cornerRadii;
+in vec4 fill;
+in vec4 border;
+in float borderSize;
+out vec4 fragColor;
+
+uniform float antialias;
+
+// Signed distance to a box with a separate radius per corner
+float roundedBoxDistance(vec2 p, vec2 size, vec4 radii) {
+    float radius = p.x > 0.0 ? (p.y > 0.0 ? radii.z : radii.y)
+                             : (p.y > 0.0 ? radii.w : radii.x);
+    vec2 q = abs(p) - size + radius;
+    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - radius;
+}
+
+void main() {
+    float distance = roundedBoxDistance(localPosition, halfSize, cornerRadii);
+    float coverage = antialias > 0.5 ? clamp(0.5 - distance, 0.0, 1.0) : step(distance, 0.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+
+    float borderAmount = 0.0;
+    if (borderSize > 0.0) {
+        borderAmount = antialias > 0.5 ? clamp(distance + borderSize + 0.5, 0.0, 1.0) : step(-borderSize, distance);
+    }
+    vec4 color = mix(fill, border, borderAmount);
+    fragColor = vec4(color.rgb, color.a * coverage);
+}
@@ -0,0 +1,33 @@
+#version 130
+in vec2 corner;         // Unit quad corner (0..1)
+in vec4 rect;           // x, y, w, h in pixels
+in vec4 radii;          // bottom-left, bottom-right, top-right, top-left
+in vec4 fillColor;
+in vec4 borderColor;
+in float borderWidth;
+
+uniform vec2 resolution;
+uniform float antialias;    // Edge padding in pixels, 0 with anti-aliasing off
+
+out vec2 localPosition; // Pixels from the rect center
+out vec2 halfSize;
+out vec4 cornerRadii;
+out vec4 fill;
+out vec4 border;
+out float borderSize;
+
+void main() {
+    // One pixel of padding around the rect for the anti-aliased edge
+    halfSize = abs(rect.zw) * 0.5;
+    vec2 center = rect.xy + rect.zw * 0.5;
+    localPosition = (corner * 2.0 - 1.0) * (halfSize + antialias);
+
+    vec2 pixel = center + localPosition;
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+
+    float maxRadius = min(halfSize.x, halfSize.y);
+    cornerRadii = clamp(radii, 0.0, maxRadius);
+    fill = fillColor;
+    border = borderColor;
+    borderSize = borderWidth;
+}
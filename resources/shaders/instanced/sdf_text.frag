@@ -0,0 +1,15 @@
+#version 130
+in vec2 texCoord;
+in vec4 tintColor;
+out vec4 fragColor;
+
+uniform sampler2D textureSampler;
+
+void main() {
+    // Distance is stored in alpha with the outline at 0.5; smooth over one
+    // screen pixel whatever the scale
+    float distance = texture(textureSampler, texCoord).a;
+    float width = max(fwidth(distance) * 0.5, 1e-4);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+    fragColor = vec4(tintColor.rgb, tintColor.a * coverage);
+}
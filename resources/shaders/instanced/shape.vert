@@ -0,0 +1,18 @@
+#version 130
+in vec2 position;       // Shape units around the shape origin
+in vec4 vertexColor;
+in vec4 transform;      // x, y (pixels), rotation (radians), scale
+in vec4 instanceColor;
+
+uniform vec2 resolution;
+
+out vec4 fragVertexColor;
+
+void main() {
+    float c = cos(transform.z);
+    float s = sin(transform.z);
+    vec2 pixel = transform.xy + transform.w * vec2(c * position.x - s * position.y,
+                                                   s * position.x + c * position.y);
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+    fragVertexColor = vertexColor * instanceColor;
+}
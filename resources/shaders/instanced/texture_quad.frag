@@ -0,0 +1,10 @@
+#version 130
+in vec2 texCoord;
+in vec4 tintColor;
+out vec4 fragColor;
+
+uniform sampler2D textureSampler;
+
+void main() {
+    fragColor = texture(textureSampler, texCoord) * tintColor;
+}
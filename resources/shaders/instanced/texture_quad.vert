@@ -0,0 +1,17 @@
+#version 130
+in vec2 corner;         // Unit quad corner (0..1)
+in vec4 rect;           // x, y, w, h in pixels
+in vec4 subtexture;     // x, y, w, h in texture coordinates (0-1)
+in vec4 tint;
+
+uniform vec2 resolution;
+
+out vec2 texCoord;
+out vec4 tintColor;
+
+void main() {
+    vec2 pixel = rect.xy + corner * rect.zw;
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+    texCoord = subtexture.xy + corner * subtexture.zw;
+    tintColor = tint;
+}
@@ -0,0 +1,19 @@
+#version 130
+in vec2 local;
+in float radius;
+in vec4 particleColor;
+out vec4 fragColor;
+
+uniform bool pointSprites;
+
+void main() {
+    vec2 p = pointSprites ? (gl_PointCoord * 2.0 - 1.0) * (radius + 1.0) : local;
+    float dist = length(p);
+
+    float alpha = 1.0 - smoothstep(radius - 1.0, radius + 1.0, dist);
+    if (alpha <= 0.0) {
+        discard;
+    }
+
+    fragColor = vec4(particleColor.rgb, particleColor.a * alpha);
+}
@@ -0,0 +1,29 @@
+#version 130
+// One instanced quad per particle
+in vec2 corner;             // Unit quad corner in [-1, 1]
+in vec2 particlePosition;
+in vec2 particleVelocity;
+in vec2 particleAgeLife;
+
+uniform vec2 resolution;
+uniform vec2 sizeRange;     // Radius at birth, radius at death
+uniform vec4 colorStart;
+uniform vec4 colorEnd;
+
+out vec2 local;
+out float radius;
+out vec4 particleColor;
+
+void main() {
+    float t = clamp(particleAgeLife.x / max(particleAgeLife.y, 0.0001), 0.0, 1.0);
+    bool alive = particleAgeLife.x < particleAgeLife.y;
+
+    radius = alive ? mix(sizeRange.x, sizeRange.y, t) : 0.0;
+    particleColor = mix(colorStart, colorEnd, t);
+
+    // One pixel of margin for the anti-aliased edge
+    float extent = alive ? radius + 1.0 : 0.0;
+    local = corner * extent;
+    vec2 pixel = particlePosition + local;
+    gl_Position = vec4(pixel / resolution * 2.0 - 1.0, 0.0, 1.0);
+}
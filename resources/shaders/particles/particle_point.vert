@@ -0,0 +1,26 @@
+#version 130
+// Point sprite fallback for contexts without instanced arrays
+in vec2 particlePosition;
+in vec2 particleVelocity;
+in vec2 particleAgeLife;
+
+uniform vec2 resolution;
+uniform vec2 sizeRange;
+uniform vec4 colorStart;
+uniform vec4 colorEnd;
+
+out vec2 local;
+out float radius;
+out vec4 particleColor;
+
+void main() {
+    float t = clamp(particleAgeLife.x / max(particleAgeLife.y, 0.0001), 0.0, 1.0);
+    bool alive = particleAgeLife.x < particleAgeLife.y;
+
+    radius = alive ? mix(sizeRange.x, sizeRange.y, t) : 0.0;
+    particleColor = mix(colorStart, colorEnd, t);
+
+    local = vec2(0.0);
+    gl_PointSize = alive ? 2.0 * (radius + 1.0) : 0.0;
+    gl_Position = vec4(particlePosition / resolution * 2.0 - 1.0, 0.0, 1.0);
+}
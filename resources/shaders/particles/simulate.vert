@@ -0,0 +1,59 @@
+#version 130
+// Particle simulation step, captured with transform feedback (no rasterization)
+in vec2 position;
+in vec2 velocity;
+in vec2 ageLife;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec2 outAgeLife;
+
+uniform float dt;
+uniform float time;
+uniform int capacity;
+uniform int spawnStart;   // First particle slot to respawn this step (ring cursor)
+uniform int spawnCount;   // Number of slots to respawn
+
+uniform vec2 emitterPosition;
+uniform float emitterRadius;
+uniform float direction;  // Radians
+uniform float spread;     // Radians, full cone angle
+uniform vec2 speedRange;
+uniform vec2 lifeRange;
+uniform vec2 gravity;
+uniform float drag;
+
+float hash(float n) {
+    return fract(sin(n) * 43758.5453123);
+}
+
+void main() {
+    int offset = gl_VertexID - spawnStart;
+    if (offset < 0) offset += capacity;
+
+    if (offset < spawnCount) {
+        float seed = float(gl_VertexID) * 0.6180339 + time * 17.123;
+        float angle = direction + (hash(seed) - 0.5) * spread;
+        float speed = mix(speedRange.x, speedRange.y, hash(seed + 1.0));
+        float emitAngle = hash(seed + 2.0) * 6.2831853;
+        float emitDistance = sqrt(hash(seed + 3.0)) * emitterRadius;
+
+        outPosition = emitterPosition + vec2(cos(emitAngle), sin(emitAngle)) * emitDistance;
+        outVelocity = vec2(cos(angle), sin(angle)) * speed;
+        outAgeLife = vec2(0.0, mix(lifeRange.x, lifeRange.y, hash(seed + 4.0)));
+        return;
+    }
+
+    if (ageLife.x >= ageLife.y) {
+        // Dead particle, keep it as is until its slot is respawned
+        outPosition = position;
+        outVelocity = velocity;
+        outAgeLife = ageLife;
+        return;
+    }
+
+    vec2 v = (velocity + gravity * dt) * max(0.0, 1.0 - drag * dt);
+    outPosition = position + v * dt;
+    outVelocity = v;
+    outAgeLife = vec2(ageLife.x + dt, ageLife.y);
+}
@@ -0,0 +1,19 @@
+#version 130
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
+uniform vec2 resolution;
+
+void main() {
+    // Center and four diagonal bilinear taps, as in the prefilter
+    vec2 texelSize = 1.0 / resolution;
+    vec3 sum = texture(screenTexture, min(TexCoords, texCoordMax)).rgb * 4.0;
+    sum += texture(screenTexture, min(TexCoords + vec2(-texelSize.x, -texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2( texelSize.x, -texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2(-texelSize.x,  texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2( texelSize.x,  texelSize.y), texCoordMax)).rgb;
+    color = vec4(sum / 8.0, 1.0);
+}
@@ -0,0 +1,30 @@
+#version 130
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
+uniform vec2 resolution;
+uniform float threshold;
+uniform float knee;
+
+void main() {
+    // Half-size downsample: the center and four diagonal bilinear taps, each
+    // averaging a 2x2 block, so no pixel of the source is skipped. Level 0
+    // explicitly: the scene's mips, if any, are generated after bloom
+    vec2 texelSize = 1.0 / resolution;
+    vec3 sum = textureLod(screenTexture, min(TexCoords, texCoordMax), 0.0).rgb * 4.0;
+    sum += textureLod(screenTexture, min(TexCoords + vec2(-texelSize.x, -texelSize.y), texCoordMax), 0.0).rgb;
+    sum += textureLod(screenTexture, min(TexCoords + vec2( texelSize.x, -texelSize.y), texCoordMax), 0.0).rgb;
+    sum += textureLod(screenTexture, min(TexCoords + vec2(-texelSize.x,  texelSize.y), texCoordMax), 0.0).rgb;
+    sum += textureLod(screenTexture, min(TexCoords + vec2( texelSize.x,  texelSize.y), texCoordMax), 0.0).rgb;
+    vec3 c = sum / 8.0;
+
+    // Keep what is above the threshold, easing in over the knee
+    float brightness = max(c.r, max(c.g, c.b));
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-4);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 1e-4);
+    color = vec4(c * contribution, 1.0);
+}
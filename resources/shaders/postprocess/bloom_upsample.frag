@@ -0,0 +1,25 @@
+#version 130
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
+uniform vec2 resolution;
+uniform float intensity;
+
+void main() {
+    // 3x3 tent filter over the smaller level; the result is blended
+    // additively onto the next larger one
+    vec2 texelSize = 1.0 / resolution;
+    vec3 sum = texture(screenTexture, min(TexCoords, texCoordMax)).rgb * 4.0;
+    sum += texture(screenTexture, min(TexCoords + vec2(-texelSize.x, 0.0), texCoordMax)).rgb * 2.0;
+    sum += texture(screenTexture, min(TexCoords + vec2( texelSize.x, 0.0), texCoordMax)).rgb * 2.0;
+    sum += texture(screenTexture, min(TexCoords + vec2(0.0, -texelSize.y), texCoordMax)).rgb * 2.0;
+    sum += texture(screenTexture, min(TexCoords + vec2(0.0,  texelSize.y), texCoordMax)).rgb * 2.0;
+    sum += texture(screenTexture, min(TexCoords + vec2(-texelSize.x, -texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2( texelSize.x, -texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2(-texelSize.x,  texelSize.y), texCoordMax)).rgb;
+    sum += texture(screenTexture, min(TexCoords + vec2( texelSize.x,  texelSize.y), texCoordMax)).rgb;
+    color = vec4(sum / 16.0 * intensity, 1.0);
+}
@@ -4,6 +4,7 @@ in vec2 TexCoords;
 out vec4 color;
 
 uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
 uniform vec2 resolution;
 
 void main() {
@@ -14,7 +15,7 @@ void main() {
     for(int x = -1; x <= 1; ++x) {
         for(int y = -1; y <= 1; ++y) {
             vec2 offset = vec2(float(x), float(y)) * texelSize;
-            result += texture2D(screenTexture, TexCoords + offset).rgb;
+            result += texture2D(screenTexture, min(TexCoords + offset, texCoordMax)).rgb;
         }
     }
     
@@ -0,0 +1,19 @@
+#version 130
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
+uniform sampler3D lut;
+uniform float lutSize;
+
+void main() {
+    // Level 0 explicitly: the scene's mips, if any, are generated after grading
+    vec3 c = clamp(textureLod(screenTexture, min(TexCoords, texCoordMax), 0.0).rgb, 0.0, 1.0);
+
+    // Map [0, 1] onto the centers of the first and last texels, so the
+    // trilinear fetch interpolates between the baked entries
+    vec3 coord = c * ((lutSize - 1.0) / lutSize) + 0.5 / lutSize;
+    color = vec4(texture(lut, coord).rgb, 1.0);
+}
@@ -0,0 +1,144 @@
+#version 130
+
+// FXAA: finds the direction of a luma edge through the pixel, walks along
+// it to both ends, and resamples across the edge by the pixel's position on
+// it, plus a blend for sub-pixel features.
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 resolution;
+uniform vec2 texCoordMax;   // The edge walk stops short of the unrendered texels
+
+const float EDGE_THRESHOLD_MIN = 0.0312;
+const float EDGE_THRESHOLD_MAX = 0.125;
+const float SUBPIXEL_QUALITY = 0.75;
+const int ITERATIONS = 12;
+const float STEPS[12] = float[12](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+float luma(vec3 rgb) {
+    // Square root approximates the perceptual curve of the stored colors
+    return sqrt(dot(rgb, vec3(0.299, 0.587, 0.114)));
+}
+
+vec3 sampleAt(vec2 uv) {
+    return texture(screenTexture, min(uv, texCoordMax)).rgb;
+}
+
+float lumaAt(vec2 uv) {
+    return luma(sampleAt(uv));
+}
+
+void main() {
+    vec2 texel = 1.0 / resolution;
+    vec3 center = sampleAt(TexCoords);
+
+    float lumaCenter = luma(center);
+    float lumaDown = lumaAt(TexCoords + vec2(0.0, -1.0) * texel);
+    float lumaUp = lumaAt(TexCoords + vec2(0.0, 1.0) * texel);
+    float lumaLeft = lumaAt(TexCoords + vec2(-1.0, 0.0) * texel);
+    float lumaRight = lumaAt(TexCoords + vec2(1.0, 0.0) * texel);
+
+    float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+    float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+    float lumaRange = lumaMax - lumaMin;
+
+    // Flat areas are left alone
+    if (lumaRange < max(EDGE_THRESHOLD_MIN, lumaMax * EDGE_THRESHOLD_MAX)) {
+        color = vec4(center, 1.0);
+        return;
+    }
+
+    float lumaDownLeft = lumaAt(TexCoords + vec2(-1.0, -1.0) * texel);
+    float lumaUpRight = lumaAt(TexCoords + vec2(1.0, 1.0) * texel);
+    float lumaUpLeft = lumaAt(TexCoords + vec2(-1.0, 1.0) * texel);
+    float lumaDownRight = lumaAt(TexCoords + vec2(1.0, -1.0) * texel);
+
+    float lumaDownUp = lumaDown + lumaUp;
+    float lumaLeftRight = lumaLeft + lumaRight;
+    float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+    float lumaDownCorners = lumaDownLeft + lumaDownRight;
+    float lumaRightCorners = lumaDownRight + lumaUpRight;
+    float lumaUpCorners = lumaUpRight + lumaUpLeft;
+
+    // Edge orientation from the second derivatives across each axis
+    float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0
+                         + abs(-2.0 * lumaRight + lumaRightCorners);
+    float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0
+                       + abs(-2.0 * lumaDown + lumaDownCorners);
+    bool horizontal = edgeHorizontal >= edgeVertical;
+
+    // Which side of the pixel the edge is on
+    float luma1 = horizontal ? lumaDown : lumaLeft;
+    float luma2 = horizontal ? lumaUp : lumaRight;
+    float gradient1 = luma1 - lumaCenter;
+    float gradient2 = luma2 - lumaCenter;
+    bool steepest1 = abs(gradient1) >= abs(gradient2);
+    float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+    float stepLength = horizontal ? texel.y : texel.x;
+    float lumaLocalAverage;
+    if (steepest1) {
+        stepLength = -stepLength;
+        lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+    } else {
+        lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+    }
+
+    // Walk along the edge, half a pixel towards it, until the luma changes
+    vec2 edgeUV = TexCoords;
+    if (horizontal) {
+        edgeUV.y += stepLength * 0.5;
+    } else {
+        edgeUV.x += stepLength * 0.5;
+    }
+    vec2 offset = horizontal ? vec2(texel.x, 0.0) : vec2(0.0, texel.y);
+    vec2 uv1 = edgeUV - offset;
+    vec2 uv2 = edgeUV + offset;
+
+    float lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+    float lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+    bool reached1 = abs(lumaEnd1) >= gradientScaled;
+    bool reached2 = abs(lumaEnd2) >= gradientScaled;
+    if (!reached1) uv1 -= offset;
+    if (!reached2) uv2 += offset;
+
+    for (int i = 2; i < ITERATIONS && !(reached1 && reached2); ++i) {
+        if (!reached1) {
+            lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+            reached1 = abs(lumaEnd1) >= gradientScaled;
+            if (!reached1) uv1 -= offset * STEPS[i];
+        }
+        if (!reached2) {
+            lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+            reached2 = abs(lumaEnd2) >= gradientScaled;
+            if (!reached2) uv2 += offset * STEPS[i];
+        }
+    }
+
+    // Offset across the edge from the distance to the nearer end
+    float distance1 = horizontal ? TexCoords.x - uv1.x : TexCoords.y - uv1.y;
+    float distance2 = horizontal ? uv2.x - TexCoords.x : uv2.y - TexCoords.y;
+    bool nearer1 = distance1 < distance2;
+    float pixelOffset = 0.5 - min(distance1, distance2) / (distance1 + distance2);
+
+    // Only move if the end in that direction changes luma the other way
+    bool centerSmaller = lumaCenter < lumaLocalAverage;
+    bool correctVariation = ((nearer1 ? lumaEnd1 : lumaEnd2) < 0.0) != centerSmaller;
+    float finalOffset = correctVariation ? pixelOffset : 0.0;
+
+    // Sub-pixel features: blend towards the 3x3 average
+    float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+    float subPixel = clamp(abs(lumaAverage - lumaCenter) / lumaRange, 0.0, 1.0);
+    subPixel = (-2.0 * subPixel + 3.0) * subPixel * subPixel;
+    finalOffset = max(finalOffset, subPixel * subPixel * SUBPIXEL_QUALITY);
+
+    vec2 finalUV = TexCoords;
+    if (horizontal) {
+        finalUV.y += finalOffset * stepLength;
+    } else {
+        finalUV.x += finalOffset * stepLength;
+    }
+    color = vec4(sampleAt(finalUV), 1.0);
+}
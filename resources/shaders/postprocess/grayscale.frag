@@ -4,9 +4,10 @@ in vec2 TexCoords;
 out vec4 color;
 
 uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
 
 void main() {
-    vec3 texColor = texture2D(screenTexture, TexCoords).rgb;
+    vec3 texColor = texture2D(screenTexture, min(TexCoords, texCoordMax)).rgb;
     float gray = dot(texColor, vec3(0.299, 0.587, 0.114));
     color = vec4(vec3(gray), 1.0);
 }
\ No newline at end of file
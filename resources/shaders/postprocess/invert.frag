@@ -4,9 +4,10 @@ in vec2 TexCoords;
 out vec4 color;
 
 uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
 
 void main() {
-    vec3 texColor = texture2D(screenTexture, TexCoords).rgb;
+    vec3 texColor = texture2D(screenTexture, min(TexCoords, texCoordMax)).rgb;
     // Invert the colors
     color = vec4(1.0 - texColor, 1.0);
 }
\ No newline at end of file
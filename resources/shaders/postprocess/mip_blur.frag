@@ -0,0 +1,21 @@
+#version 130
+
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;
+uniform vec2 resolution;
+uniform float blurLevel;        // Mip level to read; each level doubles the radius
+
+// Needs PostProcessor::setSceneMips(true). The coarse level is read with
+// trilinear filtering, and a 4-tap tent at that level's texel size hides
+// the blocky footprint of the box-filtered mips.
+void main() {
+    vec2 texelSize = exp2(blurLevel) / resolution;
+    vec3 result = textureLod(screenTexture, min(TexCoords + vec2(-0.5, -0.5) * texelSize, texCoordMax), blurLevel).rgb;
+    result += textureLod(screenTexture, min(TexCoords + vec2( 0.5, -0.5) * texelSize, texCoordMax), blurLevel).rgb;
+    result += textureLod(screenTexture, min(TexCoords + vec2(-0.5,  0.5) * texelSize, texCoordMax), blurLevel).rgb;
+    result += textureLod(screenTexture, min(TexCoords + vec2( 0.5,  0.5) * texelSize, texCoordMax), blurLevel).rgb;
+    color = vec4(result / 4.0, 1.0);
+}
@@ -4,8 +4,10 @@ in vec2 TexCoords;
 out vec4 color;
 
 uniform sampler2D screenTexture;
+uniform vec2 texCoordMax;   // Center of the last rendered texel; with a render scale
+                            // below 1 the texels beyond it hold no scene
 
 void main() {
     // Simple passthrough - no effect
-    color = texture2D(screenTexture, TexCoords);
+    color = texture2D(screenTexture, min(TexCoords, texCoordMax));
 }
\ No newline at end of file
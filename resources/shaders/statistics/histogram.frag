@@ -0,0 +1,6 @@
+#version 130
+out vec4 count;
+
+void main() {
+    count = vec4(1.0, 0.0, 0.0, 0.0);
+}
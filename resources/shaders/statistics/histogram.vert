@@ -0,0 +1,15 @@
+#version 130
+uniform sampler2D source;
+uniform ivec2 sourceSize;
+uniform ivec2 gridSize;         // Pixels sampled along each axis
+
+// One point per sampled pixel, drawn additively into its bin of a 256x1 target
+void main() {
+    ivec2 cell = ivec2(gl_VertexID % gridSize.x, gl_VertexID / gridSize.x);
+    ivec2 texel = cell * sourceSize / gridSize;
+    float luminance = max(dot(texelFetch(source, texel, 0).rgb, vec3(0.2126, 0.7152, 0.0722)), 0.0);
+    float bin = min(floor(luminance * 256.0), 255.0);
+
+    gl_Position = vec4((bin + 0.5) / 128.0 - 1.0, 0.0, 0.0, 1.0);
+    gl_PointSize = 1.0;
+}
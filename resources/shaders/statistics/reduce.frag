@@ -0,0 +1,25 @@
+#version 130
+out vec4 result;
+
+uniform sampler2D source;
+uniform ivec2 sourceSize;
+uniform bool luminancePass;     // Source is the frame rather than a reduced level
+
+// Each output texel reduces a 2x2 block of the source into
+// (luminance sum, min, max, pixel count)
+void main() {
+    ivec2 base = ivec2(gl_FragCoord.xy) * 2;
+    vec4 total = vec4(0.0, 1.0e30, -1.0e30, 0.0);
+    for (int i = 0; i < 4; ++i) {
+        ivec2 texel = base + ivec2(i & 1, i >> 1);
+        if (texel.x >= sourceSize.x || texel.y >= sourceSize.y) continue;
+
+        vec4 value = texelFetch(source, texel, 0);
+        if (luminancePass) {
+            float luminance = max(dot(value.rgb, vec3(0.2126, 0.7152, 0.0722)), 0.0);
+            value = vec4(luminance, luminance, luminance, 1.0);
+        }
+        total = vec4(total.r + value.r, min(total.g, value.g), max(total.b, value.b), total.a + value.a);
+    }
+    result = total;
+}
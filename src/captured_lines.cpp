@@ -0,0 +1,183 @@
+#include "captured_lines.hpp"
+#include "rendering_system.hpp"
+#include "shader/batch.hpp"
+
+#include <iostream>
+#include <glad/gl.h>
+
+namespace cridgeon
+{
+    // segment (4), corner (2), width (1), color (4)
+    static const int INPUT_FLOATS = 11;
+    // gl_Position (4), color (4), edge (2)
+    static const int CAPTURED_FLOATS = 10;
+
+    // Two triangles per segment: (along, side) for each vertex
+    static const float SEGMENT_CORNERS[6][2] = {
+        {0.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f},
+        {0.0f, -1.0f}, {1.0f,  1.0f}, {0.0f, 1.0f}
+    };
+
+    CapturedLines::CapturedLines()
+        : segmentCount(0), inputsDirty(false), captureValid(false), reused(false),
+          viewOffsetX(0.0f), viewOffsetY(0.0f), viewScale(1.0f),
+          capturedWidth(0), capturedHeight(0),
+          inputVAO(0), inputVBO(0), capturedVAO(0), capturedVBO(0), capturedCapacity(0) {}
+
+    CapturedLines::~CapturedLines() {
+        destroy();
+    }
+
+    void CapturedLines::addSegment(float x1, float y1, float x2, float y2, float width,
+                                   float r, float g, float b, float a) {
+        for (const auto& corner : SEGMENT_CORNERS) {
+            const float vertex[INPUT_FLOATS] = {x1, y1, x2, y2, corner[0], corner[1], width, r, g, b, a};
+            inputVertices.insert(inputVertices.end(), vertex, vertex + INPUT_FLOATS);
+        }
+        ++segmentCount;
+        inputsDirty = true;
+        captureValid = false;
+    }
+
+    void CapturedLines::addPolyline(const std::vector<float>& vertices, float width,
+                                    float r, float g, float b, float a) {
+        for (size_t i = 2; i + 1 < vertices.size(); i += 2) {
+            addSegment(vertices[i - 2], vertices[i - 1], vertices[i], vertices[i + 1], width, r, g, b, a);
+        }
+    }
+
+    void CapturedLines::clear() {
+        inputVertices.clear();
+        segmentCount = 0;
+        inputsDirty = true;
+        captureValid = false;
+    }
+
+    void CapturedLines::setView(float offsetX, float offsetY, float scale) {
+        if (offsetX == viewOffsetX && offsetY == viewOffsetY && scale == viewScale) return;
+        viewOffsetX = offsetX;
+        viewOffsetY = offsetY;
+        viewScale = scale;
+        captureValid = false;
+    }
+
+    bool CapturedLines::initialize() {
+        if (!expandShader.isValid()) {
+            expandShader.loadFeedbackFromFile("resources/shaders/feedback/thick_line_expand.vert",
+                                              {"gl_Position", "capturedColor", "capturedEdge"},
+                                              {"segment", "corner", "width", "vertexColor"});
+            if (!expandShader.isValid()) {
+                std::cerr << "Failed to load line expansion shader" << std::endl;
+                return false;
+            }
+        }
+        if (!drawShader.isValid()) {
+            drawShader.loadFromFile("resources/shaders/feedback/captured.vert", "resources/shaders/feedback/captured_line.frag",
+                                    {"capturedPosition", "capturedColor", "capturedEdge"});
+            if (!drawShader.isValid()) {
+                std::cerr << "Failed to load captured geometry shader" << std::endl;
+                return false;
+            }
+        }
+
+        if (inputVAO == 0) {
+            const GLsizei stride = INPUT_FLOATS * sizeof(float);
+            glGenVertexArrays(1, &inputVAO);
+            glGenBuffers(1, &inputVBO);
+            glBindVertexArray(inputVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, inputVBO);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+            glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)(7 * sizeof(float)));
+            for (unsigned int a = 0; a < 4; ++a) glEnableVertexAttribArray(a);
+
+            const GLsizei capturedStride = CAPTURED_FLOATS * sizeof(float);
+            glGenVertexArrays(1, &capturedVAO);
+            glGenBuffers(1, &capturedVBO);
+            glBindVertexArray(capturedVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, capturedVBO);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, capturedStride, (void*)0);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, capturedStride, (void*)(4 * sizeof(float)));
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, capturedStride, (void*)(8 * sizeof(float)));
+            for (unsigned int a = 0; a < 3; ++a) glEnableVertexAttribArray(a);
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        return true;
+    }
+
+    void CapturedLines::capture(int width, int height) {
+        size_t vertexCount = inputVertices.size() / INPUT_FLOATS;
+
+        if (inputsDirty) {
+            glBindBuffer(GL_ARRAY_BUFFER, inputVBO);
+            glBufferData(GL_ARRAY_BUFFER, inputVertices.size() * sizeof(float), inputVertices.data(), GL_STATIC_DRAW);
+            inputsDirty = false;
+        }
+
+        if (vertexCount > capturedCapacity) {
+            glBindBuffer(GL_ARRAY_BUFFER, capturedVBO);
+            glBufferData(GL_ARRAY_BUFFER, vertexCount * CAPTURED_FLOATS * sizeof(float), nullptr, GL_STATIC_COPY);
+            capturedCapacity = vertexCount;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        expandShader.use();
+        glUniform2f(expandShader.getUniformLocation("resolution"), static_cast<float>(width), static_cast<float>(height));
+        glUniform2f(expandShader.getUniformLocation("viewOffset"), viewOffsetX, viewOffsetY);
+        glUniform1f(expandShader.getUniformLocation("viewScale"), viewScale);
+
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBindVertexArray(inputVAO);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, capturedVBO);
+        glBeginTransformFeedback(GL_TRIANGLES);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexCount));
+        glEndTransformFeedback();
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        capturedWidth = width;
+        capturedHeight = height;
+        captureValid = true;
+    }
+
+    void CapturedLines::render() {
+        reused = false;
+        if (segmentCount == 0) return;
+        if (!initialize()) return;
+        Render::flushBatches();
+
+        auto& rs = RenderingSystem::getInstance();
+        int width = rs.getWindowWidth();
+        int height = rs.getWindowHeight();
+
+        if (!captureValid || width != capturedWidth || height != capturedHeight) {
+            capture(width, height);
+        } else {
+            reused = true;
+        }
+
+        drawShader.use();
+        glBindVertexArray(capturedVAO);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(segmentCount * 6));
+        glBindVertexArray(0);
+    }
+
+    void CapturedLines::destroy() {
+        if (inputVAO != 0) {
+            glDeleteVertexArrays(1, &inputVAO);
+            glDeleteBuffers(1, &inputVBO);
+            glDeleteVertexArrays(1, &capturedVAO);
+            glDeleteBuffers(1, &capturedVBO);
+            inputVAO = inputVBO = capturedVAO = capturedVBO = 0;
+        }
+        expandShader.destroy();
+        drawShader.destroy();
+        capturedCapacity = 0;
+        captureValid = false;
+        inputsDirty = !inputVertices.empty();
+    }
+} // namespace cridgeon
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "shader/shader.hpp"
+#include <vector>
+
+namespace cridgeon
+{
+    // Layer of thick, anti-aliased line segments whose vertex expansion is
+    // captured once with transform feedback and replayed on later frames.
+    // The capture is redone only when segments are added or removed, the view
+    // transform changes, or the window is resized, so a static line layer
+    // under a fixed camera costs one plain draw of pre-transformed vertices.
+    class CapturedLines {
+    public:
+        CapturedLines();
+        ~CapturedLines();
+
+        // Disable copy constructor and assignment operator
+        CapturedLines(const CapturedLines&) = delete;
+        CapturedLines& operator=(const CapturedLines&) = delete;
+
+        // Add a segment in pixel coordinates (before the view transform).
+        // Width is in screen pixels and is not affected by the view scale.
+        void addSegment(float x1, float y1, float x2, float y2, float width,
+                        float r, float g, float b, float a);
+
+        // Add a connected polyline; `vertices` holds x, y pairs
+        void addPolyline(const std::vector<float>& vertices, float width,
+                         float r, float g, float b, float a);
+
+        // Remove all segments
+        void clear();
+
+        // View transform applied to segment coordinates: screen = p * scale + offset.
+        // Changing it invalidates the capture.
+        void setView(float offsetX, float offsetY, float scale);
+
+        // Force the next render() to recapture
+        void invalidate() { captureValid = false; }
+
+        // Recapture if needed, then draw the captured vertices
+        void render();
+
+        // Check whether the last render() reused an existing capture
+        bool wasReused() const { return reused; }
+
+        size_t getSegmentCount() const { return segmentCount; }
+
+        void destroy();
+
+    private:
+        Shader expandShader;
+        Shader drawShader;
+
+        std::vector<float> inputVertices;
+        size_t segmentCount;
+        bool inputsDirty;       // inputVertices changed since the last upload
+        bool captureValid;      // captured buffer matches inputs, view and resolution
+        bool reused;
+
+        float viewOffsetX, viewOffsetY, viewScale;
+        int capturedWidth, capturedHeight;
+
+        unsigned int inputVAO, inputVBO;
+        unsigned int capturedVAO, capturedVBO;
+        size_t capturedCapacity;    // Vertices the captured buffer can hold
+
+        bool initialize();
+        void capture(int width, int height);
+    };
+} // namespace cridgeon
@@ -0,0 +1,155 @@
+#include "color_grading.hpp"
+#include "software/rasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glad/gl.h>
+
+namespace cridgeon
+{
+    bool ColorGrading::Operation::operator==(const Operation& other) const {
+        return type == other.type && params[0] == other.params[0] && params[1] == other.params[1] &&
+               params[2] == other.params[2] && functionId == other.functionId;
+    }
+
+    ColorGrading::ColorGrading() : baked(false), nextFunctionId(1), texture(0) {}
+
+    ColorGrading::~ColorGrading() {
+        destroy();
+    }
+
+    void ColorGrading::add(Type type, float a, float b, float c) {
+        Operation operation;
+        operation.type = type;
+        operation.params[0] = a;
+        operation.params[1] = b;
+        operation.params[2] = c;
+        operation.functionId = 0;
+        operations.push_back(std::move(operation));
+    }
+
+    void ColorGrading::addExposure(float stops) {
+        add(Type::EXPOSURE, std::exp2(stops));
+    }
+
+    void ColorGrading::addContrast(float amount, float pivot) {
+        add(Type::CONTRAST, amount, pivot);
+    }
+
+    void ColorGrading::addSaturation(float amount) {
+        add(Type::SATURATION, amount);
+    }
+
+    void ColorGrading::addTint(float r, float g, float b) {
+        add(Type::TINT, r, g, b);
+    }
+
+    void ColorGrading::addGamma(float gamma) {
+        add(Type::GAMMA, 1.0f / std::max(gamma, 1e-3f));
+    }
+
+    void ColorGrading::addInvert() {
+        add(Type::INVERT);
+    }
+
+    void ColorGrading::addFunction(const Function& function) {
+        add(Type::FUNCTION);
+        operations.back().functionId = nextFunctionId++;
+        operations.back().function = function;
+    }
+
+    void ColorGrading::clear() {
+        operations.clear();
+    }
+
+    void ColorGrading::apply(float& r, float& g, float& b) const {
+        for (const Operation& operation : operations) {
+            const float* p = operation.params;
+            switch (operation.type) {
+                case Type::EXPOSURE:
+                    r *= p[0]; g *= p[0]; b *= p[0];
+                    break;
+                case Type::CONTRAST:
+                    r = (r - p[1]) * p[0] + p[1];
+                    g = (g - p[1]) * p[0] + p[1];
+                    b = (b - p[1]) * p[0] + p[1];
+                    break;
+                case Type::SATURATION: {
+                    float luminance = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+                    r = luminance + (r - luminance) * p[0];
+                    g = luminance + (g - luminance) * p[0];
+                    b = luminance + (b - luminance) * p[0];
+                    break;
+                }
+                case Type::TINT:
+                    r *= p[0]; g *= p[1]; b *= p[2];
+                    break;
+                case Type::GAMMA:
+                    r = std::pow(std::max(r, 0.0f), p[0]);
+                    g = std::pow(std::max(g, 0.0f), p[0]);
+                    b = std::pow(std::max(b, 0.0f), p[0]);
+                    break;
+                case Type::INVERT:
+                    r = 1.0f - r; g = 1.0f - g; b = 1.0f - b;
+                    break;
+                case Type::FUNCTION:
+                    operation.function(r, g, b);
+                    break;
+            }
+        }
+    }
+
+    void ColorGrading::bake() {
+        // Entry i holds the result for i / (LUT_SIZE - 1); the shader maps
+        // [0, 1] onto the texel centers so filtering interpolates between them
+        std::vector<float> table(static_cast<size_t>(LUT_SIZE) * LUT_SIZE * LUT_SIZE * 3);
+        float step = 1.0f / (LUT_SIZE - 1);
+        float* out = table.data();
+        for (int z = 0; z < LUT_SIZE; ++z) {
+            for (int y = 0; y < LUT_SIZE; ++y) {
+                for (int x = 0; x < LUT_SIZE; ++x) {
+                    float r = x * step, g = y * step, b = z * step;
+                    apply(r, g, b);
+                    *out++ = std::min(std::max(r, 0.0f), 1.0f);
+                    *out++ = std::min(std::max(g, 0.0f), 1.0f);
+                    *out++ = std::min(std::max(b, 0.0f), 1.0f);
+                }
+            }
+        }
+
+        if (texture == 0) {
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_3D, texture);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+            glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB16F, LUT_SIZE, LUT_SIZE, LUT_SIZE, 0, GL_RGB, GL_FLOAT, table.data());
+        } else {
+            glBindTexture(GL_TEXTURE_3D, texture);
+            glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, LUT_SIZE, LUT_SIZE, LUT_SIZE, GL_RGB, GL_FLOAT, table.data());
+        }
+        glBindTexture(GL_TEXTURE_3D, 0);
+
+        bakedOperations = operations;
+        baked = true;
+    }
+
+    unsigned int ColorGrading::getTexture() {
+        if (!baked || operations != bakedOperations) {
+            bake();
+        }
+        return texture;
+    }
+
+    void ColorGrading::destroy() {
+        if (texture != 0) {
+            SoftwareRasterizer::getInstance().forgetTexture(texture);
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+        bakedOperations.clear();
+        baked = false;
+    }
+} // namespace cridgeon
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cridgeon
+{
+    // A stack of point-wise color operations baked into a 3D lookup table.
+    // Operations run in the order they were added on colors in [0, 1]; the
+    // table samples the result on a LUT_SIZE^3 grid and is rebuilt on the
+    // CPU only when the stack differs from the one last baked, so clearing
+    // and re-adding the same operations every frame costs nothing. Used by
+    // PostProcessor::setColorGradingEnabled().
+    class ColorGrading {
+    public:
+        // Custom operation; modifies the color in place
+        using Function = std::function<void(float& r, float& g, float& b)>;
+
+        static const int LUT_SIZE = 32;
+
+        ColorGrading();
+        ~ColorGrading();
+
+        // Disable copy constructor and assignment operator
+        ColorGrading(const ColorGrading&) = delete;
+        ColorGrading& operator=(const ColorGrading&) = delete;
+
+        // Multiply by 2^stops
+        void addExposure(float stops);
+
+        // Scale the distance from `pivot`
+        void addContrast(float amount, float pivot = 0.5f);
+
+        // Scale the distance from the Rec. 709 luminance; 0 gives grayscale
+        void addSaturation(float amount);
+
+        // Multiply each channel
+        void addTint(float r, float g, float b);
+
+        // Raise to 1 / gamma
+        void addGamma(float gamma);
+
+        void addInvert();
+
+        // Any other point-wise operation. It cannot be compared, so adding one
+        // always counts as a change and rebuilds the table.
+        void addFunction(const Function& function);
+
+        // Remove every operation
+        void clear();
+
+        bool isEmpty() const { return operations.empty(); }
+
+        // The RGB16F 3D texture for the current stack, rebuilt if needed
+        unsigned int getTexture();
+
+        void destroy();
+
+    private:
+        enum class Type {
+            EXPOSURE,
+            CONTRAST,
+            SATURATION,
+            TINT,
+            GAMMA,
+            INVERT,
+            FUNCTION
+        };
+
+        struct Operation {
+            Type type;
+            float params[3];
+            uint64_t functionId;        // FUNCTION: unique per addFunction() call
+            Function function;
+
+            bool operator==(const Operation& other) const;
+        };
+
+        std::vector<Operation> operations;
+        std::vector<Operation> bakedOperations;
+        bool baked;
+        uint64_t nextFunctionId;
+        unsigned int texture;
+
+        void add(Type type, float a = 0.0f, float b = 0.0f, float c = 0.0f);
+        void apply(float& r, float& g, float& b) const;
+        void bake();
+    };
+} // namespace cridgeon
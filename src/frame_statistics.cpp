@@ -0,0 +1,342 @@
+#include "frame_statistics.hpp"
+#include "gl_capabilities.hpp"
+#include "shader/batch.hpp"
+#include "shader/utility.hpp"
+#include "software/rasterizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cridgeon
+{
+    const int FrameStatistics::MAX_HISTOGRAM_GRID;
+
+    // Readback layout: four header words, then the bins. The compute path
+    // writes uints (sum low, sum high, min bits, max bits), the fragment
+    // path floats (sum, min, max, pixel count)
+    static const int HEADER_WORDS = 4;
+    static const int READBACK_WORDS = HEADER_WORDS + FrameStats::HISTOGRAM_BINS;
+
+    // Fixed-point scale of the compute path's luminance sum (SUM_SCALE in reduce.comp)
+    static const double COMPUTE_SUM_SCALE = 4096.0;
+
+    FrameStatistics::FrameStatistics()
+        : initialized(false), useCompute(false), nextSlot(0), requestCount(0), pollCount(0),
+          histogramTexture(0), framebuffer(0), pointVAO(0), levelWidth(0), levelHeight(0) {}
+
+    FrameStatistics::~FrameStatistics() {
+        destroy();
+    }
+
+    bool FrameStatistics::initialize() {
+        useCompute = glCapabilities().computeShader &&
+                     computeShader.loadComputeFromFile("resources/shaders/statistics/reduce.comp");
+
+        if (!useCompute) {
+            if (!reduceShader.loadFromFile("resources/shaders/default.vert", "resources/shaders/statistics/reduce.frag",
+                                           {"position"}) ||
+                !histogramShader.loadFromFile("resources/shaders/statistics/histogram.vert",
+                                              "resources/shaders/statistics/histogram.frag")) {
+                std::cerr << "Failed to load frame statistics shaders" << std::endl;
+                reduceShader.destroy();
+                return false;
+            }
+
+            glGenTextures(1, &histogramTexture);
+            glBindTexture(GL_TEXTURE_2D, histogramTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, FrameStats::HISTOGRAM_BINS, 1, 0, GL_RED, GL_FLOAT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            glGenFramebuffers(1, &framebuffer);
+            // The histogram points are generated from gl_VertexID alone
+            glGenVertexArrays(1, &pointVAO);
+        }
+
+        for (Slot& slot : slots) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, READBACK_WORDS * sizeof(uint32_t), nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        initialized = true;
+        return true;
+    }
+
+    uint64_t FrameStatistics::request(unsigned int texture, int width, int height) {
+        if (texture == 0 || width <= 0 || height <= 0) return 0;
+        if (!initialized && !initialize()) return 0;
+
+        // The slot about to be reused holds the oldest request; if the GPU is
+        // still on it, drop this one rather than wait
+        Slot& slot = slots[nextSlot];
+        if (slot.pending && !collect(slot, false)) return 0;
+
+        Render::flushBatches();
+        slot.request = ++requestCount;
+        slot.pixels = static_cast<uint64_t>(width) * height;
+        if (useCompute) {
+            reduceCompute(slot, texture, width, height);
+        } else {
+            reduceFragment(slot, texture, width, height);
+        }
+        if (glCapabilities().fenceSync) {
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        slot.polledAt = pollCount;
+        slot.pending = true;
+
+        nextSlot = (nextSlot + 1) % SLOTS;
+        return slot.request;
+    }
+
+    void FrameStatistics::reduceCompute(Slot& slot, unsigned int texture, int width, int height) {
+        uint32_t reset[READBACK_WORDS] = {};
+        reset[2] = 0x7F800000u;     // +infinity, so the first pixel sets the minimum
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, slot.buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(reset), reset);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, slot.buffer);
+
+        computeShader.use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glUniform1i(computeShader.getUniformLocation("source"), 0);
+        glUniform2i(computeShader.getUniformLocation("sourceSize"), width, height);
+
+        const GLExtFunctions& ext = glExt();
+        ext.DispatchCompute(static_cast<GLuint>((width + 15) / 16), static_cast<GLuint>((height + 15) / 16), 1);
+        ext.MemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void FrameStatistics::resizeLevels(int width, int height) {
+        if (!levels.empty() && width == levelWidth && height == levelHeight) return;
+        levelWidth = width;
+        levelHeight = height;
+
+        for (const Level& level : levels) {
+            SoftwareRasterizer::getInstance().forgetTexture(level.texture);
+            glDeleteTextures(1, &level.texture);
+        }
+        levels.clear();
+
+        // Halve (rounding up) until a single texel is left
+        do {
+            Level level;
+            level.width = (width + 1) / 2;
+            level.height = (height + 1) / 2;
+            glGenTextures(1, &level.texture);
+            glBindTexture(GL_TEXTURE_2D, level.texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, level.width, level.height, 0, GL_RGBA, GL_FLOAT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            levels.push_back(level);
+            width = level.width;
+            height = level.height;
+        } while (width > 1 || height > 1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void FrameStatistics::reduceFragment(Slot& slot, unsigned int texture, int width, int height) {
+        resizeLevels(width, height);
+
+        GLint previousFramebuffer = 0;
+        GLint previousViewport[4];
+        GLfloat clearColor[4];
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+        GLint blendSrcRGB = GL_ONE, blendDstRGB = GL_ZERO, blendSrcAlpha = GL_ONE, blendDstAlpha = GL_ZERO;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRGB);
+        glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRGB);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+        glDisable(GL_BLEND);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_SCISSOR_TEST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glActiveTexture(GL_TEXTURE0);
+
+        // Luminance, min, max and count, reduced 2x2 at a time down to one texel
+        reduceShader.use();
+        glUniform1i(reduceShader.getUniformLocation("source"), 0);
+        unsigned int source = texture;
+        int sourceWidth = width, sourceHeight = height;
+        for (size_t i = 0; i < levels.size(); ++i) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, levels[i].texture, 0);
+            glViewport(0, 0, levels[i].width, levels[i].height);
+            glBindTexture(GL_TEXTURE_2D, source);
+            glUniform2i(reduceShader.getUniformLocation("sourceSize"), sourceWidth, sourceHeight);
+            glUniform1i(reduceShader.getUniformLocation("luminancePass"), i == 0 ? 1 : 0);
+            ShaderUtility::drawFullScreenQuad();
+
+            source = levels[i].texture;
+            sourceWidth = levels[i].width;
+            sourceHeight = levels[i].height;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glReadPixels(0, 0, 1, 1, GL_RGBA, GL_FLOAT, nullptr);
+
+        // Histogram: one point per sampled pixel, counted with additive blending
+        int gridWidth = std::min(width, MAX_HISTOGRAM_GRID);
+        int gridHeight = std::min(height, MAX_HISTOGRAM_GRID);
+        slot.histogramSamples = static_cast<uint64_t>(gridWidth) * gridHeight;
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, histogramTexture, 0);
+        glViewport(0, 0, FrameStats::HISTOGRAM_BINS, 1);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+        histogramShader.use();
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glUniform1i(histogramShader.getUniformLocation("source"), 0);
+        glUniform2i(histogramShader.getUniformLocation("sourceSize"), width, height);
+        glUniform2i(histogramShader.getUniformLocation("gridSize"), gridWidth, gridHeight);
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        glBindVertexArray(pointVAO);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(slot.histogramSamples));
+        glBindVertexArray(0);
+        glBlendFuncSeparate(blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha);
+
+        glReadPixels(0, 0, FrameStats::HISTOGRAM_BINS, 1, GL_RED, GL_FLOAT,
+                     reinterpret_cast<void*>(HEADER_WORDS * sizeof(float)));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+        if (!blend) glDisable(GL_BLEND);
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+        if (scissorTest) glEnable(GL_SCISSOR_TEST);
+    }
+
+    bool FrameStatistics::poll() {
+        ++pollCount;
+        bool updated = false;
+        // Oldest first: the next slot holds the oldest request
+        for (int i = 0; i < SLOTS; ++i) {
+            Slot& slot = slots[(nextSlot + i) % SLOTS];
+            if (!slot.pending) continue;
+            if (!collect(slot, false)) break;
+            updated = true;
+        }
+        return updated;
+    }
+
+    void FrameStatistics::finish() {
+        for (int i = 0; i < SLOTS; ++i) {
+            Slot& slot = slots[(nextSlot + i) % SLOTS];
+            if (slot.pending) collect(slot, true);
+        }
+    }
+
+    bool FrameStatistics::collect(Slot& slot, bool wait) {
+        if (slot.fence) {
+            GLsync fence = static_cast<GLsync>(slot.fence);
+            GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (wait && status == GL_TIMEOUT_EXPIRED) {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            if (status == GL_TIMEOUT_EXPIRED) return false;
+            glDeleteSync(fence);
+            slot.fence = nullptr;
+            if (status == GL_WAIT_FAILED) {
+                slot.pending = false;
+                return false;
+            }
+        } else if (!wait && pollCount - slot.polledAt < READBACK_DELAY) {
+            // Mapping now could stall until the GPU catches up
+            return false;
+        }
+        slot.pending = false;
+
+        uint32_t data[READBACK_WORDS];
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(data), GL_MAP_READ_BIT);
+        if (!mapped) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            return false;
+        }
+        std::memcpy(data, mapped, sizeof(data));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        FrameStats frame;
+        frame.valid = true;
+        frame.request = slot.request;
+        if (useCompute) {
+            uint64_t sum = (static_cast<uint64_t>(data[1]) << 32) | data[0];
+            frame.averageLuminance = static_cast<float>(sum / COMPUTE_SUM_SCALE / slot.pixels);
+            std::memcpy(&frame.minLuminance, &data[2], sizeof(float));
+            std::memcpy(&frame.maxLuminance, &data[3], sizeof(float));
+            for (int i = 0; i < FrameStats::HISTOGRAM_BINS; ++i) {
+                frame.histogram[i] = static_cast<float>(data[HEADER_WORDS + i]) / slot.pixels;
+            }
+        } else {
+            float values[READBACK_WORDS];
+            std::memcpy(values, data, sizeof(values));
+            frame.averageLuminance = values[0] / std::max(values[3], 1.0f);
+            frame.minLuminance = values[1];
+            frame.maxLuminance = values[2];
+            for (int i = 0; i < FrameStats::HISTOGRAM_BINS; ++i) {
+                frame.histogram[i] = values[HEADER_WORDS + i] / slot.histogramSamples;
+            }
+        }
+
+        // A newer result may have been collected already
+        if (frame.request > stats.request) {
+            stats = frame;
+        }
+        return true;
+    }
+
+    void FrameStatistics::destroy() {
+        for (Slot& slot : slots) {
+            if (slot.fence) glDeleteSync(static_cast<GLsync>(slot.fence));
+            if (slot.buffer != 0) glDeleteBuffers(1, &slot.buffer);
+            slot = Slot();
+        }
+        for (const Level& level : levels) {
+            SoftwareRasterizer::getInstance().forgetTexture(level.texture);
+            glDeleteTextures(1, &level.texture);
+        }
+        levels.clear();
+        if (histogramTexture != 0) {
+            SoftwareRasterizer::getInstance().forgetTexture(histogramTexture);
+            glDeleteTextures(1, &histogramTexture);
+            histogramTexture = 0;
+        }
+        if (framebuffer != 0) {
+            glDeleteFramebuffers(1, &framebuffer);
+            framebuffer = 0;
+        }
+        if (pointVAO != 0) {
+            glDeleteVertexArrays(1, &pointVAO);
+            pointVAO = 0;
+        }
+        computeShader.destroy();
+        reduceShader.destroy();
+        histogramShader.destroy();
+
+        initialized = false;
+        useCompute = false;
+        nextSlot = 0;
+        pollCount = 0;
+        levelWidth = levelHeight = 0;
+        stats = FrameStats();
+    }
+} // namespace cridgeon
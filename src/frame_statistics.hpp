@@ -0,0 +1,115 @@
+#pragma once
+
+#include "shader/shader.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cridgeon
+{
+    struct FrameStats {
+        static const int HISTOGRAM_BINS = 256;
+
+        bool valid = false;
+        uint64_t request = 0;           // Number returned by the request() that produced these
+
+        // Rec. 709 luminance of the stored color values
+        float averageLuminance = 0.0f;
+        float minLuminance = 0.0f;
+        float maxLuminance = 0.0f;
+
+        // Fraction of pixels per luminance bin; bin i covers [i / 256, (i + 1) / 256),
+        // the last one also everything brighter
+        float histogram[HISTOGRAM_BINS] = {};
+    };
+
+    // GPU reductions of a texture for auto-exposure and output checks, in
+    // place of reading the whole frame back with Texture::readPixels. On GL
+    // 4.3+ one compute dispatch reduces every pixel into a shader storage
+    // buffer. Older contexts reduce 2x2 blocks level by level down to one
+    // texel, like a mip chain, and build the histogram by drawing one point
+    // per pixel (on a grid of at most 512x512) into a 256x1 target. Either
+    // way about a kilobyte is read back, fenced a few frames later so the
+    // pipeline never stalls. Without fences (GL 3.0 and 3.1) a result is
+    // read back READBACK_DELAY poll() calls after its request instead.
+    class FrameStatistics {
+    public:
+        FrameStatistics();
+        ~FrameStatistics();
+
+        // Disable copy constructor and assignment operator
+        FrameStatistics(const FrameStatistics&) = delete;
+        FrameStatistics& operator=(const FrameStatistics&) = delete;
+
+        // Queue the reduction of the width x height region at the origin of
+        // the texture. Returns the request number, or 0 if every readback
+        // slot is still in flight and the request was dropped.
+        uint64_t request(unsigned int texture, int width, int height);
+
+        // Read back finished requests without waiting; true if getStats()
+        // changed. Call once per frame.
+        bool poll();
+
+        // Wait for every queued request, e.g. in tests
+        void finish();
+
+        // Results of the newest finished request
+        const FrameStats& getStats() const { return stats; }
+
+        // Check whether the compute shader path is in use
+        bool isUsingCompute() const { return useCompute; }
+
+        void destroy();
+
+    private:
+        static const int SLOTS = 3;
+
+        // poll() calls after which an unfenced request is assumed finished
+        static const int READBACK_DELAY = 2;
+
+        // Pixels sampled along each axis by the fragment path's histogram
+        static const int MAX_HISTOGRAM_GRID = 512;
+
+        struct Slot {
+            unsigned int buffer = 0;
+            bool pending = false;
+            void* fence = nullptr;          // Null when fences are unavailable
+            uint64_t polledAt = 0;          // pollCount when requested
+            uint64_t request = 0;
+            uint64_t pixels = 0;            // Pixels in the region
+            uint64_t histogramSamples = 0;  // Points drawn by the fragment path
+        };
+
+        struct Level {
+            unsigned int texture;
+            int width, height;
+        };
+
+        bool initialized;
+        bool useCompute;
+        Shader computeShader;
+        Shader reduceShader, histogramShader;
+
+        Slot slots[SLOTS];
+        int nextSlot;
+        uint64_t requestCount;
+        uint64_t pollCount;
+        FrameStats stats;
+
+        // Fragment path: reduction levels, the histogram target and the
+        // framebuffer they are attached to in turn
+        std::vector<Level> levels;
+        unsigned int histogramTexture;
+        unsigned int framebuffer;
+        unsigned int pointVAO;
+        int levelWidth, levelHeight;
+
+        bool initialize();
+        void resizeLevels(int width, int height);
+        void reduceCompute(Slot& slot, unsigned int texture, int width, int height);
+        void reduceFragment(Slot& slot, unsigned int texture, int width, int height);
+
+        // Read a slot back if it has finished, waiting when `wait` is set
+        bool collect(Slot& slot, bool wait);
+    };
+} // namespace cridgeon
@@ -1,10 +1,15 @@
 #include "framebuffer.hpp"
+#include "shader/batch.hpp"
+#include "software/rasterizer.hpp"
+#include "texture/sampler.hpp"
+#include <algorithm>
 #include <iostream>
 #include <glad/gl.h>
 
 namespace cridgeon
 {
-    Framebuffer::Framebuffer() : framebufferID(0), colorTexture(0), depthRenderbuffer(0), width(0), height(0) {}
+    Framebuffer::Framebuffer()
+        : framebufferID(0), colorTexture(0), colorRenderbuffer(0), depthRenderbuffer(0), width(0), height(0) {}
     
     Framebuffer::~Framebuffer() {
         cleanup();
@@ -13,11 +18,14 @@ namespace cridgeon
     Framebuffer::Framebuffer(Framebuffer&& other) noexcept 
         : framebufferID(other.framebufferID), 
           colorTexture(other.colorTexture),
+          colorRenderbuffer(other.colorRenderbuffer),
           depthRenderbuffer(other.depthRenderbuffer),
           width(other.width),
-          height(other.height) {
+          height(other.height),
+          spec(other.spec) {
         other.framebufferID = 0;
         other.colorTexture = 0;
+        other.colorRenderbuffer = 0;
         other.depthRenderbuffer = 0;
         other.width = 0;
         other.height = 0;
@@ -29,12 +37,15 @@ namespace cridgeon
             
             framebufferID = other.framebufferID;
             colorTexture = other.colorTexture;
+            colorRenderbuffer = other.colorRenderbuffer;
             depthRenderbuffer = other.depthRenderbuffer;
             width = other.width;
             height = other.height;
+            spec = other.spec;
             
             other.framebufferID = 0;
             other.colorTexture = 0;
+            other.colorRenderbuffer = 0;
             other.depthRenderbuffer = 0;
             other.width = 0;
             other.height = 0;
@@ -42,68 +53,172 @@ namespace cridgeon
         return *this;
     }
     
-    bool Framebuffer::create(int w, int h) {
+    bool Framebuffer::create(int w, int h, const FramebufferSpec& framebufferSpec) {
         width = w;
         height = h;
+        spec = framebufferSpec;
+        if (spec.samples > 1) {
+            spec.samples = std::min(spec.samples, getMaxSamples());
+        }
     
+        // Creation may happen while another target is bound (e.g. a pool miss
+        // inside a post-processed scene); leave every binding as it was
+        GLint previousFramebuffer = 0, previousTexture = 0, previousRenderbuffer = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glGetIntegerv(GL_RENDERBUFFER_BINDING, &previousRenderbuffer);
+
         // Generate framebuffer
         glGenFramebuffers(1, &framebufferID);
         glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
     
-        // Create color texture
-        glGenTextures(1, &colorTexture);
-        glBindTexture(GL_TEXTURE_2D, colorTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        GLint internalFormat = spec.halfFloat ? (spec.alpha ? GL_RGBA16F : GL_RGB16F)
+                                              : (spec.alpha ? GL_RGBA8 : GL_RGB8);
+        if (isMultisampled()) {
+            // Create multisampled color renderbuffer; it is read through resolve()
+            glGenRenderbuffers(1, &colorRenderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, spec.samples, internalFormat, width, height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+        } else {
+            // Create color texture
+            glGenTextures(1, &colorTexture);
+            glBindTexture(GL_TEXTURE_2D, colorTexture);
+            // Sized like the multisampled renderbuffer, so resolves copy between equal formats
+            GLenum format = spec.alpha ? GL_RGBA : GL_RGB;
+            GLenum type = spec.halfFloat ? GL_FLOAT : GL_UNSIGNED_BYTE;
+            int levels = getMipLevels();
+            for (int level = 0; level < levels; ++level) {
+                glTexImage2D(GL_TEXTURE_2D, level, internalFormat, std::max(width >> level, 1), std::max(height >> level, 1),
+                             0, format, type, nullptr);
+            }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            // Filters sampling past the edge must not wrap around to the other side
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        }
     
         // Create depth renderbuffer
-        glGenRenderbuffers(1, &depthRenderbuffer);
-        glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+        if (spec.depth) {
+            glGenRenderbuffers(1, &depthRenderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+            if (isMultisampled()) {
+                glRenderbufferStorageMultisample(GL_RENDERBUFFER, spec.samples, GL_DEPTH_COMPONENT24, width, height);
+            } else {
+                glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+            }
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+        }
     
         // Check if framebuffer is complete
         if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
             std::cerr << "ERROR::FRAMEBUFFER:: Framebuffer not complete!" << std::endl;
             cleanup();
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+            glBindTexture(GL_TEXTURE_2D, previousTexture);
+            glBindRenderbuffer(GL_RENDERBUFFER, previousRenderbuffer);
             return false;
         }
     
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+        glBindRenderbuffer(GL_RENDERBUFFER, previousRenderbuffer);
         return true;
     }
     
+    int Framebuffer::getMaxSamples() {
+        GLint maxSamples = 0;
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        return static_cast<int>(maxSamples);
+    }
+
     void Framebuffer::bind() const {
         if (framebufferID != 0) {
+            Render::flushBatches();
             glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
             glViewport(0, 0, width, height);
         }
     }
     
     void Framebuffer::unbind() const {
+        Render::flushBatches();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     
+    bool Framebuffer::resolve(const Framebuffer& target) const {
+        if (framebufferID == 0 || !target.isValid() || target.isMultisampled() ||
+            target.width != width || target.height != height) {
+            std::cerr << "ERROR::FRAMEBUFFER:: Resolve target must be a single-sample framebuffer of the same size" << std::endl;
+            return false;
+        }
+
+        Render::flushBatches();
+        GLint previousRead = 0, previousDraw = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebufferID);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.framebufferID);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
+        return true;
+    }
+    
+    void Framebuffer::generateMips() const {
+        if (colorTexture == 0 || !spec.mipmaps) {
+            std::cerr << "Warning: Framebuffer has no mip levels to generate" << std::endl;
+            return;
+        }
+
+        Render::flushBatches();
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    int Framebuffer::getMipLevels() const {
+        if (!spec.mipmaps || isMultisampled()) return 1;
+        int levels = 1;
+        while ((std::max(width, height) >> levels) > 0) {
+            ++levels;
+        }
+        return levels;
+    }
+    
     bool Framebuffer::resize(int newWidth, int newHeight) {
         if (newWidth <= 0 || newHeight <= 0) return false;
         
         cleanup();
-        return create(newWidth, newHeight);
+        return create(newWidth, newHeight, spec);
     }
     
     void Framebuffer::cleanup() {
+        // Quads already queued may still sample the color texture
+        if (framebufferID != 0) {
+            Render::flushBatches();
+        }
+
         if (depthRenderbuffer != 0) {
             glDeleteRenderbuffers(1, &depthRenderbuffer);
             depthRenderbuffer = 0;
         }
         
         if (colorTexture != 0) {
+            SamplerCache::getInstance().forgetTexture(colorTexture);
+            SoftwareRasterizer::getInstance().forgetTexture(colorTexture);
             glDeleteTextures(1, &colorTexture);
             colorTexture = 0;
         }
+
+        if (colorRenderbuffer != 0) {
+            glDeleteRenderbuffers(1, &colorRenderbuffer);
+            colorRenderbuffer = 0;
+        }
         
         if (framebufferID != 0) {
             glDeleteFramebuffers(1, &framebufferID);
@@ -2,6 +2,21 @@
 
 namespace cridgeon
 {
+    // Attachments and format of a framebuffer
+    struct FramebufferSpec {
+        bool alpha = false;     // RGBA color attachment instead of RGB
+        bool depth = true;      // Depth renderbuffer
+        int samples = 0;        // Above 1: multisampled renderbuffers, read through resolve()
+        bool mipmaps = false;   // Full mip chain on the color texture, filled by generateMips()
+        bool halfFloat = false; // 16-bit float color, keeping values above 1 (use with alpha:
+                                // GL_RGB16F is not guaranteed to be renderable)
+
+        bool operator==(const FramebufferSpec& other) const {
+            return alpha == other.alpha && depth == other.depth && samples == other.samples &&
+                   mipmaps == other.mipmaps && halfFloat == other.halfFloat;
+        }
+    };
+
     class Framebuffer {
     public:
         Framebuffer();
@@ -16,7 +31,7 @@ namespace cridgeon
         Framebuffer& operator=(Framebuffer&& other) noexcept;
     
         // Create framebuffer with specified dimensions
-        bool create(int width, int height);
+        bool create(int width, int height, const FramebufferSpec& spec = FramebufferSpec());
     
         // Bind framebuffer for rendering
         void bind() const;
@@ -24,12 +39,34 @@ namespace cridgeon
         // Unbind framebuffer (restore default framebuffer)
         void unbind() const;
     
-        // Get the color texture ID
+        // Get the OpenGL framebuffer object ID
+        unsigned int getID() const { return framebufferID; }
+
+        // Get the color texture ID (0 when multisampled)
         unsigned int getColorTexture() const { return colorTexture; }
+
+        // Check if the attachments are multisampled renderbuffers
+        bool isMultisampled() const { return spec.samples > 1; }
+
+        // Largest sample count the context supports; create() clamps to it
+        static int getMaxSamples();
+
+        // Blit the color buffer into a single-sample framebuffer of the same
+        // size, averaging the samples of a multisampled one
+        bool resolve(const Framebuffer& target) const;
+
+        // Fill the mip levels from level 0 after rendering, so shaders can
+        // read coarse versions with textureLod. Needs spec.mipmaps.
+        void generateMips() const;
+
+        // Number of levels in the color texture, 1 without mipmaps
+        int getMipLevels() const;
     
         // Get framebuffer dimensions
         int getWidth() const { return width; }
         int getHeight() const { return height; }
+
+        const FramebufferSpec& getSpec() const { return spec; }
     
         // Check if framebuffer is valid
         bool isValid() const { return framebufferID != 0; }
@@ -41,8 +78,9 @@ namespace cridgeon
     private:
         unsigned int framebufferID;
         unsigned int colorTexture;
+        unsigned int colorRenderbuffer;     // Multisampled color
         unsigned int depthRenderbuffer;
         int width, height;
-    
+        FramebufferSpec spec;
     };
 } // namespace cridgeon
\ No newline at end of file
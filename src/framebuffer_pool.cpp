@@ -0,0 +1,63 @@
+#include "framebuffer_pool.hpp"
+
+#include <algorithm>
+
+namespace cridgeon
+{
+    FramebufferPool& FramebufferPool::getInstance() {
+        static FramebufferPool instance;
+        return instance;
+    }
+
+    Framebuffer* FramebufferPool::acquire(int width, int height, const FramebufferSpec& requested) {
+        // Compare against the spec create() stores, or requests above
+        // GL_MAX_SAMPLES would never match and allocate every time
+        FramebufferSpec spec = requested;
+        if (spec.samples > 1) {
+            spec.samples = std::min(spec.samples, Framebuffer::getMaxSamples());
+        }
+
+        for (auto& entry : entries) {
+            const Framebuffer& framebuffer = entry->framebuffer;
+            if (!entry->inUse && framebuffer.getWidth() == width && framebuffer.getHeight() == height &&
+                framebuffer.getSpec() == spec) {
+                entry->inUse = true;
+                entry->idleFrames = 0;
+                return &entry->framebuffer;
+            }
+        }
+
+        std::unique_ptr<Entry> entry(new Entry());
+        if (!entry->framebuffer.create(width, height, spec)) {
+            return nullptr;
+        }
+        entry->inUse = true;
+        entries.push_back(std::move(entry));
+        return &entries.back()->framebuffer;
+    }
+
+    void FramebufferPool::release(Framebuffer* framebuffer) {
+        for (auto& entry : entries) {
+            if (&entry->framebuffer == framebuffer) {
+                entry->inUse = false;
+                entry->idleFrames = 0;
+                return;
+            }
+        }
+    }
+
+    void FramebufferPool::trim(int maxIdleFrames) {
+        for (auto& entry : entries) {
+            if (!entry->inUse) {
+                ++entry->idleFrames;
+            }
+        }
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [maxIdleFrames](const std::unique_ptr<Entry>& entry) {
+            return !entry->inUse && entry->idleFrames > maxIdleFrames;
+        }), entries.end());
+    }
+
+    void FramebufferPool::destroy() {
+        entries.clear();
+    }
+} // namespace cridgeon
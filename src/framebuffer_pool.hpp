@@ -0,0 +1,47 @@
+#pragma once
+
+#include "framebuffer.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace cridgeon
+{
+    // Reuses framebuffers across layers and passes. A released framebuffer
+    // is handed to the next acquire() with the same size and spec instead of
+    // reallocating; framebuffers left unused for a while are freed by trim().
+    class FramebufferPool {
+    public:
+        static FramebufferPool& getInstance();
+
+        FramebufferPool(const FramebufferPool&) = delete;
+        FramebufferPool& operator=(const FramebufferPool&) = delete;
+
+        // Get a framebuffer of the given size and spec; nullptr if creation failed.
+        // The contents are undefined. The pool keeps ownership.
+        Framebuffer* acquire(int width, int height, const FramebufferSpec& spec = FramebufferSpec());
+
+        // Return a framebuffer obtained from acquire()
+        void release(Framebuffer* framebuffer);
+
+        // Free framebuffers released more than `maxIdleFrames` frames ago.
+        // Called once per frame by RenderingSystem::endFrame().
+        void trim(int maxIdleFrames = 60);
+
+        size_t getPooledCount() const { return entries.size(); }
+
+        // Free every framebuffer, including those still acquired
+        void destroy();
+
+    private:
+        struct Entry {
+            Framebuffer framebuffer;
+            bool inUse = false;
+            int idleFrames = 0;
+        };
+
+        std::vector<std::unique_ptr<Entry>> entries;
+
+        FramebufferPool() = default;
+    };
+} // namespace cridgeon
@@ -6,10 +6,25 @@
 #include <glad/gl.h>
 
 #include "rendering_system.hpp"
+#include "gl_capabilities.hpp"
+#include "stream_buffer.hpp"
 #include "postprocessor.hpp"
+#include "resolution_controller.hpp"
+#include "color_grading.hpp"
+#include "particle_system.hpp"
+#include "captured_lines.hpp"
+#include "shape_prototype.hpp"
 #include "shader/all.hpp"
 #include "framebuffer.hpp"
+#include "framebuffer_pool.hpp"
+#include "layer.hpp"
+#include "render_queue.hpp"
+#include "overdraw.hpp"
+#include "frame_statistics.hpp"
+#include "hit_index.hpp"
 #include "texture/all.hpp"
+#include "text/all.hpp"
+#include "software/all.hpp"
 
 
 #endif
\ No newline at end of file
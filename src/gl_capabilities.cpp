@@ -0,0 +1,59 @@
+#include "gl_capabilities.hpp"
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace cridgeon
+{
+    static GLCapabilities capabilities;
+    static GLExtFunctions extFunctions;
+
+    template <typename T>
+    static bool loadFunction(T& function, const char* name) {
+        function = reinterpret_cast<T>(glfwGetProcAddress(name));
+        return function != nullptr;
+    }
+
+    void detectGLCapabilities(bool allowFastPaths) {
+        capabilities = GLCapabilities();
+        extFunctions = GLExtFunctions();
+
+        glGetIntegerv(GL_MAJOR_VERSION, &capabilities.major);
+        glGetIntegerv(GL_MINOR_VERSION, &capabilities.minor);
+
+        if (!allowFastPaths) {
+            return;
+        }
+
+        capabilities.fenceSync = capabilities.atLeast(3, 2);
+        capabilities.samplerObjects = capabilities.atLeast(3, 3);
+        capabilities.instancedArrays = capabilities.atLeast(3, 3);
+        capabilities.timerQuery = capabilities.atLeast(3, 3);
+
+        if (capabilities.atLeast(4, 3)) {
+            capabilities.multiDrawIndirect =
+                loadFunction(extFunctions.MultiDrawArraysIndirect, "glMultiDrawArraysIndirect");
+            capabilities.computeShader =
+                loadFunction(extFunctions.DispatchCompute, "glDispatchCompute") &&
+                loadFunction(extFunctions.MemoryBarrier, "glMemoryBarrier");
+        }
+        if (capabilities.atLeast(4, 4)) {
+            capabilities.bufferStorage =
+                loadFunction(extFunctions.BufferStorage, "glBufferStorage");
+        }
+        if (capabilities.atLeast(4, 5)) {
+            capabilities.directStateAccess =
+                loadFunction(extFunctions.CreateBuffers, "glCreateBuffers") &&
+                loadFunction(extFunctions.NamedBufferStorage, "glNamedBufferStorage") &&
+                loadFunction(extFunctions.MapNamedBufferRange, "glMapNamedBufferRange");
+        }
+    }
+
+    const GLCapabilities& glCapabilities() {
+        return capabilities;
+    }
+
+    const GLExtFunctions& glExt() {
+        return extFunctions;
+    }
+} // namespace cridgeon
@@ -0,0 +1,91 @@
+/// @file gl_capabilities.hpp
+/// @brief Detection of optional OpenGL features and loading of the GL 4.x
+///        entry points used by the fast paths. The bundled loader only covers
+///        GL 3.3, so newer functions are resolved here after the context is
+///        created; every fast path checks its capability flag and falls back
+///        to the GL 3.0 code path when it is false.
+#ifndef CRIDGEON_GL_CAPABILITIES_HPP
+#define CRIDGEON_GL_CAPABILITIES_HPP
+
+#include <glad/gl.h>
+#include <cstddef>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#define CRIDGEON_GL_APIENTRY __stdcall
+#else
+#define CRIDGEON_GL_APIENTRY
+#endif
+
+// Tokens introduced after GL 3.3
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+
+namespace cridgeon {
+
+    /// @brief Optional features of the current context.
+    struct GLCapabilities {
+        int major = 0;
+        int minor = 0;
+
+        bool fenceSync = false;           // GL 3.2
+        bool samplerObjects = false;      // GL 3.3
+        bool instancedArrays = false;     // GL 3.3 (glVertexAttribDivisor)
+        bool timerQuery = false;          // GL 3.3
+        bool multiDrawIndirect = false;   // GL 4.3
+        bool computeShader = false;       // GL 4.3 (with shader storage buffers)
+        bool bufferStorage = false;       // GL 4.4
+        bool directStateAccess = false;   // GL 4.5
+
+        bool atLeast(int maj, int min) const {
+            return major > maj || (major == maj && minor >= min);
+        }
+    };
+
+    /// @brief GL 4.x entry points, null when the context does not provide them.
+    struct GLExtFunctions {
+        // GL 4.3
+        void (CRIDGEON_GL_APIENTRY *MultiDrawArraysIndirect)(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride) = nullptr;
+        void (CRIDGEON_GL_APIENTRY *DispatchCompute)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) = nullptr;
+        void (CRIDGEON_GL_APIENTRY *MemoryBarrier)(GLbitfield barriers) = nullptr;
+        // GL 4.4
+        void (CRIDGEON_GL_APIENTRY *BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) = nullptr;
+        // GL 4.5
+        void (CRIDGEON_GL_APIENTRY *CreateBuffers)(GLsizei n, GLuint* buffers) = nullptr;
+        void (CRIDGEON_GL_APIENTRY *NamedBufferStorage)(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags) = nullptr;
+        void* (CRIDGEON_GL_APIENTRY *MapNamedBufferRange)(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access) = nullptr;
+    };
+
+    /// @brief Queries the current context and resolves the GL 4.x entry points.
+    ///        Called by RenderingSystem once the context is current.
+    /// @param allowFastPaths When false every optional feature is reported as
+    ///        missing, forcing the GL 3.0 paths (useful for testing fallbacks).
+    void detectGLCapabilities(bool allowFastPaths = true);
+
+    /// @brief Capabilities of the current context, as detected at initialization.
+    const GLCapabilities& glCapabilities();
+
+    /// @brief GL 4.x entry points resolved at initialization.
+    const GLExtFunctions& glExt();
+
+} // namespace cridgeon
+
+#endif // CRIDGEON_GL_CAPABILITIES_HPP
@@ -0,0 +1,598 @@
+#include "hit_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace cridgeon
+{
+    static const float TWO_PI = 6.28318530718f;
+
+    // Position along a Hilbert curve through a 65536 x 65536 grid
+    static uint32_t hilbert(uint32_t x, uint32_t y) {
+        uint32_t a = x ^ y;
+        uint32_t b = 0xFFFF ^ a;
+        uint32_t c = 0xFFFF ^ (x | y);
+        uint32_t d = x & (y ^ 0xFFFF);
+
+        uint32_t A = a | (b >> 1);
+        uint32_t B = (a >> 1) ^ a;
+        uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+        a = A; b = B; c = C; d = D;
+        A = (a & (a >> 2)) ^ (b & (b >> 2));
+        B = (a & (b >> 2)) ^ (b & ((a ^ b) >> 2));
+        C ^= (a & (c >> 2)) ^ (b & (d >> 2));
+        D ^= (b & (c >> 2)) ^ ((a ^ b) & (d >> 2));
+
+        a = A; b = B; c = C; d = D;
+        A = (a & (a >> 4)) ^ (b & (b >> 4));
+        B = (a & (b >> 4)) ^ (b & ((a ^ b) >> 4));
+        C ^= (a & (c >> 4)) ^ (b & (d >> 4));
+        D ^= (b & (c >> 4)) ^ ((a ^ b) & (d >> 4));
+
+        a = A; b = B; c = C; d = D;
+        C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+        D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+
+        a = C ^ (C >> 1);
+        b = D ^ (D >> 1);
+
+        uint32_t i0 = x ^ y;
+        uint32_t i1 = b | (0xFFFF ^ (i0 | a));
+
+        i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+        i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+        i0 = (i0 | (i0 << 2)) & 0x33333333;
+        i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+        i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+        i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+        i1 = (i1 | (i1 << 2)) & 0x33333333;
+        i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+        return (i1 << 1) | i0;
+    }
+
+    static float segmentDistance(float px, float py, float ax, float ay, float bx, float by) {
+        float dx = bx - ax, dy = by - ay;
+        float lengthSquared = dx * dx + dy * dy;
+        float t = lengthSquared > 0.0f ? ((px - ax) * dx + (py - ay) * dy) / lengthSquared : 0.0f;
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        return std::hypot(px - (ax + t * dx), py - (ay + t * dy));
+    }
+
+    static float rectDistance(float px, float py, float minX, float minY, float maxX, float maxY) {
+        float dx = std::max(std::max(minX - px, px - maxX), 0.0f);
+        float dy = std::max(std::max(minY - py, py - maxY), 0.0f);
+        return std::hypot(dx, dy);
+    }
+
+    // Liang-Barsky clip of the segment against the rectangle
+    static bool segmentIntersectsRect(float ax, float ay, float bx, float by,
+                                      float minX, float minY, float maxX, float maxY) {
+        float t0 = 0.0f, t1 = 1.0f;
+        float dx = bx - ax, dy = by - ay;
+        const float p[4] = {-dx, dx, -dy, dy};
+        const float q[4] = {ax - minX, maxX - ax, ay - minY, maxY - ay};
+        for (int i = 0; i < 4; ++i) {
+            if (p[i] == 0.0f) {
+                if (q[i] < 0.0f) return false;
+                continue;
+            }
+            float t = q[i] / p[i];
+            if (p[i] < 0.0f) {
+                t0 = std::max(t0, t);
+            } else {
+                t1 = std::min(t1, t);
+            }
+            if (t0 > t1) return false;
+        }
+        return true;
+    }
+
+    static float segmentRectDistance(float ax, float ay, float bx, float by,
+                                     float minX, float minY, float maxX, float maxY) {
+        if (segmentIntersectsRect(ax, ay, bx, by, minX, minY, maxX, maxY)) return 0.0f;
+        float best = std::min(rectDistance(ax, ay, minX, minY, maxX, maxY), rectDistance(bx, by, minX, minY, maxX, maxY));
+        best = std::min(best, segmentDistance(minX, minY, ax, ay, bx, by));
+        best = std::min(best, segmentDistance(maxX, minY, ax, ay, bx, by));
+        best = std::min(best, segmentDistance(maxX, maxY, ax, ay, bx, by));
+        best = std::min(best, segmentDistance(minX, maxY, ax, ay, bx, by));
+        return best;
+    }
+
+    // Nonzero winding number of the closed polygon around the point
+    static int winding(const float* points, size_t count, float px, float py) {
+        int total = 0;
+        for (size_t i = 0, j = count - 1; i < count; j = i++) {
+            float ax = points[j * 2], ay = points[j * 2 + 1];
+            float bx = points[i * 2], by = points[i * 2 + 1];
+            float side = (bx - ax) * (py - ay) - (px - ax) * (by - ay);
+            if (ay <= py) {
+                if (by > py && side > 0.0f) ++total;
+            } else if (by <= py && side < 0.0f) {
+                --total;
+            }
+        }
+        return total;
+    }
+
+    static float polygonDistance(const float* points, size_t count, float px, float py) {
+        if (winding(points, count, px, py) != 0) return -1.0f;
+        float best = std::numeric_limits<float>::max();
+        for (size_t i = 0, j = count - 1; i < count; j = i++) {
+            best = std::min(best, segmentDistance(px, py, points[j * 2], points[j * 2 + 1], points[i * 2], points[i * 2 + 1]));
+        }
+        return best;
+    }
+
+    // Without an edge crossing the rectangle, the rectangle lies in a single
+    // winding region, so testing one of its points decides
+    static bool polygonOverlapsRect(const float* points, size_t count, float minX, float minY, float maxX, float maxY) {
+        for (size_t i = 0, j = count - 1; i < count; j = i++) {
+            if (segmentIntersectsRect(points[j * 2], points[j * 2 + 1], points[i * 2], points[i * 2 + 1],
+                                      minX, minY, maxX, maxY)) {
+                return true;
+            }
+        }
+        return winding(points, count, minX, minY) != 0;
+    }
+
+    // Same distance function as rounded_rect.frag; p relative to the center
+    static float roundedBoxDistance(float px, float py, float halfW, float halfH, const float* radii) {
+        float radius = px > 0.0f ? (py > 0.0f ? radii[2] : radii[1])
+                                 : (py > 0.0f ? radii[3] : radii[0]);
+        float qx = std::abs(px) - halfW + radius;
+        float qy = std::abs(py) - halfH + radius;
+        return std::min(std::max(qx, qy), 0.0f) + std::hypot(std::max(qx, 0.0f), std::max(qy, 0.0f)) - radius;
+    }
+
+    // Whether the direction (dx, dy) lies within [start, start + span]
+    static bool angleInSpan(float dx, float dy, float start, float span) {
+        float offset = std::atan2(dy, dx) - start;
+        offset -= std::floor(offset / TWO_PI) * TWO_PI;
+        return offset <= span;
+    }
+
+    // Whether the arc of the circle at the origin crosses one of the
+    // rectangle's edges; the rectangle is relative to the circle's center
+    static bool arcCrossesRect(float radius, float start, float span,
+                               float minX, float minY, float maxX, float maxY) {
+        // Each edge meets the circle where the other coordinate is +-sqrt(r^2 - c^2)
+        const float lines[4] = {minX, maxX, minY, maxY};
+        for (int i = 0; i < 4; ++i) {
+            float c = lines[i];
+            float squared = radius * radius - c * c;
+            if (squared < 0.0f) continue;
+            float root = std::sqrt(squared);
+            float low = i < 2 ? minY : minX, high = i < 2 ? maxY : maxX;
+            for (float along : {-root, root}) {
+                if (along < low || along > high) continue;
+                float dx = i < 2 ? c : along, dy = i < 2 ? along : c;
+                if (angleInSpan(dx, dy, start, span)) return true;
+            }
+        }
+        return false;
+    }
+
+    HitIndex::HitIndex() : built(false) {}
+
+    float* HitIndex::addPrimitive(Shape shape, Id id, size_t floatCount, float minX, float minY, float maxX, float maxY) {
+        Primitive primitive;
+        primitive.shape = shape;
+        primitive.params = static_cast<uint32_t>(params.size());
+        primitive.count = 0;
+        primitive.shared = 0;
+        primitive.id = id;
+        primitive.minX = minX;
+        primitive.minY = minY;
+        primitive.maxX = maxX;
+        primitive.maxY = maxY;
+        primitives.push_back(primitive);
+        built = false;
+
+        params.resize(params.size() + floatCount);
+        return params.data() + primitive.params;
+    }
+
+    void HitIndex::addRadial(Id id, float x, float y, float innerRadius, float outerRadius,
+                             float startAngle, float span, bool roundCaps) {
+        innerRadius = std::max(innerRadius, 0.0f);
+        if (outerRadius <= innerRadius) return;
+        if (span < 0.0f) {
+            startAngle += span;
+            span = -span;
+        }
+
+        // Round caps stay inside the outer radius
+        float* p = addPrimitive(Shape::RADIAL, id, 7, x - outerRadius, y - outerRadius, x + outerRadius, y + outerRadius);
+        p[0] = x;
+        p[1] = y;
+        p[2] = innerRadius;
+        p[3] = outerRadius;
+        p[4] = startAngle;
+        p[5] = std::min(span, TWO_PI);
+        p[6] = roundCaps ? 1.0f : 0.0f;
+    }
+
+    void HitIndex::addRoundedRect(Id id, float x, float y, float w, float h, const float radii[4]) {
+        if (w < 0.0f) {
+            x += w;
+            w = -w;
+        }
+        if (h < 0.0f) {
+            y += h;
+            h = -h;
+        }
+
+        float* p = addPrimitive(Shape::ROUNDED_RECT, id, 8, x, y, x + w, y + h);
+        float maxRadius = std::min(w, h) * 0.5f;
+        p[0] = x;
+        p[1] = y;
+        p[2] = w;
+        p[3] = h;
+        for (int i = 0; i < 4; ++i) {
+            p[4 + i] = std::min(std::max(radii[i], 0.0f), maxRadius);
+        }
+    }
+
+    void HitIndex::addBox(Id id, float x, float y, float w, float h) {
+        const float radii[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        addRoundedRect(id, x, y, w, h, radii);
+    }
+
+    void HitIndex::addSegment(Id id, float x0, float y0, float x1, float y1, float width) {
+        float halfWidth = std::abs(width) * 0.5f;
+        float* p = addPrimitive(Shape::SEGMENT, id, 5,
+                                std::min(x0, x1) - halfWidth, std::min(y0, y1) - halfWidth,
+                                std::max(x0, x1) + halfWidth, std::max(y0, y1) + halfWidth);
+        p[0] = x0;
+        p[1] = y0;
+        p[2] = x1;
+        p[3] = y1;
+        p[4] = halfWidth;
+    }
+
+    void HitIndex::addPolygon(Id id, const float* vertices, size_t pointCount) {
+        if (pointCount < 3) return;
+
+        float minX = vertices[0], minY = vertices[1], maxX = vertices[0], maxY = vertices[1];
+        for (size_t i = 1; i < pointCount; ++i) {
+            minX = std::min(minX, vertices[i * 2]);
+            minY = std::min(minY, vertices[i * 2 + 1]);
+            maxX = std::max(maxX, vertices[i * 2]);
+            maxY = std::max(maxY, vertices[i * 2 + 1]);
+        }
+
+        float* p = addPrimitive(Shape::POLYGON, id, pointCount * 2, minX, minY, maxX, maxY);
+        std::copy(vertices, vertices + pointCount * 2, p);
+        primitives.back().count = static_cast<uint32_t>(pointCount);
+    }
+
+    void HitIndex::addTriangleInstances(Id firstId, const float* vertices, size_t vertexCount, size_t vertexStride,
+                                        const float* placements, size_t placementCount, size_t placementStride) {
+        vertexCount -= vertexCount % 3;
+        if (vertexCount == 0 || placementCount == 0) return;
+
+        // The triangles are stored once; every placement refers to them
+        uint32_t shared = static_cast<uint32_t>(params.size());
+        float radius = 0.0f;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            float vx = vertices[i * vertexStride], vy = vertices[i * vertexStride + 1];
+            params.push_back(vx);
+            params.push_back(vy);
+            radius = std::max(radius, std::hypot(vx, vy));
+        }
+
+        for (size_t i = 0; i < placementCount; ++i) {
+            const float* placement = placements + i * placementStride;
+            float x = placement[0], y = placement[1], rotation = placement[2], scale = placement[3];
+            if (scale == 0.0f) continue;
+
+            float extent = radius * std::abs(scale);
+            float* p = addPrimitive(Shape::INSTANCE, firstId + i, 5, x - extent, y - extent, x + extent, y + extent);
+            p[0] = x;
+            p[1] = y;
+            p[2] = std::cos(rotation);
+            p[3] = std::sin(rotation);
+            p[4] = scale;
+            primitives.back().count = static_cast<uint32_t>(vertexCount);
+            primitives.back().shared = shared;
+        }
+    }
+
+    void HitIndex::clear() {
+        primitives.clear();
+        params.clear();
+        boxes.clear();
+        nodeIndices.clear();
+        levelEnds.clear();
+        built = false;
+    }
+
+    void HitIndex::build() {
+        built = true;
+        boxes.clear();
+        nodeIndices.clear();
+        levelEnds.clear();
+        size_t count = primitives.size();
+        if (count == 0) return;
+
+        // Level sizes: each node groups up to NODE_SIZE nodes of the level below
+        size_t total = count;
+        size_t levelSize = count;
+        levelEnds.push_back(total);
+        do {
+            levelSize = (levelSize + NODE_SIZE - 1) / NODE_SIZE;
+            total += levelSize;
+            levelEnds.push_back(total);
+        } while (levelSize > 1);
+
+        boxes.resize(total * 4);
+        nodeIndices.resize(total);
+
+        // Leaves in Hilbert order of their box centers, so nodes group near boxes
+        float minX = std::numeric_limits<float>::max(), minY = minX;
+        float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+        for (const Primitive& primitive : primitives) {
+            minX = std::min(minX, primitive.minX);
+            minY = std::min(minY, primitive.minY);
+            maxX = std::max(maxX, primitive.maxX);
+            maxY = std::max(maxY, primitive.maxY);
+        }
+        float scaleX = maxX > minX ? 65535.0f / (maxX - minX) : 0.0f;
+        float scaleY = maxY > minY ? 65535.0f / (maxY - minY) : 0.0f;
+
+        std::vector<std::pair<uint32_t, uint32_t>> order(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Primitive& primitive = primitives[i];
+            float centerX = (primitive.minX + primitive.maxX) * 0.5f;
+            float centerY = (primitive.minY + primitive.maxY) * 0.5f;
+            uint32_t hx = static_cast<uint32_t>((centerX - minX) * scaleX);
+            uint32_t hy = static_cast<uint32_t>((centerY - minY) * scaleY);
+            order[i] = std::make_pair(hilbert(std::min(hx, 65535u), std::min(hy, 65535u)), static_cast<uint32_t>(i));
+        }
+        std::sort(order.begin(), order.end());
+
+        for (size_t i = 0; i < count; ++i) {
+            const Primitive& primitive = primitives[order[i].second];
+            float* box = &boxes[i * 4];
+            box[0] = primitive.minX;
+            box[1] = primitive.minY;
+            box[2] = primitive.maxX;
+            box[3] = primitive.maxY;
+            nodeIndices[i] = order[i].second;
+        }
+
+        // Each parent covers its children and points at the first of them
+        size_t parent = count;
+        size_t position = 0;
+        for (size_t level = 0; level + 1 < levelEnds.size(); ++level) {
+            size_t end = levelEnds[level];
+            while (position < end) {
+                size_t first = position;
+                float nodeMinX = boxes[position * 4], nodeMinY = boxes[position * 4 + 1];
+                float nodeMaxX = boxes[position * 4 + 2], nodeMaxY = boxes[position * 4 + 3];
+                for (size_t j = 0; j < NODE_SIZE && position < end; ++j, ++position) {
+                    const float* box = &boxes[position * 4];
+                    nodeMinX = std::min(nodeMinX, box[0]);
+                    nodeMinY = std::min(nodeMinY, box[1]);
+                    nodeMaxX = std::max(nodeMaxX, box[2]);
+                    nodeMaxY = std::max(nodeMaxY, box[3]);
+                }
+                float* box = &boxes[parent * 4];
+                box[0] = nodeMinX;
+                box[1] = nodeMinY;
+                box[2] = nodeMaxX;
+                box[3] = nodeMaxY;
+                nodeIndices[parent] = static_cast<uint32_t>(first);
+                ++parent;
+            }
+        }
+    }
+
+    template <typename Test>
+    void HitIndex::search(const Rect& rect, Test test) {
+        if (!built) build();
+        hits.clear();
+        if (primitives.empty()) return;
+
+        size_t leafCount = primitives.size();
+        size_t node = boxes.size() / 4 - 1;     // The root
+        stack.clear();
+        while (true) {
+            // `node` starts a group of siblings, which ends with the group or the level
+            size_t levelEnd = *std::upper_bound(levelEnds.begin(), levelEnds.end(), node);
+            size_t end = std::min(node + NODE_SIZE, levelEnd);
+            for (size_t position = node; position < end; ++position) {
+                const float* box = &boxes[position * 4];
+                if (rect.maxX < box[0] || rect.maxY < box[1] || rect.minX > box[2] || rect.minY > box[3]) continue;
+
+                uint32_t index = nodeIndices[position];
+                if (position >= leafCount) {
+                    stack.push_back(index);
+                } else if (test(primitives[index])) {
+                    hits.push_back(index);
+                }
+            }
+            if (stack.empty()) break;
+            node = stack.back();
+            stack.pop_back();
+        }
+    }
+
+    void HitIndex::queryPoint(float x, float y, std::vector<Id>& results, float tolerance) {
+        tolerance = std::max(tolerance, 0.0f);
+        Rect rect = {x - tolerance, y - tolerance, x + tolerance, y + tolerance};
+        search(rect, [&](const Primitive& primitive) {
+            return distance(primitive, x, y) <= tolerance;
+        });
+        collectIds(results);
+    }
+
+    void HitIndex::queryRect(float x, float y, float w, float h, std::vector<Id>& results) {
+        Rect rect = {std::min(x, x + w), std::min(y, y + h), std::max(x, x + w), std::max(y, y + h)};
+        search(rect, [&](const Primitive& primitive) {
+            return overlaps(primitive, rect);
+        });
+        collectIds(results);
+    }
+
+    void HitIndex::collectIds(std::vector<Id>& results) {
+        // Drawing order, each id at its topmost primitive
+        topmost.clear();
+        for (uint32_t index : hits) {
+            topmost.push_back(std::make_pair(primitives[index].id, index));
+        }
+        std::sort(topmost.begin(), topmost.end(), [](const std::pair<Id, uint32_t>& a, const std::pair<Id, uint32_t>& b) {
+            return a.first != b.first ? a.first < b.first : a.second > b.second;
+        });
+        topmost.erase(std::unique(topmost.begin(), topmost.end(), [](const std::pair<Id, uint32_t>& a, const std::pair<Id, uint32_t>& b) {
+            return a.first == b.first;
+        }), topmost.end());
+        std::sort(topmost.begin(), topmost.end(), [](const std::pair<Id, uint32_t>& a, const std::pair<Id, uint32_t>& b) {
+            return a.second < b.second;
+        });
+
+        results.clear();
+        for (const std::pair<Id, uint32_t>& entry : topmost) {
+            results.push_back(entry.first);
+        }
+    }
+
+    float HitIndex::distance(const Primitive& primitive, float x, float y) const {
+        const float* p = &params[primitive.params];
+        switch (primitive.shape) {
+            case Shape::RADIAL: {
+                float dx = x - p[0], dy = y - p[1];
+                float radius = std::hypot(dx, dy);
+                float ring = std::max(p[2] - radius, radius - p[3]);
+                if (p[5] >= TWO_PI) return ring;
+
+                if (angleInSpan(dx, dy, p[4], p[5])) return ring;
+
+                // Outside the span: the nearest end, a cap or a straight edge
+                float best = std::numeric_limits<float>::max();
+                const float ends[2] = {p[4], p[4] + p[5]};
+                for (float angle : ends) {
+                    float c = std::cos(angle), s = std::sin(angle);
+                    if (p[6] > 0.0f) {
+                        float middle = (p[2] + p[3]) * 0.5f;
+                        float capRadius = (p[3] - p[2]) * 0.5f;
+                        best = std::min(best, std::hypot(dx - c * middle, dy - s * middle) - capRadius);
+                    } else {
+                        best = std::min(best, segmentDistance(dx, dy, c * p[2], s * p[2], c * p[3], s * p[3]));
+                    }
+                }
+                return best;
+            }
+            case Shape::ROUNDED_RECT: {
+                float halfW = p[2] * 0.5f, halfH = p[3] * 0.5f;
+                return roundedBoxDistance(x - p[0] - halfW, y - p[1] - halfH, halfW, halfH, p + 4);
+            }
+            case Shape::SEGMENT:
+                return segmentDistance(x, y, p[0], p[1], p[2], p[3]) - p[4];
+            case Shape::POLYGON:
+                return polygonDistance(p, primitive.count, x, y);
+            case Shape::INSTANCE: {
+                // Into shape units: undo the move, the rotation and the scale
+                float dx = x - p[0], dy = y - p[1];
+                float localX = (dx * p[2] + dy * p[3]) / p[4];
+                float localY = (dy * p[2] - dx * p[3]) / p[4];
+                const float* triangles = &params[primitive.shared];
+                float best = std::numeric_limits<float>::max();
+                for (uint32_t i = 0; i < primitive.count; i += 3) {
+                    best = std::min(best, polygonDistance(triangles + i * 2, 3, localX, localY));
+                    if (best < 0.0f) return best;
+                }
+                return best * std::abs(p[4]);
+            }
+        }
+        return std::numeric_limits<float>::max();
+    }
+
+    bool HitIndex::overlaps(const Primitive& primitive, const Rect& rect) const {
+        const float* p = &params[primitive.params];
+        switch (primitive.shape) {
+            case Shape::RADIAL: {
+                if (p[5] >= TWO_PI) {
+                    // A full ring: some point of the rect lies between the radii
+                    float nearest = rectDistance(p[0], p[1], rect.minX, rect.minY, rect.maxX, rect.maxY);
+                    float farX = std::max(std::abs(rect.minX - p[0]), std::abs(rect.maxX - p[0]));
+                    float farY = std::max(std::abs(rect.minY - p[1]), std::abs(rect.maxY - p[1]));
+                    return nearest <= p[3] && std::hypot(farX, farY) >= p[2];
+                }
+
+                // A partial sector overlaps the rect if a corner of the rect is
+                // inside it, or if their boundaries cross: a straight edge of
+                // the sector through the rect (which also covers an arc wholly
+                // inside it) or an arc across a side of the rect
+                float minX = rect.minX - p[0], minY = rect.minY - p[1];
+                float maxX = rect.maxX - p[0], maxY = rect.maxY - p[1];
+                const float corners[8] = {minX, minY, maxX, minY, maxX, maxY, minX, maxY};
+                for (int i = 0; i < 4; ++i) {
+                    float cx = corners[i * 2], cy = corners[i * 2 + 1];
+                    float radius = std::hypot(cx, cy);
+                    if (radius >= p[2] && radius <= p[3] && angleInSpan(cx, cy, p[4], p[5])) return true;
+                }
+                const float ends[2] = {p[4], p[4] + p[5]};
+                for (float angle : ends) {
+                    float c = std::cos(angle), s = std::sin(angle);
+                    if (segmentIntersectsRect(c * p[2], s * p[2], c * p[3], s * p[3], minX, minY, maxX, maxY)) {
+                        return true;
+                    }
+                }
+                if (arcCrossesRect(p[3], p[4], p[5], minX, minY, maxX, maxY) ||
+                    (p[2] > 0.0f && arcCrossesRect(p[2], p[4], p[5], minX, minY, maxX, maxY))) {
+                    return true;
+                }
+                if (p[6] > 0.0f) {
+                    float middle = (p[2] + p[3]) * 0.5f;
+                    float capRadius = (p[3] - p[2]) * 0.5f;
+                    for (float angle : ends) {
+                        if (rectDistance(p[0] + std::cos(angle) * middle, p[1] + std::sin(angle) * middle,
+                                         rect.minX, rect.minY, rect.maxX, rect.maxY) <= capRadius) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+            case Shape::ROUNDED_RECT: {
+                // Moving a point of the shape towards the center, one axis at a
+                // time, keeps it inside, so the point of the overlap nearest
+                // the center decides
+                float minX = std::max(rect.minX, primitive.minX), maxX = std::min(rect.maxX, primitive.maxX);
+                float minY = std::max(rect.minY, primitive.minY), maxY = std::min(rect.maxY, primitive.maxY);
+                if (minX > maxX || minY > maxY) return false;
+                float halfW = p[2] * 0.5f, halfH = p[3] * 0.5f;
+                float centerX = p[0] + halfW, centerY = p[1] + halfH;
+                float nearestX = std::min(std::max(centerX, minX), maxX);
+                float nearestY = std::min(std::max(centerY, minY), maxY);
+                return roundedBoxDistance(nearestX - centerX, nearestY - centerY, halfW, halfH, p + 4) <= 0.0f;
+            }
+            case Shape::SEGMENT:
+                return segmentRectDistance(p[0], p[1], p[2], p[3], rect.minX, rect.minY, rect.maxX, rect.maxY) <= p[4];
+            case Shape::POLYGON:
+                return polygonOverlapsRect(p, primitive.count, rect.minX, rect.minY, rect.maxX, rect.maxY);
+            case Shape::INSTANCE: {
+                const float* triangles = &params[primitive.shared];
+                float cosScale = p[2] * p[4], sinScale = p[3] * p[4];
+                for (uint32_t i = 0; i < primitive.count; i += 3) {
+                    float world[6];
+                    for (int v = 0; v < 3; ++v) {
+                        float vx = triangles[(i + v) * 2], vy = triangles[(i + v) * 2 + 1];
+                        world[v * 2] = p[0] + vx * cosScale - vy * sinScale;
+                        world[v * 2 + 1] = p[1] + vx * sinScale + vy * cosScale;
+                    }
+                    if (polygonOverlapsRect(world, 3, rect.minX, rect.minY, rect.maxX, rect.maxY)) return true;
+                }
+                return false;
+            }
+        }
+        return false;
+    }
+} // namespace cridgeon
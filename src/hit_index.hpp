@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cridgeon
+{
+    // Spatial index of drawn primitives for hover and click picking. Shapes
+    // are recorded with their exact geometry, directly or by the Render::
+    // functions while the index is set with Render::setHitIndex(). The first
+    // query after recording bulk-loads a packed R-tree: the boxes are sorted
+    // along a Hilbert curve and grouped NODE_SIZE to a node, level by level,
+    // into flat arrays. Candidates found in the tree are confirmed with exact
+    // tests against the shape. Clear and record again every frame.
+    class HitIndex {
+    public:
+        using Id = uint64_t;
+
+        HitIndex();
+
+        // Annulus sector, as drawn by Render::appendRadialShape
+        void addRadial(Id id, float x, float y, float innerRadius, float outerRadius,
+                       float startAngle, float span, bool roundCaps);
+
+        // Per-corner radii are ordered bottom-left, bottom-right, top-right, top-left
+        void addRoundedRect(Id id, float x, float y, float w, float h, const float radii[4]);
+        void addBox(Id id, float x, float y, float w, float h);
+
+        // Line segment with round ends
+        void addSegment(Id id, float x0, float y0, float x1, float y1, float width);
+
+        // Filled polygon (nonzero winding); `vertices` holds x, y pairs
+        void addPolygon(Id id, const float* vertices, size_t pointCount);
+
+        // Triangles stamped at several placements, as drawn by ShapePrototype.
+        // `vertices` holds x, y every `vertexStride` floats; each placement is
+        // x, y, rotation (radians), scale every `placementStride` floats.
+        // Placement i gets the id firstId + i.
+        void addTriangleInstances(Id firstId, const float* vertices, size_t vertexCount, size_t vertexStride,
+                                  const float* placements, size_t placementCount, size_t placementStride);
+
+        // Drop every primitive, e.g. at the start of a frame
+        void clear();
+
+        // Ids of the primitives containing the point, or closer than
+        // `tolerance` pixels to it, in drawing order: the last one is on top.
+        // An id recorded as several primitives is listed once, at the
+        // position of its topmost primitive.
+        void queryPoint(float x, float y, std::vector<Id>& results, float tolerance = 0.0f);
+
+        // Ids of the primitives overlapping the rectangle ((x, y) is the
+        // bottom-left corner), ordered like queryPoint()
+        void queryRect(float x, float y, float w, float h, std::vector<Id>& results);
+
+        size_t getPrimitiveCount() const { return primitives.size(); }
+
+        // Bulk-load the tree now instead of on the first query
+        void build();
+
+    private:
+        static const size_t NODE_SIZE = 16;
+
+        enum class Shape : uint8_t {
+            RADIAL,
+            ROUNDED_RECT,
+            SEGMENT,
+            POLYGON,
+            INSTANCE
+        };
+
+        struct Primitive {
+            Shape shape;
+            uint32_t params;        // Offset into params
+            uint32_t count;         // Polygon points, instance triangle vertices
+            uint32_t shared;        // Instances: offset of the triangles in params
+            Id id;
+            float minX, minY, maxX, maxY;
+        };
+
+        struct Rect {
+            float minX, minY, maxX, maxY;
+        };
+
+        std::vector<Primitive> primitives;
+        std::vector<float> params;
+
+        // Packed tree: the leaves in Hilbert order, then each level up to the root
+        std::vector<float> boxes;               // minX, minY, maxX, maxY per node
+        std::vector<uint32_t> nodeIndices;      // Leaves: primitive; others: first child
+        std::vector<size_t> levelEnds;          // One past the last node of each level
+        bool built;
+
+        // Query scratch
+        std::vector<size_t> stack;
+        std::vector<uint32_t> hits;
+        std::vector<std::pair<Id, uint32_t>> topmost;
+
+        float* addPrimitive(Shape shape, Id id, size_t floatCount, float minX, float minY, float maxX, float maxY);
+
+        // Collect the primitives whose boxes overlap the rectangle and pass the test
+        template <typename Test>
+        void search(const Rect& rect, Test test);
+
+        // Signed distance from the primitive's edge, negative inside
+        float distance(const Primitive& primitive, float x, float y) const;
+        bool overlaps(const Primitive& primitive, const Rect& rect) const;
+
+        void collectIds(std::vector<Id>& results);
+    };
+} // namespace cridgeon
@@ -0,0 +1,123 @@
+#include "layer.hpp"
+#include "framebuffer_pool.hpp"
+#include "rendering_system.hpp"
+#include "shader/batch.hpp"
+#include "shader/geometry/texture_quad.hpp"
+
+#include <glad/gl.h>
+
+namespace cridgeon
+{
+    Layer::Layer()
+        : framebuffer(nullptr), contentValid(false), reused(false),
+          viewOffsetX(0.0f), viewOffsetY(0.0f), viewScale(1.0f) {}
+
+    Layer::Layer(DrawFunction draw) : Layer() {
+        drawFunction = std::move(draw);
+    }
+
+    Layer::~Layer() {
+        release();
+    }
+
+    void Layer::setDrawFunction(DrawFunction draw) {
+        drawFunction = std::move(draw);
+        contentValid = false;
+    }
+
+    void Layer::setView(float offsetX, float offsetY, float scale) {
+        if (offsetX == viewOffsetX && offsetY == viewOffsetY && scale == viewScale) return;
+        viewOffsetX = offsetX;
+        viewOffsetY = offsetY;
+        viewScale = scale;
+        contentValid = false;
+    }
+
+    // Source and destination factors for color, then for alpha
+    static void getBlendFunc(GLint blendFunc[4]) {
+        glGetIntegerv(GL_BLEND_SRC_RGB, &blendFunc[0]);
+        glGetIntegerv(GL_BLEND_DST_RGB, &blendFunc[1]);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendFunc[2]);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &blendFunc[3]);
+    }
+
+    void Layer::redraw() {
+        // Layers may be drawn while another target (e.g. the post-processor's) is bound
+        GLint previousFramebuffer = 0;
+        GLint previousViewport[4];
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+        framebuffer->bind();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // Keep the target's alpha as coverage and its color premultiplied,
+        // so compositing over the scene matches drawing directly
+        GLint blendFunc[4];
+        getBlendFunc(blendFunc);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        drawFunction();
+        Render::flushBatches();
+        glBlendFuncSeparate(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+        contentValid = true;
+    }
+
+    void Layer::render(float opacity) {
+        reused = false;
+        if (!drawFunction) return;
+
+        auto& rs = RenderingSystem::getInstance();
+        int width = rs.getWindowWidth();
+        int height = rs.getWindowHeight();
+        if (width <= 0 || height <= 0) return;
+
+        // The software rasterizer redraws everything each frame; there is no
+        // cached target to composite, so opacity is not applied
+        if (rs.getBackend() == RenderBackend::SOFTWARE) {
+            release();
+            drawFunction();
+            return;
+        }
+
+        if (framebuffer && (framebuffer->getWidth() != width || framebuffer->getHeight() != height)) {
+            release();
+        }
+        if (!framebuffer) {
+            FramebufferSpec spec;
+            spec.alpha = true;
+            spec.depth = false;
+            framebuffer = FramebufferPool::getInstance().acquire(width, height, spec);
+            if (!framebuffer) return;
+            contentValid = false;
+        }
+
+        if (!contentValid) {
+            Render::flushBatches();
+            redraw();
+        } else {
+            reused = true;
+        }
+
+        // The content is premultiplied, so it is composited with ONE, ONE_MINUS_SRC_ALPHA
+        Render::flushBatches();
+        GLint blendFunc[4];
+        getBlendFunc(blendFunc);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        Render::textureQuad(framebuffer->getColorTexture(), 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height),
+                            0.0f, 0.0f, 1.0f, 1.0f, opacity, opacity, opacity, opacity);
+        Render::flushBatches();
+        glBlendFuncSeparate(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+    }
+
+    void Layer::release() {
+        if (framebuffer) {
+            FramebufferPool::getInstance().release(framebuffer);
+            framebuffer = nullptr;
+        }
+        contentValid = false;
+    }
+} // namespace cridgeon
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "framebuffer.hpp"
+
+#include <functional>
+
+namespace cridgeon
+{
+    // Cached render layer. The draw function renders the layer's content
+    // into a pooled, window-sized RGBA framebuffer; later frames composite
+    // that texture with a single blended quad until the layer is invalidated,
+    // its view changes or the window is resized.
+    class Layer {
+    public:
+        using DrawFunction = std::function<void()>;
+
+        Layer();
+        explicit Layer(DrawFunction draw);
+        ~Layer();
+
+        // Disable copy constructor and assignment operator
+        Layer(const Layer&) = delete;
+        Layer& operator=(const Layer&) = delete;
+
+        void setDrawFunction(DrawFunction draw);
+
+        // View the draw function renders with; changing it invalidates the cache.
+        // The layer does not apply the view itself.
+        void setView(float offsetX, float offsetY, float scale);
+
+        // Force the next render() to redraw the content
+        void invalidate() { contentValid = false; }
+
+        // Redraw the content if needed, then composite it
+        void render(float opacity = 1.0f);
+
+        // Check whether the last render() reused the cached content
+        bool wasReused() const { return reused; }
+
+        // Return the framebuffer to the pool; the next render() redraws
+        void release();
+
+    private:
+        DrawFunction drawFunction;
+        Framebuffer* framebuffer;
+        bool contentValid;
+        bool reused;
+        float viewOffsetX, viewOffsetY, viewScale;
+
+        void redraw();
+    };
+} // namespace cridgeon
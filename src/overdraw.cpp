@@ -0,0 +1,199 @@
+#include "overdraw.hpp"
+#include "shader/utility.hpp"
+#include "software/rasterizer.hpp"
+
+#include <algorithm>
+
+namespace cridgeon
+{
+    // Mip levels are reduced until the longer edge has at most this many tiles
+    static const int MAX_TILES_PER_EDGE = 32;
+
+    OverdrawCounter::OverdrawCounter()
+        : countTexture(0), pixelBuffer(0), queries{0, 0}, queryIndex(0), queryPending{false, false},
+          tileBuffers{0, 0}, tileLevels{0, 0}, tileIndex(0), tilePending{false, false},
+          width(0), height(0), heatmapScale(8.0f) {}
+
+    OverdrawCounter::~OverdrawCounter() {
+        destroy();
+    }
+
+    bool OverdrawCounter::resize(int newWidth, int newHeight) {
+        if (countTexture != 0 && newWidth == width && newHeight == height) return true;
+        width = newWidth;
+        height = newHeight;
+        // Pending tiles were reduced from the old size
+        tilePending[0] = tilePending[1] = false;
+
+        if (countTexture == 0) glGenTextures(1, &countTexture);
+        glBindTexture(GL_TEXTURE_2D, countTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (pixelBuffer == 0) glGenBuffers(1, &pixelBuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height, nullptr, GL_STREAM_COPY);
+
+        if (tileBuffers[0] == 0) {
+            glGenBuffers(2, tileBuffers);
+            for (unsigned int buffer : tileBuffers) {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+                glBufferData(GL_PIXEL_PACK_BUFFER, MAX_TILES_PER_EDGE * MAX_TILES_PER_EDGE * sizeof(float),
+                             nullptr, GL_STREAM_READ);
+            }
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return true;
+    }
+
+    void OverdrawCounter::begin() {
+        if (queries[0] == 0) glGenQueries(2, queries);
+
+        // Results are read a frame late so the query never stalls the pipeline
+        int previous = queryIndex ^ 1;
+        if (queryPending[previous]) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries[previous], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint samples = 0;
+                glGetQueryObjectuiv(queries[previous], GL_QUERY_RESULT, &samples);
+                stats.samplesPassed = samples;
+                queryPending[previous] = false;
+            }
+        }
+        glBeginQuery(GL_SAMPLES_PASSED, queries[queryIndex]);
+
+        glEnable(GL_STENCIL_TEST);
+        glStencilMask(0xFF);
+        glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+    }
+
+    void OverdrawCounter::end(int frameWidth, int frameHeight, bool drawHeatmap) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        queryPending[queryIndex] = true;
+        queryIndex ^= 1;
+
+        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        glDisable(GL_STENCIL_TEST);
+        if (frameWidth <= 0 || frameHeight <= 0) return;
+        resize(frameWidth, frameHeight);
+
+        // Stencil -> pixel buffer -> texture stays on the GPU; the unsigned
+        // bytes are normalized on upload, so the texture holds count / 255
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+        glReadPixels(0, 0, width, height, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        glBindTexture(GL_TEXTURE_2D, countTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glGenerateMipmap(GL_TEXTURE_2D);
+        readTiles();
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (!drawHeatmap) return;
+
+        if (!heatmapShader.isValid() &&
+            !heatmapShader.loadFromFile("resources/shaders/default.vert", "resources/shaders/debug/overdraw_heatmap.frag",
+                                        {"position"})) {
+            std::cerr << "Failed to load overdraw heatmap shader" << std::endl;
+            return;
+        }
+
+        heatmapShader.use();
+        glUniform2f(heatmapShader.getUniformLocation("resolution"), static_cast<float>(width), static_cast<float>(height));
+        glUniform4f(heatmapShader.getUniformLocation("rect"), 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+        glUniform1f(heatmapShader.getUniformLocation("maxCount"), heatmapScale);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, countTexture);
+        glUniform1i(heatmapShader.getUniformLocation("counts"), 0);
+
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_BLEND);
+        ShaderUtility::drawFullScreenQuad();
+        if (blend) glEnable(GL_BLEND);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void OverdrawCounter::readTiles() {
+        // The tiles requested last frame have arrived by now; like the query,
+        // the stats are a frame late so mapping them does not wait on the GPU
+        int previous = tileIndex ^ 1;
+        if (tilePending[previous]) {
+            int level = tileLevels[previous];
+            int tilesX = std::max(1, width >> level);
+            int tilesY = std::max(1, height >> level);
+            size_t count = static_cast<size_t>(tilesX) * tilesY;
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, tileBuffers[previous]);
+            const float* tiles = static_cast<const float*>(
+                glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(count * sizeof(float)), GL_MAP_READ_BIT));
+            if (tiles) {
+                double sum = 0.0;
+                size_t hottest = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    sum += tiles[i];
+                    if (tiles[i] > tiles[hottest]) hottest = i;
+                }
+
+                stats.valid = true;
+                stats.fragmentsPerPixel = static_cast<float>(sum / count * 255.0);
+                stats.maxTileFragmentsPerPixel = tiles[hottest] * 255.0f;
+                stats.tileSize = 1 << level;
+                stats.hotTileX = static_cast<int>(hottest % tilesX) * stats.tileSize;
+                stats.hotTileY = static_cast<int>(hottest / tilesX) * stats.tileSize;
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            tilePending[previous] = false;
+        }
+
+        int level = 0;
+        while (std::max(width >> level, height >> level) > MAX_TILES_PER_EDGE) {
+            ++level;
+        }
+
+        // The copy into the buffer is queued behind the mipmap generation
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, tileBuffers[tileIndex]);
+        glGetTexImage(GL_TEXTURE_2D, level, GL_RED, GL_FLOAT, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        tileLevels[tileIndex] = level;
+        tilePending[tileIndex] = true;
+        tileIndex ^= 1;
+    }
+
+    void OverdrawCounter::destroy() {
+        heatmapShader.destroy();
+        if (countTexture != 0) {
+            SoftwareRasterizer::getInstance().forgetTexture(countTexture);
+            glDeleteTextures(1, &countTexture);
+            countTexture = 0;
+        }
+        if (pixelBuffer != 0) {
+            glDeleteBuffers(1, &pixelBuffer);
+            pixelBuffer = 0;
+        }
+        if (tileBuffers[0] != 0) {
+            glDeleteBuffers(2, tileBuffers);
+            tileBuffers[0] = tileBuffers[1] = 0;
+        }
+        tilePending[0] = tilePending[1] = false;
+        if (queries[0] != 0) {
+            glDeleteQueries(2, queries);
+            queries[0] = queries[1] = 0;
+        }
+        queryPending[0] = queryPending[1] = false;
+        width = height = 0;
+        stats = OverdrawStats();
+    }
+} // namespace cridgeon
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "shader/shader.hpp"
+
+#include <cstdint>
+
+namespace cridgeon
+{
+    enum class OverdrawMode {
+        OFF,
+        STATS,      // Count fragments and fill the stats, keep the image
+        HEATMAP     // Also replace the image with a heatmap of the counts
+    };
+
+    struct OverdrawStats {
+        bool valid = false;
+
+        // Fragments that passed all tests during the previous frame, on every
+        // render target (GL_SAMPLES_PASSED)
+        uint64_t samplesPassed = 0;
+
+        // Fragments per window pixel, counted with the stencil buffer. Only
+        // drawing to the window is counted; offscreen targets show up as the
+        // quad that composites them
+        float fragmentsPerPixel = 0.0f;
+
+        // The tile with the highest average count
+        float maxTileFragmentsPerPixel = 0.0f;
+        int hotTileX = 0, hotTileY = 0;     // Pixel origin of the tile (y up)
+        int tileSize = 0;                   // Tile edge in pixels
+    };
+
+    // Fill-rate instrumentation for the window framebuffer. Every fragment
+    // drawn increments the window's stencil (saturating at 255). At the end
+    // of the frame the counts are copied through a pixel buffer into a float
+    // texture without a CPU round trip, reduced with mipmaps, and only a
+    // small mip level is read back, through a pixel buffer mapped a frame
+    // later so the readback never stalls; the tile stats lag one frame.
+    // Used by RenderingSystem.
+    class OverdrawCounter {
+    public:
+        OverdrawCounter();
+        ~OverdrawCounter();
+
+        // Disable copy constructor and assignment operator
+        OverdrawCounter(const OverdrawCounter&) = delete;
+        OverdrawCounter& operator=(const OverdrawCounter&) = delete;
+
+        // Start counting; the window's stencil must have been cleared to 0
+        void begin();
+
+        // Stop counting and compute the stats; with `drawHeatmap` the window
+        // is overwritten with the heatmap. The window framebuffer must be bound.
+        void end(int width, int height, bool drawHeatmap);
+
+        const OverdrawStats& getStats() const { return stats; }
+
+        // Count mapped to the hot end of the heatmap ramp
+        void setHeatmapScale(float maxCount) { heatmapScale = maxCount; }
+
+        void destroy();
+
+    private:
+        Shader heatmapShader;
+        unsigned int countTexture;
+        unsigned int pixelBuffer;
+        unsigned int queries[2];
+        int queryIndex;
+        bool queryPending[2];
+        unsigned int tileBuffers[2];    // Tile readbacks, mapped a frame after they are issued
+        int tileLevels[2];
+        int tileIndex;
+        bool tilePending[2];
+        int width, height;
+        float heatmapScale;
+        OverdrawStats stats;
+
+        bool resize(int newWidth, int newHeight);
+        void readTiles();
+    };
+} // namespace cridgeon
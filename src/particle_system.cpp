@@ -0,0 +1,245 @@
+#include "particle_system.hpp"
+#include "rendering_system.hpp"
+#include "gl_capabilities.hpp"
+#include "shader/batch.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <glad/gl.h>
+
+// Compatibility-profile token, left out of core headers; GL 3.0-3.1 contexts
+// only give gl_PointCoord a value with it enabled
+#ifndef GL_POINT_SPRITE
+#define GL_POINT_SPRITE 0x8861
+#endif
+
+namespace cridgeon
+{
+    // position (2), velocity (2), age + lifetime (2)
+    static const int PARTICLE_FLOATS = 6;
+    static const GLsizei PARTICLE_STRIDE = PARTICLE_FLOATS * sizeof(float);
+
+    ParticleSystem::ParticleSystem()
+        : pointSprites(false), buffers{0, 0}, simulateVAO{0, 0}, renderVAO{0, 0}, quadVBO(0),
+          current(0), capacity(0), spawnCursor(0), spawnAccumulator(0.0f), pendingBurst(0), time(0.0f) {}
+
+    ParticleSystem::~ParticleSystem() {
+        destroy();
+    }
+
+    bool ParticleSystem::create(int particleCapacity) {
+        if (particleCapacity <= 0) return false;
+        destroy();
+
+        capacity = particleCapacity;
+        spawnCursor = 0;
+        spawnAccumulator = 0.0f;
+        pendingBurst = 0;
+        time = 0.0f;
+        current = 0;
+
+        if (!simulateShader.isValid()) {
+            simulateShader.loadFeedbackFromFile("resources/shaders/particles/simulate.vert",
+                                                {"outPosition", "outVelocity", "outAgeLife"},
+                                                {"position", "velocity", "ageLife"});
+            if (!simulateShader.isValid()) {
+                std::cerr << "Failed to load particle simulation shader" << std::endl;
+                return false;
+            }
+        }
+
+        // Instanced quads need glVertexAttribDivisor (GL 3.3); older contexts draw point sprites
+        pointSprites = !glCapabilities().instancedArrays;
+        if (!renderShader.isValid()) {
+            if (pointSprites) {
+                renderShader.loadFromFile("resources/shaders/particles/particle_point.vert", "resources/shaders/particles/particle.frag",
+                                          {"particlePosition", "particleVelocity", "particleAgeLife"});
+            } else {
+                renderShader.loadFromFile("resources/shaders/particles/particle.vert", "resources/shaders/particles/particle.frag",
+                                          {"corner", "particlePosition", "particleVelocity", "particleAgeLife"});
+            }
+            if (!renderShader.isValid()) {
+                std::cerr << "Failed to load particle render shader" << std::endl;
+                return false;
+            }
+        }
+
+        // Every particle starts dead (age >= lifetime)
+        std::vector<float> initial(static_cast<size_t>(capacity) * PARTICLE_FLOATS, 0.0f);
+        for (int i = 0; i < capacity; ++i) {
+            initial[i * PARTICLE_FLOATS + 4] = 1.0f;
+        }
+
+        glGenBuffers(2, buffers);
+        for (int i = 0; i < 2; ++i) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            glBufferData(GL_ARRAY_BUFFER, initial.size() * sizeof(float), initial.data(), GL_DYNAMIC_COPY);
+        }
+
+        if (!pointSprites) {
+            float corners[] = {
+                -1.0f, -1.0f,
+                 1.0f, -1.0f,
+                -1.0f,  1.0f,
+                 1.0f,  1.0f
+            };
+            glGenBuffers(1, &quadVBO);
+            glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        setupVertexArrays();
+        return true;
+    }
+
+    void ParticleSystem::setupVertexArrays() {
+        glGenVertexArrays(2, simulateVAO);
+        glGenVertexArrays(2, renderVAO);
+
+        for (int i = 0; i < 2; ++i) {
+            // Simulation reads buffer i
+            glBindVertexArray(simulateVAO[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            for (unsigned int a = 0; a < 3; ++a) {
+                glVertexAttribPointer(a, 2, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, (void*)(a * 2 * sizeof(float)));
+                glEnableVertexAttribArray(a);
+            }
+
+            // Rendering reads buffer i, one particle per instance (or per point)
+            glBindVertexArray(renderVAO[i]);
+            unsigned int first = 0;
+            if (!pointSprites) {
+                glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+                glEnableVertexAttribArray(0);
+                first = 1;
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            for (unsigned int a = 0; a < 3; ++a) {
+                glVertexAttribPointer(first + a, 2, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, (void*)(a * 2 * sizeof(float)));
+                glEnableVertexAttribArray(first + a);
+                if (!pointSprites) {
+                    glVertexAttribDivisor(first + a, 1);
+                }
+            }
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void ParticleSystem::burst(int count) {
+        pendingBurst += std::max(0, count);
+    }
+
+    void ParticleSystem::update(float dt) {
+        if (!isValid() || dt <= 0.0f) return;
+
+        time += dt;
+        spawnAccumulator += emitterParams.rate * dt;
+        int spawnCount = static_cast<int>(spawnAccumulator) + pendingBurst;
+        spawnAccumulator -= static_cast<int>(spawnAccumulator);
+        pendingBurst = 0;
+        spawnCount = std::min(spawnCount, capacity);
+
+        const Emitter& e = emitterParams;
+        simulateShader.use();
+        glUniform1f(simulateShader.getUniformLocation("dt"), dt);
+        glUniform1f(simulateShader.getUniformLocation("time"), time);
+        glUniform1i(simulateShader.getUniformLocation("capacity"), capacity);
+        glUniform1i(simulateShader.getUniformLocation("spawnStart"), spawnCursor);
+        glUniform1i(simulateShader.getUniformLocation("spawnCount"), spawnCount);
+        glUniform2f(simulateShader.getUniformLocation("emitterPosition"), e.x, e.y);
+        glUniform1f(simulateShader.getUniformLocation("emitterRadius"), e.radius);
+        glUniform1f(simulateShader.getUniformLocation("direction"), e.direction);
+        glUniform1f(simulateShader.getUniformLocation("spread"), e.spread);
+        glUniform2f(simulateShader.getUniformLocation("speedRange"), e.speedMin, e.speedMax);
+        glUniform2f(simulateShader.getUniformLocation("lifeRange"), e.lifeMin, e.lifeMax);
+        glUniform2f(simulateShader.getUniformLocation("gravity"), e.gravityX, e.gravityY);
+        glUniform1f(simulateShader.getUniformLocation("drag"), e.drag);
+
+        spawnCursor = (spawnCursor + spawnCount) % capacity;
+
+        // Read the current state, capture the next one into the other buffer
+        int next = 1 - current;
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBindVertexArray(simulateVAO[current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[next]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, capacity);
+        glEndTransformFeedback();
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        current = next;
+    }
+
+    void ParticleSystem::render() {
+        if (!isValid()) return;
+
+        const Emitter& e = emitterParams;
+        auto& rs = RenderingSystem::getInstance();
+
+        Render::flushBatches();
+        renderShader.use();
+        glUniform2f(renderShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()), static_cast<float>(rs.getWindowHeight()));
+        glUniform2f(renderShader.getUniformLocation("sizeRange"), e.sizeStart, e.sizeEnd);
+        glUniform4fv(renderShader.getUniformLocation("colorStart"), 1, e.colorStart);
+        glUniform4fv(renderShader.getUniformLocation("colorEnd"), 1, e.colorEnd);
+        glUniform1i(renderShader.getUniformLocation("pointSprites"), pointSprites ? 1 : 0);
+
+        GLint blendSrcRGB = GL_ONE, blendDstRGB = GL_ZERO, blendSrcAlpha = GL_ONE, blendDstAlpha = GL_ZERO;
+        if (e.additive) {
+            glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRGB);
+            glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRGB);
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        }
+
+        glBindVertexArray(renderVAO[current]);
+        if (pointSprites) {
+            // Sizes come from gl_PointSize; the fragment shader reads gl_PointCoord
+            GLboolean pointSprite = glIsEnabled(GL_POINT_SPRITE);
+            GLboolean programPointSize = glIsEnabled(GL_PROGRAM_POINT_SIZE);
+            glEnable(GL_POINT_SPRITE);
+            glEnable(GL_PROGRAM_POINT_SIZE);
+            glDrawArrays(GL_POINTS, 0, capacity);
+            if (!programPointSize) glDisable(GL_PROGRAM_POINT_SIZE);
+            if (!pointSprite) glDisable(GL_POINT_SPRITE);
+        } else {
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, capacity);
+        }
+        glBindVertexArray(0);
+
+        if (e.additive) {
+            glBlendFuncSeparate(blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha);
+        }
+    }
+
+    void ParticleSystem::destroy() {
+        if (buffers[0] != 0) {
+            glDeleteBuffers(2, buffers);
+            buffers[0] = buffers[1] = 0;
+        }
+        if (simulateVAO[0] != 0) {
+            glDeleteVertexArrays(2, simulateVAO);
+            simulateVAO[0] = simulateVAO[1] = 0;
+        }
+        if (renderVAO[0] != 0) {
+            glDeleteVertexArrays(2, renderVAO);
+            renderVAO[0] = renderVAO[1] = 0;
+        }
+        if (quadVBO != 0) {
+            glDeleteBuffers(1, &quadVBO);
+            quadVBO = 0;
+        }
+        simulateShader.destroy();
+        renderShader.destroy();
+        capacity = 0;
+    }
+} // namespace cridgeon
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "shader/shader.hpp"
+
+namespace cridgeon
+{
+    // GPU particle system. Simulation runs in a vertex shader whose output is
+    // captured with transform feedback into the second of two buffers, which
+    // are swapped every update. The CPU only supplies emitter parameters and
+    // a spawn cursor; particles are drawn as instanced SDF quads.
+    class ParticleSystem {
+    public:
+        struct Emitter {
+            float x = 0.0f, y = 0.0f;           // Emitter position in pixels
+            float radius = 0.0f;                // Spawn disc radius in pixels
+            float rate = 100.0f;                // Particles spawned per second
+            float direction = 1.5707963f;       // Emission direction in radians (default: up)
+            float spread = 6.2831853f;          // Full cone angle in radians
+            float speedMin = 20.0f, speedMax = 60.0f;   // Pixels per second
+            float lifeMin = 1.0f, lifeMax = 2.0f;       // Seconds
+            float sizeStart = 4.0f, sizeEnd = 0.0f;     // Radius in pixels over the lifetime
+            float colorStart[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            float colorEnd[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+            float gravityX = 0.0f, gravityY = 0.0f;     // Pixels per second squared
+            float drag = 0.0f;                  // Fraction of velocity lost per second
+            bool additive = false;              // Additive blending (sparks, glows)
+        };
+
+        ParticleSystem();
+        ~ParticleSystem();
+
+        // Disable copy constructor and assignment operator
+        ParticleSystem(const ParticleSystem&) = delete;
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        // Allocate GPU buffers for at most `capacity` live particles. Size it to
+        // at least rate * lifeMax, otherwise the oldest particles are recycled early.
+        bool create(int capacity);
+
+        // Emitter parameters, read on every update
+        Emitter& emitter() { return emitterParams; }
+        const Emitter& emitter() const { return emitterParams; }
+
+        // Spawn `count` extra particles on the next update
+        void burst(int count);
+
+        // Advance the simulation by `dt` seconds on the GPU
+        void update(float dt);
+
+        // Draw all live particles
+        void render();
+
+        int getCapacity() const { return capacity; }
+        bool isValid() const { return buffers[0] != 0; }
+
+        void destroy();
+
+    private:
+        Emitter emitterParams;
+        Shader simulateShader;
+        Shader renderShader;
+        bool pointSprites;
+
+        unsigned int buffers[2];
+        unsigned int simulateVAO[2];
+        unsigned int renderVAO[2];
+        unsigned int quadVBO;
+        int current;            // Index of the buffer holding the latest state
+
+        int capacity;
+        int spawnCursor;
+        float spawnAccumulator;
+        int pendingBurst;
+        float time;
+
+        void setupVertexArrays();
+    };
+} // namespace cridgeon
@@ -1,15 +1,26 @@
 #include "postprocessor.hpp"
+#include "shader/batch.hpp"
+#include "framebuffer_pool.hpp"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
 #include <sstream>
+#include <unordered_map>
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <glad/gl.h>
 
 namespace cridgeon
 {
-    PostProcessor::PostProcessor() : quadVAO(0), quadVBO(0), screenWidth(0), screenHeight(0) {}
+    const int PostProcessor::SCENE_RESOURCE;
+    const int PostProcessor::SCREEN_RESOURCE;
+
+    PostProcessor::PostProcessor()
+        : graphDirty(false), quadVAO(0), quadVBO(0), regionVAO(0), regionVBO(0), screenWidth(0), screenHeight(0),
+          renderScale(1.0f), dynamicResolution(false), sceneMips(false),
+          fxaaEnabled(false), colorGradingEnabled(false), bloomEnabled(false), bloomThreshold(0.8f), bloomKnee(0.1f), bloomIntensity(1.0f) {}
     
     PostProcessor::~PostProcessor() {
         if (quadVBO != 0) {
@@ -18,6 +29,12 @@ namespace cridgeon
         if (quadVAO != 0) {
             glDeleteVertexArrays(1, &quadVAO);
         }
+        if (regionVBO != 0) {
+            glDeleteBuffers(1, &regionVBO);
+        }
+        if (regionVAO != 0) {
+            glDeleteVertexArrays(1, &regionVAO);
+        }
     }
     
     bool PostProcessor::initialize(int width, int height) {
@@ -54,6 +71,7 @@ namespace cridgeon
         }
     
         effects.push_back(std::move(effect));
+        graphDirty = true;
         return true;
     }
     
@@ -77,6 +95,7 @@ namespace cridgeon
                 return effect->name == name;
             });
         effects.erase(it, effects.end());
+        graphDirty = true;
     }
     
     void PostProcessor::setEffectEnabled(const std::string& name, bool enabled) {
@@ -100,68 +119,684 @@ namespace cridgeon
         return names;
     }
     
+    void PostProcessor::addEffectRegion(const std::string& name, const Region& region) {
+        Effect* effect = findEffect(name);
+        if (effect) {
+            effect->regions.push_back(region);
+        }
+    }
+
+    void PostProcessor::clearEffectRegions(const std::string& name) {
+        Effect* effect = findEffect(name);
+        if (effect) {
+            effect->regions.clear();
+        }
+    }
+
+    void PostProcessor::setEffectRegionMargin(const std::string& name, int margin) {
+        Effect* effect = findEffect(name);
+        if (effect) {
+            effect->regionMargin = std::max(margin, 0);
+        }
+    }
+
+    void PostProcessor::addPass(const std::string& effectName, const std::vector<PassInput>& inputs,
+                                const std::string& output, float outputScale) {
+        GraphPass pass;
+        pass.effect = effectName;
+        pass.inputs = inputs;
+        pass.output = output;
+        pass.outputScale = std::min(std::max(outputScale, 0.01f), 1.0f);
+        graphPasses.push_back(std::move(pass));
+        graphDirty = true;
+    }
+
+    void PostProcessor::clearPasses() {
+        graphPasses.clear();
+        compiledPasses.clear();
+        graphTargets.clear();
+        graphDirty = false;
+    }
+
+    int PostProcessor::getGraphTargetCount() {
+        if (graphDirty) compileGraph();
+        return static_cast<int>(graphTargets.size());
+    }
+
+    bool PostProcessor::compileGraph() {
+        graphDirty = false;
+        compiledPasses.clear();
+        graphTargets.clear();
+
+        // The pass writing each transient texture
+        std::unordered_map<std::string, size_t> producers;
+        for (size_t i = 0; i < graphPasses.size(); ++i) {
+            const GraphPass& pass = graphPasses[i];
+            if (findEffect(pass.effect) == nullptr) {
+                std::cerr << "Render graph: unknown effect '" << pass.effect << "'" << std::endl;
+                return false;
+            }
+            if (pass.output == "scene") {
+                std::cerr << "Render graph: effect '" << pass.effect << "' cannot write the scene" << std::endl;
+                return false;
+            }
+            if (pass.output != "screen" && !producers.emplace(pass.output, i).second) {
+                std::cerr << "Render graph: '" << pass.output << "' is written by more than one pass" << std::endl;
+                return false;
+            }
+        }
+
+        // Depth first from the passes drawing to the screen: writers come out
+        // before their readers, passes nothing reads are dropped, and passes
+        // that do not depend on each other keep the order they were added in
+        std::vector<int> state(graphPasses.size(), 0);     // 0 unvisited, 1 visiting, 2 done
+        std::vector<size_t> order;
+        std::function<bool(size_t)> visit = [&](size_t i) {
+            if (state[i] == 2) return true;
+            if (state[i] == 1) {
+                std::cerr << "Render graph: cycle through '" << graphPasses[i].output << "'" << std::endl;
+                return false;
+            }
+            state[i] = 1;
+            for (const PassInput& input : graphPasses[i].inputs) {
+                if (input.resource == "scene") continue;
+                auto producer = producers.find(input.resource);
+                if (producer == producers.end()) {
+                    std::cerr << "Render graph: nothing writes '" << input.resource << "'" << std::endl;
+                    return false;
+                }
+                if (!visit(producer->second)) return false;
+            }
+            state[i] = 2;
+            order.push_back(i);
+            return true;
+        };
+        for (size_t i = 0; i < graphPasses.size(); ++i) {
+            if (graphPasses[i].output == "screen" && !visit(i)) return false;
+        }
+        if (order.empty()) {
+            std::cerr << "Render graph: no pass draws to the screen" << std::endl;
+            return false;
+        }
+
+        // Lifetime of each transient texture: from its writer to its last reader
+        std::unordered_map<std::string, size_t> lastUse;
+        for (size_t position = 0; position < order.size(); ++position) {
+            for (const PassInput& input : graphPasses[order[position]].inputs) {
+                lastUse[input.resource] = position;
+            }
+        }
+
+        // Assign textures to targets in execution order, reusing any target of
+        // the same size whose texture has been read for the last time. Greedy
+        // assignment in start order needs the fewest targets for intervals.
+        std::vector<CompiledPass> compiled;
+        std::unordered_map<std::string, int> assigned;
+        std::vector<size_t> busyUntil;
+        for (size_t position = 0; position < order.size(); ++position) {
+            const GraphPass& pass = graphPasses[order[position]];
+            CompiledPass step;
+            step.effect = findEffect(pass.effect);
+            for (const PassInput& input : pass.inputs) {
+                step.inputs.emplace_back(input.sampler, input.resource == "scene" ? SCENE_RESOURCE : assigned[input.resource]);
+            }
+
+            if (pass.output == "screen") {
+                step.output = SCREEN_RESOURCE;
+            } else {
+                int target = -1;
+                for (size_t t = 0; t < graphTargets.size(); ++t) {
+                    if (busyUntil[t] < position && graphTargets[t] == pass.outputScale) {
+                        target = static_cast<int>(t);
+                        break;
+                    }
+                }
+                if (target < 0) {
+                    target = static_cast<int>(graphTargets.size());
+                    graphTargets.push_back(pass.outputScale);
+                    busyUntil.push_back(0);
+                }
+                busyUntil[target] = lastUse[pass.output];
+                assigned[pass.output] = target;
+                step.output = target;
+            }
+            compiled.push_back(std::move(step));
+        }
+
+        compiledPasses = std::move(compiled);
+        return true;
+    }
+
+    void PostProcessor::executeGraph(const Framebuffer& scene) {
+        // Transient textures keep alpha; a pooled target's old contents are
+        // always fully overwritten
+        FramebufferSpec spec;
+        spec.alpha = true;
+        spec.depth = false;
+
+        std::vector<Framebuffer*> targets;
+        for (float scale : graphTargets) {
+            int width = std::max(1, static_cast<int>(std::lround(screenWidth * scale)));
+            int height = std::max(1, static_cast<int>(std::lround(screenHeight * scale)));
+            Framebuffer* target = FramebufferPool::getInstance().acquire(width, height, spec);
+            if (!target) {
+                std::cerr << "Render graph: failed to create a " << width << "x" << height << " target" << std::endl;
+                for (Framebuffer* acquired : targets) FramebufferPool::getInstance().release(acquired);
+                return;
+            }
+            targets.push_back(target);
+        }
+
+        // Every texture holds the scene in the same corner fraction as the
+        // scene framebuffer, so one texture coordinate scale fits all inputs
+        float coordScaleX = static_cast<float>(getRenderWidth()) / screenWidth;
+        float coordScaleY = static_cast<float>(getRenderHeight()) / screenHeight;
+        GLboolean blend = glIsEnabled(GL_BLEND);
+
+        for (const CompiledPass& pass : compiledPasses) {
+            if (pass.output == SCREEN_RESOURCE) {
+                // Passes drawing to the screen blend as usual, so overlays can stack
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, screenWidth, screenHeight);
+                if (blend) glEnable(GL_BLEND);
+            } else {
+                Framebuffer* target = targets[pass.output];
+                target->bind();
+                glViewport(0, 0, std::max(1, static_cast<int>(std::lround(target->getWidth() * coordScaleX))),
+                           std::max(1, static_cast<int>(std::lround(target->getHeight() * coordScaleY))));
+                glDisable(GL_BLEND);
+            }
+
+            const Shader& shader = pass.effect->shader;
+            shader.use();
+            const Framebuffer* first = nullptr;
+            for (size_t unit = 0; unit < pass.inputs.size(); ++unit) {
+                int resource = pass.inputs[unit].second;
+                const Framebuffer* source = resource == SCENE_RESOURCE ? &scene : targets[resource];
+                glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+                glBindTexture(GL_TEXTURE_2D, source->getColorTexture());
+                glUniform1i(shader.getUniformLocation(pass.inputs[unit].first), static_cast<GLint>(unit));
+                if (unit == 0) {
+                    // Texel size of the first input, as in the effect chain
+                    glUniform2f(shader.getUniformLocation("resolution"),
+                                static_cast<float>(source->getWidth()), static_cast<float>(source->getHeight()));
+                    first = source;
+                }
+            }
+            setTexCoordUniforms(shader, first ? first->getWidth() : screenWidth,
+                                first ? first->getHeight() : screenHeight, coordScaleX, coordScaleY);
+            glUniform1f(shader.getUniformLocation("time"), static_cast<float>(glfwGetTime()));
+            renderQuad();
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        if (blend) glEnable(GL_BLEND);
+        for (Framebuffer* target : targets) {
+            FramebufferPool::getInstance().release(target);
+        }
+    }
+
+    void PostProcessor::setBloomThreshold(float threshold, float knee) {
+        bloomThreshold = threshold;
+        bloomKnee = std::max(knee, 0.0f);
+    }
+
+    bool PostProcessor::loadBuiltinShader(Shader& shader, const std::string& fragmentPath) {
+        std::ifstream file(fragmentPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open shader file: " << fragmentPath << std::endl;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return shader.loadFromSource(getDefaultVertexShader(), buffer.str(), {"position", "texCoord"});
+    }
+
+    void PostProcessor::drawPass(const Shader& shader, const Framebuffer& source, const Framebuffer& target) {
+        float coordScaleX = static_cast<float>(getRenderWidth()) / screenWidth;
+        float coordScaleY = static_cast<float>(getRenderHeight()) / screenHeight;
+
+        target.bind();
+        glViewport(0, 0, std::max(1, static_cast<int>(std::lround(target.getWidth() * coordScaleX))),
+                   std::max(1, static_cast<int>(std::lround(target.getHeight() * coordScaleY))));
+
+        shader.use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source.getColorTexture());
+        glUniform1i(shader.getUniformLocation("screenTexture"), 0);
+        glUniform2f(shader.getUniformLocation("resolution"),
+                    static_cast<float>(source.getWidth()), static_cast<float>(source.getHeight()));
+        setTexCoordUniforms(shader, source.getWidth(), source.getHeight(), coordScaleX, coordScaleY);
+        renderQuad();
+    }
+
+    void PostProcessor::setTexCoordUniforms(const Shader& shader, int sourceWidth, int sourceHeight,
+                                            float coordScaleX, float coordScaleY) {
+        glUniform2f(shader.getUniformLocation("texCoordScale"), coordScaleX, coordScaleY);
+
+        // The source was drawn with a viewport of this size, as in drawPass();
+        // bilinear taps past its last texel centers would mix in what lies outside
+        long renderedWidth = std::max(1L, std::lround(sourceWidth * coordScaleX));
+        long renderedHeight = std::max(1L, std::lround(sourceHeight * coordScaleY));
+        glUniform2f(shader.getUniformLocation("texCoordMax"),
+                    (static_cast<float>(renderedWidth) - 0.5f) / sourceWidth,
+                    (static_cast<float>(renderedHeight) - 0.5f) / sourceHeight);
+    }
+
+    void PostProcessor::applyRegionEffects() {
+        // Whole pixels, [x0, x1) x [y0, y1), clipped to the screen
+        struct Bounds {
+            int x0, y0, x1, y1;
+            long long area() const { return static_cast<long long>(x1 - x0) * (y1 - y0); }
+        };
+        auto clip = [this](float x0, float y0, float x1, float y1) {
+            Bounds bounds;
+            bounds.x0 = std::max(static_cast<int>(std::floor(x0)), 0);
+            bounds.y0 = std::max(static_cast<int>(std::floor(y0)), 0);
+            bounds.x1 = std::min(static_cast<int>(std::ceil(x1)), screenWidth);
+            bounds.y1 = std::min(static_cast<int>(std::ceil(y1)), screenHeight);
+            return bounds;
+        };
+
+        Framebuffer* copy = nullptr;
+        std::vector<Bounds> copies;
+        std::vector<float> vertices;
+        GLboolean blend = glIsEnabled(GL_BLEND);
+
+        for (const auto& effect : effects) {
+            if (!effect->enabled || effect->regions.empty()) continue;
+
+            // One quad per region; the areas copied are the regions grown by
+            // the margin, merged while the union copies no more than its parts
+            copies.clear();
+            vertices.clear();
+            for (const Region& region : effect->regions) {
+                Bounds drawn = clip(region.x, region.y, region.x + region.width, region.y + region.height);
+                if (drawn.x1 <= drawn.x0 || drawn.y1 <= drawn.y0) continue;
+
+                float u0 = static_cast<float>(drawn.x0) / screenWidth, u1 = static_cast<float>(drawn.x1) / screenWidth;
+                float v0 = static_cast<float>(drawn.y0) / screenHeight, v1 = static_cast<float>(drawn.y1) / screenHeight;
+                float x0 = u0 * 2.0f - 1.0f, x1 = u1 * 2.0f - 1.0f;
+                float y0 = v0 * 2.0f - 1.0f, y1 = v1 * 2.0f - 1.0f;
+                vertices.insert(vertices.end(), {
+                    x0, y1, u0, v1,   x0, y0, u0, v0,   x1, y0, u1, v0,
+                    x0, y1, u0, v1,   x1, y0, u1, v0,   x1, y1, u1, v1
+                });
+
+                int margin = effect->regionMargin;
+                Bounds grown = clip(static_cast<float>(drawn.x0 - margin), static_cast<float>(drawn.y0 - margin),
+                                    static_cast<float>(drawn.x1 + margin), static_cast<float>(drawn.y1 + margin));
+                for (size_t i = 0; i < copies.size();) {
+                    Bounds merged = {std::min(copies[i].x0, grown.x0), std::min(copies[i].y0, grown.y0),
+                                     std::max(copies[i].x1, grown.x1), std::max(copies[i].y1, grown.y1)};
+                    if (merged.area() <= copies[i].area() + grown.area()) {
+                        // The grown area may now reach earlier copies, so start over
+                        grown = merged;
+                        copies.erase(copies.begin() + i);
+                        i = 0;
+                    } else {
+                        ++i;
+                    }
+                }
+                copies.push_back(grown);
+            }
+            if (vertices.empty()) continue;
+
+            // The copy is screen sized so texture coordinates match the
+            // screen; only the copied areas are ever written or read
+            if (!copy) {
+                FramebufferSpec spec;
+                spec.depth = false;
+                copy = FramebufferPool::getInstance().acquire(screenWidth, screenHeight, spec);
+                if (!copy) break;
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, copy->getID());
+            for (const Bounds& bounds : copies) {
+                glBlitFramebuffer(bounds.x0, bounds.y0, bounds.x1, bounds.y1,
+                                  bounds.x0, bounds.y0, bounds.x1, bounds.y1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            effect->shader.use();
+            setCommonUniforms(effect->shader, copy->getColorTexture());
+            setTexCoordUniforms(effect->shader, screenWidth, screenHeight, 1.0f, 1.0f);
+            glUniform1f(effect->shader.getUniformLocation("time"), static_cast<float>(glfwGetTime()));
+
+            // The effect's output replaces the region
+            glDisable(GL_BLEND);
+            glBindVertexArray(regionVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, regionVBO);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(float)), vertices.data(), GL_STREAM_DRAW);
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / 4));
+            glBindVertexArray(0);
+        }
+
+        if (blend) glEnable(GL_BLEND);
+        if (copy) {
+            FramebufferPool::getInstance().release(copy);
+        }
+    }
+
+    void PostProcessor::clearUnrenderedTargets(const std::vector<Framebuffer*>& targets) {
+        if (!sceneMips || (getRenderWidth() >= screenWidth && getRenderHeight() >= screenHeight)) return;
+
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        for (Framebuffer* target : targets) {
+            target->bind();
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    }
+
+    Framebuffer* PostProcessor::applyFXAA(const Framebuffer& source) {
+        if (!fxaaShader.isValid() && !loadBuiltinShader(fxaaShader, "resources/shaders/postprocess/fxaa.frag")) {
+            std::cerr << "Failed to load FXAA shader, disabling FXAA" << std::endl;
+            fxaaEnabled = false;
+            return nullptr;
+        }
+
+        Framebuffer* target = FramebufferPool::getInstance().acquire(screenWidth, screenHeight, sceneCopySpec());
+        if (!target) return nullptr;
+        clearUnrenderedTargets({target});
+
+        // Every pixel is replaced, blending would mix in the pooled contents
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_BLEND);
+        drawPass(fxaaShader, source, *target);
+        if (blend) glEnable(GL_BLEND);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, screenWidth, screenHeight);
+        return target;
+    }
+
+    Framebuffer* PostProcessor::applyColorGrading(const Framebuffer& source) {
+        if (!colorGradingShader.isValid() &&
+            !loadBuiltinShader(colorGradingShader, "resources/shaders/postprocess/color_grading.frag")) {
+            std::cerr << "Failed to load color grading shader, disabling color grading" << std::endl;
+            colorGradingEnabled = false;
+            return nullptr;
+        }
+
+        unsigned int lut = colorGrading.getTexture();
+        Framebuffer* target = FramebufferPool::getInstance().acquire(screenWidth, screenHeight, sceneCopySpec());
+        if (!target) return nullptr;
+        clearUnrenderedTargets({target});
+
+        colorGradingShader.use();
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_3D, lut);
+        glUniform1i(colorGradingShader.getUniformLocation("lut"), 1);
+        glUniform1f(colorGradingShader.getUniformLocation("lutSize"), static_cast<float>(ColorGrading::LUT_SIZE));
+
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_BLEND);
+        drawPass(colorGradingShader, source, *target);
+        if (blend) glEnable(GL_BLEND);
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_3D, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, screenWidth, screenHeight);
+        return target;
+    }
+
+    void PostProcessor::applyBloom(const Framebuffer& scene) {
+        if (!bloomPrefilter.isValid() &&
+            !(loadBuiltinShader(bloomPrefilter, "resources/shaders/postprocess/bloom_prefilter.frag") &&
+              loadBuiltinShader(bloomDownsample, "resources/shaders/postprocess/bloom_downsample.frag") &&
+              loadBuiltinShader(bloomUpsample, "resources/shaders/postprocess/bloom_upsample.frag"))) {
+            std::cerr << "Failed to load bloom shaders, disabling bloom" << std::endl;
+            bloomPrefilter.destroy();
+            bloomEnabled = false;
+            return;
+        }
+
+        // Half float, so the additive upsample chain does not clip at 1
+        FramebufferSpec spec;
+        spec.depth = false;
+        spec.alpha = true;
+        spec.halfFloat = true;
+        std::vector<Framebuffer*> levels;
+        int width = screenWidth, height = screenHeight;
+        for (int level = 0; level < BLOOM_LEVELS && width >= 4 && height >= 4; ++level) {
+            width /= 2;
+            height /= 2;
+            Framebuffer* target = FramebufferPool::getInstance().acquire(width, height, spec);
+            if (!target) break;
+            levels.push_back(target);
+        }
+        if (levels.empty()) return;
+
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_BLEND);
+
+        // Downsample: threshold into the first level, then halve level by level
+        bloomPrefilter.use();
+        glUniform1f(bloomPrefilter.getUniformLocation("threshold"), bloomThreshold);
+        glUniform1f(bloomPrefilter.getUniformLocation("knee"), bloomKnee);
+        drawPass(bloomPrefilter, scene, *levels[0]);
+        for (size_t level = 1; level < levels.size(); ++level) {
+            drawPass(bloomDownsample, *levels[level - 1], *levels[level]);
+        }
+
+        // Upsample: each level is tent filtered and added onto the next larger
+        // one, so the wide blur of the small levels accumulates into the large
+        GLint blendSrcRGB = GL_ONE, blendDstRGB = GL_ZERO, blendSrcAlpha = GL_ONE, blendDstAlpha = GL_ZERO;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRGB);
+        glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRGB);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        bloomUpsample.use();
+        glUniform1f(bloomUpsample.getUniformLocation("intensity"), 1.0f);
+        for (size_t level = levels.size() - 1; level > 0; --level) {
+            drawPass(bloomUpsample, *levels[level], *levels[level - 1]);
+        }
+        bloomUpsample.use();
+        glUniform1f(bloomUpsample.getUniformLocation("intensity"), bloomIntensity);
+        drawPass(bloomUpsample, *levels[0], scene);
+        glBlendFuncSeparate(blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha);
+        if (!blend) glDisable(GL_BLEND);
+
+        for (Framebuffer* level : levels) {
+            FramebufferPool::getInstance().release(level);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, screenWidth, screenHeight);
+    }
+
+    void PostProcessor::setRenderScale(float scale) {
+        renderScale = std::min(std::max(scale, ResolutionController::SCALE_GRANULARITY), 1.0f);
+        resolutionController.setScale(renderScale);
+    }
+
+    int PostProcessor::getRenderWidth() const {
+        return std::max(1, static_cast<int>(std::lround(screenWidth * renderScale)));
+    }
+
+    int PostProcessor::getRenderHeight() const {
+        return std::max(1, static_cast<int>(std::lround(screenHeight * renderScale)));
+    }
+
+    bool PostProcessor::recreateFramebuffer(const FramebufferSpec& spec) {
+        if (!framebuffer) return false;
+        if (spec == framebuffer->getSpec()) return true;
+
+        auto replacement = std::make_unique<Framebuffer>();
+        if (!replacement->create(screenWidth, screenHeight, spec)) {
+            std::cerr << "Failed to recreate framebuffer for post-processing" << std::endl;
+            return false;
+        }
+        framebuffer = std::move(replacement);
+        return true;
+    }
+
+    FramebufferSpec PostProcessor::sceneCopySpec() const {
+        FramebufferSpec spec;
+        spec.depth = false;
+        spec.mipmaps = sceneMips;
+        return spec;
+    }
+
+    bool PostProcessor::setSampleCount(int samples) {
+        if (!framebuffer) return false;
+        FramebufferSpec spec = framebuffer->getSpec();
+        // Compare against what create() would allocate, or every request
+        // above the maximum would reallocate the scene
+        samples = std::min(samples, Framebuffer::getMaxSamples());
+        spec.samples = samples > 1 ? samples : 0;
+        return recreateFramebuffer(spec);
+    }
+
+    int PostProcessor::getSampleCount() const {
+        return framebuffer && framebuffer->isMultisampled() ? framebuffer->getSpec().samples : 0;
+    }
+
+    bool PostProcessor::setSceneMips(bool enabled) {
+        if (!framebuffer) return false;
+        FramebufferSpec spec = framebuffer->getSpec();
+        spec.mipmaps = enabled;
+        if (!recreateFramebuffer(spec)) return false;
+        sceneMips = enabled;
+        return true;
+    }
+
+    void PostProcessor::setDynamicResolution(bool enabled) {
+        dynamicResolution = enabled;
+        resolutionController.reset();
+    }
+
     void PostProcessor::beginRender() {
         if (framebuffer) {
+            if (dynamicResolution) {
+                renderScale = resolutionController.getScale();
+                resolutionController.begin();
+            }
+
             framebuffer->bind();
             // Clear the framebuffer
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Pixel coordinates stay in screen units; the smaller viewport scales the scene down
+            glViewport(0, 0, getRenderWidth(), getRenderHeight());
         }
     }
     
     void PostProcessor::endRender() {
         if (!framebuffer) return;
+        Render::flushBatches();
     
         // Restore default framebuffer
         framebuffer->unbind();
         glViewport(0, 0, screenWidth, screenHeight);
     
         // Disable depth testing for post-processing
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
         glDisable(GL_DEPTH_TEST);
     
-        unsigned int currentTexture = framebuffer->getColorTexture();
-        bool renderedSomething = false;
+        // What the effects read: the scene, resolved if multisampled, or its
+        // anti-aliased copy
+        const Framebuffer* scene = framebuffer.get();
+        Framebuffer* resolved = nullptr;
+        if (framebuffer->isMultisampled()) {
+            resolved = FramebufferPool::getInstance().acquire(screenWidth, screenHeight, sceneCopySpec());
+            if (!resolved || !framebuffer->resolve(*resolved)) {
+                if (resolved) FramebufferPool::getInstance().release(resolved);
+                if (depthTest) glEnable(GL_DEPTH_TEST);
+                if (dynamicResolution) resolutionController.end();
+                return;
+            }
+            scene = resolved;
+        }
+        Framebuffer* antiAliased = fxaaEnabled ? applyFXAA(*scene) : nullptr;
+        if (antiAliased) scene = antiAliased;
+
+        if (bloomEnabled) {
+            applyBloom(*scene);
+        }
+        Framebuffer* graded = colorGradingEnabled && !colorGrading.isEmpty() ? applyColorGrading(*scene) : nullptr;
+        if (graded) scene = graded;
+        if (sceneMips) {
+            scene->generateMips();
+        }
     
-        // Apply each enabled effect in sequence
-        for (const auto& effect : effects) {
-            if (!effect->enabled) continue;
+        if (graphDirty) compileGraph();
+        if (!compiledPasses.empty()) {
+            executeGraph(*scene);
+        } else {
+            unsigned int currentTexture = scene->getColorTexture();
+            bool renderedSomething = false;
     
-            effect->shader.use();
-            
-            // Bind the texture
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, currentTexture);
-            glUniform1i(effect->shader.getUniformLocation("screenTexture"), 0);
-            
-            // Set common uniforms
-            glUniform2f(effect->shader.getUniformLocation("resolution"), static_cast<float>(screenWidth), static_cast<float>(screenHeight));
-            glUniform1f(effect->shader.getUniformLocation("time"), static_cast<float>(glfwGetTime()));
+            // Apply each enabled effect in sequence
+            for (const auto& effect : effects) {
+                if (!effect->enabled || !effect->regions.empty()) continue;
     
-            // Render full-screen quad
-            renderQuad();
-            renderedSomething = true;
-            break; // For now, only apply the first enabled effect
-        }
+                effect->shader.use();
+                setCommonUniforms(effect->shader, currentTexture);
+                glUniform1f(effect->shader.getUniformLocation("time"), static_cast<float>(glfwGetTime()));
     
-        // If no effects were applied, render with passthrough
-        if (!renderedSomething) {
-            // Find and use the passthrough effect
-            for (const auto& effect : effects) {
-                if (effect->name == "passthrough") {
-                    effect->shader.use();
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, currentTexture);
-                    glUniform1i(effect->shader.getUniformLocation("screenTexture"), 0);
-                    renderQuad();
-                    break;
+                // Render full-screen quad
+                renderQuad();
+                renderedSomething = true;
+                break; // For now, only apply the first enabled effect
+            }
+    
+            // If no effects were applied, render with passthrough
+            if (!renderedSomething) {
+                // Find and use the passthrough effect
+                for (const auto& effect : effects) {
+                    if (effect->name == "passthrough") {
+                        effect->shader.use();
+                        setCommonUniforms(effect->shader, currentTexture);
+                        renderQuad();
+                        break;
+                    }
                 }
             }
         }
     
-        // Re-enable depth testing
-        glEnable(GL_DEPTH_TEST);
+        applyRegionEffects();
+    
+        if (graded) {
+            FramebufferPool::getInstance().release(graded);
+        }
+        if (antiAliased) {
+            FramebufferPool::getInstance().release(antiAliased);
+        }
+        if (resolved) {
+            FramebufferPool::getInstance().release(resolved);
+        }
+    
+        // Restore depth testing if the scene had it on
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+
+        if (dynamicResolution) {
+            resolutionController.end();
+        }
+    }
+
+    void PostProcessor::setCommonUniforms(const Shader& shader, unsigned int texture) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glUniform1i(shader.getUniformLocation("screenTexture"), 0);
+        glUniform2f(shader.getUniformLocation("resolution"), static_cast<float>(screenWidth), static_cast<float>(screenHeight));
+
+        // Only the rendered corner of the texture holds the scene; linear
+        // filtering upscales it to the screen
+        setTexCoordUniforms(shader, screenWidth, screenHeight,
+                            static_cast<float>(getRenderWidth()) / screenWidth,
+                            static_cast<float>(getRenderHeight()) / screenHeight);
     }
     
     void PostProcessor::resize(int newWidth, int newHeight) {
+        // Resize events repeat while the window is dragged; only reallocate on a real change
+        if (newWidth == screenWidth && newHeight == screenHeight) return;
         screenWidth = newWidth;
         screenHeight = newHeight;
         
@@ -223,6 +858,16 @@ namespace cridgeon
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+        // Region quads use the same layout
+        glGenVertexArrays(1, &regionVAO);
+        glGenBuffers(1, &regionVBO);
+        glBindVertexArray(regionVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, regionVBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
         glBindVertexArray(0);
     }
     
@@ -239,11 +884,13 @@ namespace cridgeon
     in vec2 position;
     in vec2 texCoord;
     
+    uniform vec2 texCoordScale;
+    
     out vec2 TexCoords;
     
     void main() {
         gl_Position = vec4(position.x, position.y, 0.0, 1.0);
-        TexCoords = texCoord;
+        TexCoords = texCoord * texCoordScale;
     }
     )";
     }
@@ -2,6 +2,8 @@
 
 #include "shader/shader.hpp"
 #include "framebuffer.hpp"
+#include "resolution_controller.hpp"
+#include "color_grading.hpp"
 #include <vector>
 #include <memory>
 #include <string>
@@ -10,6 +12,17 @@ namespace cridgeon
 {
     class PostProcessor {
     public:
+        // Render graph input: a resource bound to one of the effect's sampler uniforms
+        struct PassInput {
+            std::string sampler;
+            std::string resource;
+        };
+
+        // Screen rectangle in pixels, y up like the Render:: coordinates
+        struct Region {
+            float x, y, width, height;
+        };
+
         PostProcessor();
         ~PostProcessor();
     
@@ -20,7 +33,9 @@ namespace cridgeon
         // Initialize the post processor with screen dimensions
         bool initialize(int screenWidth, int screenHeight);
     
-        // Add a post-processing shader effect
+        // Add a post-processing shader effect. Effects read `screenTexture` at
+        // `TexCoords`; with a render scale below 1 only a corner of it holds
+        // the scene, so taps should be clamped with min(uv, texCoordMax).
         bool addEffect(const std::string& name, const std::string& fragmentSource);
         
         // Load effect from file
@@ -37,6 +52,33 @@ namespace cridgeon
     
         // Get list of available effects
         std::vector<std::string> getEffectNames() const;
+
+        // Limit an enabled effect to rectangles of the screen, e.g. a blur
+        // behind a panel. Region effects run after the chain or the graph and
+        // read what the screen shows under their regions, plus a margin that
+        // must cover the effect's kernel radius, so their cost follows the
+        // regions' area. All regions of an effect are drawn in one pass. An
+        // effect with regions is left out of the effect chain.
+        void addEffectRegion(const std::string& name, const Region& region);
+        void clearEffectRegions(const std::string& name);
+        void setEffectRegionMargin(const std::string& name, int margin);
+
+        // Add a pass to the render graph. The pass draws the effect into
+        // `output`, sampling each input resource. "scene" is the rendered scene
+        // and "screen" the window; any other name is a transient texture that
+        // exactly one pass writes. `outputScale` sizes a transient output
+        // relative to the screen. When the graph has passes, endRender() runs
+        // it instead of the effect chain; passes that do not lead to "screen"
+        // are skipped.
+        void addPass(const std::string& effectName, const std::vector<PassInput>& inputs,
+                     const std::string& output, float outputScale = 1.0f);
+
+        // Remove every pass, going back to the effect chain
+        void clearPasses();
+
+        // Framebuffers the compiled graph uses for its transient textures;
+        // textures whose lifetimes do not overlap share one
+        int getGraphTargetCount();
     
         // Start rendering to the framebuffer (call before scene rendering)
         void beginRender();
@@ -56,20 +98,169 @@ namespace cridgeon
         // Get current screen dimensions
         int getWidth() const { return screenWidth; }
         int getHeight() const { return screenHeight; }
+
+        // Render the scene to a fraction of the screen size; endRender() upscales
+        // it. The framebuffer stays screen sized, so changing the scale only
+        // changes the viewport and never reallocates.
+        void setRenderScale(float scale);
+        float getRenderScale() const { return renderScale; }
+        int getRenderWidth() const;
+        int getRenderHeight() const;
+
+        // Render the scene into multisampled buffers with this many samples
+        // (clamped to GL_MAX_SAMPLES), resolved into a pooled texture before
+        // the effects run. Gives every shape, batched or not, edge
+        // anti-aliasing without the per-fragment cost of the shape SDFs;
+        // 0 or 1 renders single-sampled.
+        bool setSampleCount(int samples);
+        int getSampleCount() const;
+
+        // Give the texture the effects read a full mip chain, generated after
+        // bloom, so they can sample coarse levels with textureLod for blurs
+        // and glows without extra downsample targets (see mip_blur.frag).
+        // With a render scale below 1 the coarse levels mix in the black
+        // outside the rendered corner.
+        bool setSceneMips(bool enabled);
+        bool hasSceneMips() const { return sceneMips; }
+
+        // Built-in FXAA over the whole scene, run before bloom and the effects.
+        // Smooths Render::lines, which has no anti-aliasing of its own, and
+        // lets the shapes drop theirs with Render::setShapeAntiAliasing(false).
+        void setFXAAEnabled(bool enabled) { fxaaEnabled = enabled; }
+        bool isFXAAEnabled() const { return fxaaEnabled; }
+
+        // Built-in color grading, run after bloom: the operations stacked on
+        // getColorGrading() are baked into a 3D LUT, so any number of them
+        // costs one texture fetch per pixel
+        void setColorGradingEnabled(bool enabled) { colorGradingEnabled = enabled; }
+        bool isColorGradingEnabled() const { return colorGradingEnabled; }
+        ColorGrading& getColorGrading() { return colorGrading; }
+
+        // Built-in bloom, added to the scene before the effects or the graph run.
+        // Bright areas are blurred over a pyramid of pooled half-float targets
+        // down to 1/64 size, so any glow radius costs about one and a half
+        // screen passes. The scene itself is 8-bit, so only glow summed over
+        // the pyramid keeps values above 1, not the scene's own highlights.
+        void setBloomEnabled(bool enabled) { bloomEnabled = enabled; }
+        bool isBloomEnabled() const { return bloomEnabled; }
+
+        // Brightness where bloom starts, eased in over +-knee
+        void setBloomThreshold(float threshold, float knee = 0.1f);
+
+        // Strength of the glow added back to the scene
+        void setBloomIntensity(float intensity) { bloomIntensity = intensity; }
+
+        // Let frame-time feedback pick the render scale each frame
+        void setDynamicResolution(bool enabled);
+        bool isDynamicResolution() const { return dynamicResolution; }
+        ResolutionController& getResolutionController() { return resolutionController; }
     
     private:
+        static const int DEFAULT_REGION_MARGIN = 8;
+
         struct Effect {
             std::string name;
             Shader shader;
             bool enabled;
+            std::vector<Region> regions;
+            int regionMargin;
             
-            Effect(const std::string& n) : name(n), enabled(false) {}
+            Effect(const std::string& n) : name(n), enabled(false), regionMargin(DEFAULT_REGION_MARGIN) {}
         };
     
+        struct GraphPass {
+            std::string effect;
+            std::vector<PassInput> inputs;
+            std::string output;
+            float outputScale;
+        };
+
+        // Resource references in a compiled pass
+        static const int SCENE_RESOURCE = -2;
+        static const int SCREEN_RESOURCE = -1;     // Otherwise an index into graphTargets
+
+        struct CompiledPass {
+            Effect* effect;
+            std::vector<std::pair<std::string, int>> inputs;   // Sampler uniform, resource
+            int output;
+        };
+
         std::vector<std::unique_ptr<Effect>> effects;
+        std::vector<GraphPass> graphPasses;
+        std::vector<CompiledPass> compiledPasses;
+        std::vector<float> graphTargets;                       // Scale of each aliased target
+        bool graphDirty;
+
         std::unique_ptr<Framebuffer> framebuffer;
         unsigned int quadVAO, quadVBO;
+        unsigned int regionVAO, regionVBO;      // Region quads, streamed each frame
         int screenWidth, screenHeight;
+        float renderScale;
+        bool dynamicResolution;
+        bool sceneMips;
+        ResolutionController resolutionController;
+
+        // Levels of the bloom pyramid, from 1/2 down to 1/64 of the screen
+        static const int BLOOM_LEVELS = 6;
+
+        bool fxaaEnabled;
+        Shader fxaaShader;
+
+        bool colorGradingEnabled;
+        ColorGrading colorGrading;
+        Shader colorGradingShader;
+
+        bool bloomEnabled;
+        float bloomThreshold, bloomKnee, bloomIntensity;
+        Shader bloomPrefilter, bloomDownsample, bloomUpsample;
+
+        // Replace the scene framebuffer with one made to a new spec
+        bool recreateFramebuffer(const FramebufferSpec& spec);
+
+        // Spec of the pooled copies of the scene the effects read
+        FramebufferSpec sceneCopySpec() const;
+
+        // Bind the screen texture and the uniforms every effect gets
+        void setCommonUniforms(const Shader& shader, unsigned int texture);
+
+        // Order the needed passes and assign transient textures to targets
+        bool compileGraph();
+
+        // Run the compiled graph on the rendered scene
+        void executeGraph(const Framebuffer& scene);
+
+        // Anti-alias the scene into a pooled framebuffer, returned for the
+        // caller to release; nullptr if FXAA could not run
+        Framebuffer* applyFXAA(const Framebuffer& source);
+
+        // Grade the scene into a pooled framebuffer, returned for the caller
+        // to release; nullptr if grading could not run
+        Framebuffer* applyColorGrading(const Framebuffer& source);
+
+        // Add the bloom glow to the scene
+        void applyBloom(const Framebuffer& scene);
+
+        // Run the effects limited to regions, on top of the screen
+        void applyRegionEffects();
+
+        // Clear pooled scene copies that dynamic resolution only partly draws
+        // to when the scene has mips: the texCoordMax clamp keeps level 0
+        // taps inside the rendered corner, but coarse levels average in the
+        // texels outside it, which should then be black
+        void clearUnrenderedTargets(const std::vector<Framebuffer*>& targets);
+
+        // Draw a full-screen pass from one framebuffer into the rendered
+        // corner of another
+        void drawPass(const Shader& shader, const Framebuffer& source, const Framebuffer& target);
+
+        // Set texCoordScale and texCoordMax, the center of the last texel of
+        // the rendered corner of a source texture, which shaders clamp their
+        // taps to
+        void setTexCoordUniforms(const Shader& shader, int sourceWidth, int sourceHeight,
+                                 float coordScaleX, float coordScaleY);
+
+        // Load a built-in effect shader from resources/shaders/postprocess
+        bool loadBuiltinShader(Shader& shader, const std::string& fragmentPath);
     
         // Initialize the full-screen quad
         void setupQuad();
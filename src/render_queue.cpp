@@ -0,0 +1,285 @@
+#include "render_queue.hpp"
+#include "shader/batch.hpp"
+#include "shader/geometry/antialiasing.hpp"
+#include "rendering_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glad/gl.h>
+
+namespace cridgeon
+{
+    void RenderQueue::submit(int layer, uint64_t state,
+                             float x, float y, float width, float height,
+                             DrawFunction draw, Opacity opacity) {
+        if (!draw) return;
+
+        Command command;
+        command.layer = layer;
+        command.state = state;
+        command.opaque = opacity == Opacity::OPAQUE ||
+                         (opacity == Opacity::OPAQUE_SHAPE && !Render::getShapeAntiAliasing());
+        command.minX = std::min(x, x + width);
+        command.minY = std::min(y, y + height);
+        command.maxX = std::max(x, x + width);
+        command.maxY = std::max(y, y + height);
+        command.sortKey = 0;
+        command.draw = std::move(draw);
+        commands.push_back(std::move(command));
+    }
+
+    static bool overlaps(float aMinX, float aMinY, float aMaxX, float aMaxY,
+                         float bMinX, float bMinY, float bMaxX, float bMaxY) {
+        return aMinX < bMaxX && bMinX < aMaxX && aMinY < bMaxY && bMinY < aMaxY;
+    }
+
+    // Upper bound on the broad-phase grid of one layer
+    static const int MAX_GRID_CELLS_PER_EDGE = 64;
+
+    // Each command gets a level: one past the highest level of any earlier
+    // overlapping command with a different state, or equal to the level of an
+    // earlier overlapping command with the same state (their relative order is
+    // kept by the stable sort). Commands on one level never overlap a command
+    // with another state on that level, so any state order within a level
+    // draws the same image as submission order. When opaque and blended
+    // commands are drawn in separate passes, opacity counts as part of the
+    // state.
+    //
+    // Only commands of one layer can overlap, and within a layer a uniform
+    // grid over the layer's bounds finds the candidates: each command is
+    // tested against the earlier commands sharing a cell with it, so the cost
+    // follows the number of actual neighbours rather than the queue length.
+    void RenderQueue::computeSortKeys(bool splitOpaque) {
+        const size_t count = commands.size();
+        std::vector<uint32_t> levels(count, 0);
+        std::vector<size_t> visited(count, count);     // Last command tested against each one
+
+        std::vector<size_t> byLayer(count);
+        for (size_t i = 0; i < count; ++i) {
+            byLayer[i] = i;
+        }
+        // Stable, so each layer's run stays in submission order
+        std::stable_sort(byLayer.begin(), byLayer.end(), [this](size_t a, size_t b) {
+            return commands[a].layer < commands[b].layer;
+        });
+
+        std::vector<std::vector<size_t>> cells;
+        for (size_t begin = 0; begin < count;) {
+            size_t end = begin + 1;
+            while (end < count && commands[byLayer[end]].layer == commands[byLayer[begin]].layer) {
+                ++end;
+            }
+
+            float minX = commands[byLayer[begin]].minX, minY = commands[byLayer[begin]].minY;
+            float maxX = commands[byLayer[begin]].maxX, maxY = commands[byLayer[begin]].maxY;
+            for (size_t k = begin + 1; k < end; ++k) {
+                const Command& command = commands[byLayer[k]];
+                minX = std::min(minX, command.minX);
+                minY = std::min(minY, command.minY);
+                maxX = std::max(maxX, command.maxX);
+                maxY = std::max(maxY, command.maxY);
+            }
+
+            // About one command per cell when they are spread evenly
+            int cellsPerEdge = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(end - begin))));
+            cellsPerEdge = std::min(std::max(cellsPerEdge, 1), MAX_GRID_CELLS_PER_EDGE);
+            float cellsPerUnitX = (maxX > minX) ? cellsPerEdge / (maxX - minX) : 0.0f;
+            float cellsPerUnitY = (maxY > minY) ? cellsPerEdge / (maxY - minY) : 0.0f;
+            auto cellX = [&](float x) {
+                return std::min(std::max(static_cast<int>((x - minX) * cellsPerUnitX), 0), cellsPerEdge - 1);
+            };
+            auto cellY = [&](float y) {
+                return std::min(std::max(static_cast<int>((y - minY) * cellsPerUnitY), 0), cellsPerEdge - 1);
+            };
+
+            cells.assign(static_cast<size_t>(cellsPerEdge) * cellsPerEdge, std::vector<size_t>());
+            for (size_t k = begin; k < end; ++k) {
+                size_t i = byLayer[k];
+                const Command& command = commands[i];
+                int x0 = cellX(command.minX), x1 = cellX(command.maxX);
+                int y0 = cellY(command.minY), y1 = cellY(command.maxY);
+
+                uint32_t level = 0;
+                for (int y = y0; y <= y1; ++y) {
+                    for (int x = x0; x <= x1; ++x) {
+                        std::vector<size_t>& cell = cells[static_cast<size_t>(y) * cellsPerEdge + x];
+                        for (size_t j : cell) {
+                            if (visited[j] == i) continue;
+                            visited[j] = i;
+                            const Command& earlier = commands[j];
+                            if (!overlaps(command.minX, command.minY, command.maxX, command.maxY,
+                                          earlier.minX, earlier.minY, earlier.maxX, earlier.maxY)) continue;
+                            bool sameState = earlier.state == command.state &&
+                                             (!splitOpaque || earlier.opaque == command.opaque);
+                            uint32_t required = levels[j] + (sameState ? 0u : 1u);
+                            level = std::max(level, required);
+                        }
+                        cell.push_back(i);
+                    }
+                }
+                levels[i] = level;
+            }
+            begin = end;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            Command& command = commands[i];
+
+            // The state only groups equal states together, so a hash of it suffices
+            uint32_t stateHash = static_cast<uint32_t>(command.state ^ (command.state >> 32));
+            int layer = std::min(std::max(command.layer, -32768), 32767);
+            uint32_t layerBits = static_cast<uint32_t>(layer + 32768);   // Signed to unsigned order
+            command.sortKey = (static_cast<uint64_t>(layerBits) << 48) |
+                              (static_cast<uint64_t>(levels[i]) << 16) |
+                              ((stateHash ^ (stateHash >> 16)) & 0xFFFFu);
+        }
+    }
+
+    // Check whether the bound draw framebuffer has a depth attachment
+    static bool hasDepthBuffer(GLint framebuffer) {
+        GLint type = GL_NONE;
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, framebuffer == 0 ? GL_DEPTH : GL_DEPTH_ATTACHMENT,
+                                              GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+        return type != GL_NONE;
+    }
+
+    void RenderQueue::flush() {
+        stateChanges = 0;
+        if (commands.empty()) return;
+
+        bool useDepth = depthMode && std::any_of(commands.begin(), commands.end(), [](const Command& command) {
+            return command.opaque;
+        });
+        GLint framebuffer = 0;
+        if (useDepth) {
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+            useDepth = hasDepthBuffer(framebuffer);
+        }
+
+        computeSortKeys(useDepth);
+
+        order.resize(commands.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        // Stable, so equal keys keep submission order
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return commands[a].sortKey < commands[b].sortKey;
+        });
+
+        if (useDepth) {
+            drawDepth(framebuffer);
+        } else {
+            drawPainter();
+        }
+        commands.clear();
+    }
+
+    void RenderQueue::drawPainter() {
+        const Command* previous = nullptr;
+        for (size_t index : order) {
+            const Command& command = commands[index];
+            if (!previous || previous->state != command.state) {
+                ++stateChanges;
+            }
+            command.draw();
+            previous = &command;
+        }
+    }
+
+    // Depth distance between slices: a few steps of a 24-bit depth buffer
+    static const double DEPTH_STEP = 4.0 / 16777215.0;
+
+    void RenderQueue::drawDepth(int framebuffer) {
+        // Number the slices back to front; the key above the state hash is (layer, level)
+        std::vector<uint32_t> slices(commands.size());
+        uint32_t sliceCount = 0;
+        uint64_t previousSlice = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            uint64_t slice = commands[order[i]].sortKey >> 16;
+            if (i > 0 && slice != previousSlice) ++sliceCount;
+            slices[order[i]] = sliceCount;
+            previousSlice = slice;
+        }
+        ++sliceCount;
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        GLboolean depthMask = GL_TRUE;
+        GLint depthFunc = GL_LESS;
+        GLfloat depthRange[2] = {0.0f, 1.0f};
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+        glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+        glGetFloatv(GL_DEPTH_RANGE, depthRange);
+
+        Render::flushBatches();
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(GL_TRUE);
+
+        // Earlier flushes to this target in this frame left depths above the
+        // floor; clear only when starting afresh or out of depth steps
+        uint64_t frame = RenderingSystem::getInstance().getFrameIndex();
+        double nextFloor = depthFloor - DEPTH_STEP * sliceCount;
+        if (depthTarget != framebuffer || depthFrame != frame || nextFloor <= 0.0) {
+            glClearDepth(1.0);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            depthTarget = framebuffer;
+            depthFrame = frame;
+            nextFloor = 1.0 - DEPTH_STEP * sliceCount;
+        }
+        const double base = nextFloor + DEPTH_STEP * sliceCount;
+        depthFloor = nextFloor;
+
+        // Every fragment of a slice gets the slice's depth, whatever the shader
+        // writes; later slices are nearer. Batches are flushed at slice changes
+        // since they are drawn with the depth range current at flush time.
+        uint32_t currentSlice = sliceCount;
+        auto setSlice = [&](uint32_t slice) {
+            if (slice == currentSlice) return;
+            Render::flushBatches();
+            double depth = base - DEPTH_STEP * (slice + 1);
+            glDepthRange(depth, depth);
+            currentSlice = slice;
+        };
+
+        // Opaque pass, front to back. Within a slice, same-state commands may
+        // overlap; drawing them in reverse with GL_LESS keeps the later one.
+        glDisable(GL_BLEND);
+        glDepthFunc(GL_LESS);
+        const Command* previous = nullptr;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const Command& command = commands[*it];
+            if (!command.opaque) continue;
+            setSlice(slices[*it]);
+            if (!previous || previous->state != command.state) {
+                ++stateChanges;
+            }
+            command.draw();
+            previous = &command;
+        }
+        Render::flushBatches();
+
+        // Blended pass, back to front, behind nothing nearer that is opaque
+        if (blend) glEnable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        previous = nullptr;
+        for (size_t index : order) {
+            const Command& command = commands[index];
+            if (command.opaque) continue;
+            setSlice(slices[index]);
+            if (!previous || previous->state != command.state) {
+                ++stateChanges;
+            }
+            command.draw();
+            previous = &command;
+        }
+        Render::flushBatches();
+
+        glDepthRange(depthRange[0], depthRange[1]);
+        glDepthFunc(depthFunc);
+        glDepthMask(depthMask);
+        if (!depthTest) glDisable(GL_DEPTH_TEST);
+        if (blend) glEnable(GL_BLEND);
+    }
+} // namespace cridgeon
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cridgeon
+{
+    // Deferred draw commands reordered to maximize batching without changing
+    // the image. Each command carries a layer, a pipeline state and a screen
+    // bounding box. Layers are drawn in ascending order; within a layer a
+    // command may move ahead of earlier commands it does not overlap, so
+    // commands sharing a state end up adjacent and merge into one batch.
+    // Overlapping commands with different states keep their painter's order.
+    //
+    // In depth mode each distinct (layer, level) slice gets its own depth.
+    // Opaque commands are drawn first, front to back with depth writes and
+    // blending off, so hidden pixels beneath them are rejected by the early
+    // depth test; blended commands follow back to front, tested against that
+    // depth but not writing it. The target must have a depth buffer (the
+    // post-processor's does); otherwise flush() falls back to painter's order.
+    // The depth buffer is cleared once per frame and target: later flushes
+    // draw nearer than earlier ones, so their depth never hides them.
+    class RenderQueue {
+    public:
+        using DrawFunction = std::function<void()>;
+
+        // How a command covers the pixels inside its shape
+        enum class Opacity {
+            BLENDED,        // Partially transparent; always drawn in painter's order
+            OPAQUE,         // Alpha 1 with hard edges (opaque images, polygons)
+            OPAQUE_SHAPE    // Alpha 1 inside, but edges anti-aliased while shape AA is on
+        };
+
+        RenderQueue() = default;
+
+        // Disable copy constructor and assignment operator
+        RenderQueue(const RenderQueue&) = delete;
+        RenderQueue& operator=(const RenderQueue&) = delete;
+
+        // Queue a draw. Layers range from -32768 to 32767. `state` identifies the pipeline state the draw uses
+        // (shader, texture, blend mode...); draws with equal states must be
+        // able to share a batch, e.g. textureQuad() calls with one texture.
+        // The bounds (x, y, width, height) must cover everything the draw
+        // touches; pass a window-sized box for draws without a known extent.
+        // Opaque draws must cover every pixel inside their shape with alpha 1
+        // and write nothing outside it; they only differ from blended draws in
+        // depth mode. OPAQUE_SHAPE draws (solid circles, rectangles...) count
+        // as opaque only while shape anti-aliasing is off
+        // (Render::setShapeAntiAliasing()), since their edges are otherwise
+        // partially covered.
+        void submit(int layer, uint64_t state,
+                    float x, float y, float width, float height,
+                    DrawFunction draw, Opacity opacity = Opacity::BLENDED);
+
+        // Draw opaque commands front to back against the depth buffer. Needs a
+        // depth attachment; otherwise flush() draws in painter's order.
+        void setDepthMode(bool enabled) { depthMode = enabled; }
+        bool isDepthMode() const { return depthMode; }
+
+        // Sort the queued commands, run them and clear the queue
+        void flush();
+
+        // Drop the queued commands without drawing them
+        void clear() { commands.clear(); }
+
+        size_t getCommandCount() const { return commands.size(); }
+
+        // Number of state changes in the last flush(), i.e. the number of
+        // runs of consecutive commands with equal states
+        size_t getStateChangeCount() const { return stateChanges; }
+
+    private:
+        struct Command {
+            int layer;
+            uint64_t state;
+            bool opaque;
+            float minX, minY, maxX, maxY;
+            uint64_t sortKey;   // layer (16 bits), level (32 bits), state hash (16 bits)
+            DrawFunction draw;
+        };
+
+        std::vector<Command> commands;
+        std::vector<size_t> order;
+        size_t stateChanges = 0;
+        bool depthMode = false;
+
+        // Depth buffer last cleared by drawDepth() and the depth below which
+        // the next flush draws
+        int64_t depthTarget = -1;
+        uint64_t depthFrame = 0;
+        double depthFloor = 1.0;
+
+        void computeSortKeys(bool splitOpaque);
+        void drawPainter();
+        void drawDepth(int framebuffer);
+    };
+} // namespace cridgeon
@@ -1,4 +1,8 @@
 #include "rendering_system.hpp"
+#include "gl_capabilities.hpp"
+#include "shader/batch.hpp"
+#include "framebuffer_pool.hpp"
+#include "software/rasterizer.hpp"
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -43,7 +47,9 @@ namespace cridgeon
     RenderingSystem::RenderingSystem()
         : window_width_(0), window_height_(0), window_title_(""),
           window_(nullptr), clear_color_{0.05f, 0.05f, 0.08f, 1.0f}, glsl_version_("#version 130"),
-          initialized_(false) {
+          initialized_(false), fast_paths_enabled_(true), backend_(RenderBackend::OPENGL),
+          requested_backend_(RenderBackend::OPENGL), overdraw_mode_(OverdrawMode::OFF),
+          overdraw_counting_(false), frame_index_(0) {
     }
     
     RenderingSystem& RenderingSystem::getInstance() {
@@ -85,12 +91,32 @@ namespace cridgeon
             return false;
         }
     
+        // Prefer a GL 4.x compatibility context so the DSA / persistent mapping /
+        // multi-draw-indirect paths can be used, then fall back to GL 3.0.
+        // Shaders stay on GLSL 130, which compatibility profiles accept.
+        static const int preferredVersions[][2] = { {4, 6}, {4, 5}, {4, 3}, {3, 3} };
+        if (fast_paths_enabled_) {
+            glfwSetErrorCallback(nullptr); // Failed probes are expected, keep them quiet
+            for (const auto& version : preferredVersions) {
+                glfwDefaultWindowHints();
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+                glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
+                window_ = glfwCreateWindow(window_width_, window_height_, window_title_.c_str(), nullptr, nullptr);
+                if (window_ != nullptr) break;
+            }
+            glfwSetErrorCallback(glfwErrorCallback);
+        }
+
         // GL 3.0 + GLSL 130
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        if (window_ == nullptr) {
+            glfwDefaultWindowHints();
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
     
-        // Create window with graphics context
-        window_ = glfwCreateWindow(window_width_, window_height_, window_title_.c_str(), nullptr, nullptr);
+            // Create window with graphics context
+            window_ = glfwCreateWindow(window_width_, window_height_, window_title_.c_str(), nullptr, nullptr);
+        }
         if (window_ == nullptr) {
             std::cerr << "Failed to create GLFW window" << std::endl;
             glfwTerminate();
@@ -105,6 +131,8 @@ namespace cridgeon
             glfwTerminate();
             return false;
         }
+
+        detectGLCapabilities(fast_paths_enabled_);
         
         // Enable blending for alpha transparency
         glEnable(GL_BLEND);
@@ -124,6 +152,7 @@ namespace cridgeon
     void RenderingSystem::beginFrame() {
         if (!initialized_) return;
         takeContext();
+        ++frame_index_;
         
         // Poll and handle events
         glfwPollEvents();
@@ -136,13 +165,45 @@ namespace cridgeon
             window_height_ = display_h;
         }
     
+        // Switch backends between frames only, so a frame is never split across both
+        if (backend_ != requested_backend_) {
+            Render::flushBatches();
+            backend_ = requested_backend_;
+        }
+        if (backend_ == RenderBackend::SOFTWARE) {
+            SoftwareRasterizer::getInstance().begin(window_width_, window_height_, clear_color_);
+        }
+    
         // Clear the framebuffer and render ImGui to it
         glClearColor(clear_color_[0], clear_color_[1], clear_color_[2], clear_color_[3]);
-        glClear(GL_COLOR_BUFFER_BIT);
+        overdraw_counting_ = overdraw_mode_ != OverdrawMode::OFF;
+        if (overdraw_counting_) {
+            glStencilMask(0xFF);
+            glClearStencil(0);
+            glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+            overdraw_counter_.begin();
+        } else {
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
     }
     
     void RenderingSystem::endFrame() {
         if (!initialized_) return;
+        Render::flushBatches();
+        if (backend_ == RenderBackend::SOFTWARE) {
+            // Covers the whole window, so GL-only drawing does not show in this mode
+            SoftwareRasterizer& rasterizer = SoftwareRasterizer::getInstance();
+            rasterizer.render();
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, window_width_, window_height_);
+            rasterizer.present();
+        }
+        if (overdraw_counting_) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, window_width_, window_height_);
+            overdraw_counter_.end(window_width_, window_height_, overdraw_mode_ == OverdrawMode::HEATMAP);
+        }
+        FramebufferPool::getInstance().trim();
         glfwSwapBuffers((GLFWwindow*)window_);
         releaseContext();
     }
@@ -155,6 +216,9 @@ namespace cridgeon
     
     void RenderingSystem::shutdown() {
         if (!initialized_) return;
+
+        overdraw_counter_.destroy();
+        SoftwareRasterizer::getInstance().destroy();
     
         if (window_) {
             glfwDestroyWindow((GLFWwindow*)window_);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "overdraw.hpp"
+
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -9,6 +12,11 @@
 
 namespace cridgeon
 {
+    // Where the Render:: primitives are drawn
+    enum class RenderBackend {
+        OPENGL,     // GPU shaders and instance batches
+        SOFTWARE    // SoftwareRasterizer, presented as a texture at endFrame()
+    };
     
     class RenderingSystem {
     public:
@@ -46,6 +54,28 @@ namespace cridgeon
     
         const char* getGLSLVersion() const { return glsl_version_; }
 
+        // Allow GL 4.x fast paths (DSA, persistent mapping, multi-draw indirect).
+        // Must be called before initialize(); disabling forces the GL 3.0 paths.
+        void setFastPathsEnabled(bool enabled) { fast_paths_enabled_ = enabled; }
+
+        // Debug mode counting the fragments drawn to the window each frame
+        void setOverdrawMode(OverdrawMode mode) { overdraw_mode_ = mode; }
+        OverdrawMode getOverdrawMode() const { return overdraw_mode_; }
+
+        // Fill-rate stats of the last frame drawn with the overdraw mode on
+        const OverdrawStats& getOverdrawStats() const { return overdraw_counter_.getStats(); }
+
+        // Fragment count shown as the hottest color of the heatmap
+        void setOverdrawHeatmapScale(float maxCount) { overdraw_counter_.setHeatmapScale(maxCount); }
+
+        // Draw the Render:: primitives with the GPU or the software rasterizer.
+        // Takes effect at the next beginFrame().
+        void setBackend(RenderBackend backend) { requested_backend_ = backend; }
+        RenderBackend getBackend() const { return backend_; }
+
+        // Number of beginFrame() calls so far
+        uint64_t getFrameIndex() const { return frame_index_; }
+
         bool takeContext(bool noHang = false);
         bool releaseContext();
     
@@ -69,6 +99,16 @@ namespace cridgeon
         const char* glsl_version_;
         
         bool initialized_;
+        bool fast_paths_enabled_;
+
+        RenderBackend backend_;             // Backend of the current frame
+        RenderBackend requested_backend_;
+
+        OverdrawMode overdraw_mode_;
+        bool overdraw_counting_;    // Counting started by this frame's beginFrame()
+        OverdrawCounter overdraw_counter_;
+
+        uint64_t frame_index_;
 
         std::mutex context_mutex_;
     };
@@ -0,0 +1,150 @@
+#include "resolution_controller.hpp"
+#include "gl_capabilities.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace cridgeon
+{
+    constexpr float ResolutionController::SCALE_GRANULARITY;
+
+    static double now() {
+        using Clock = std::chrono::steady_clock;
+        return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+    }
+
+    ResolutionController::ResolutionController()
+        : scale(1.0f), queries{}, queryPending{}, queryScale{}, querySlot(0), timing(false),
+          cpuStart(0.0), gpuMs(0.0f), cpuMs(0.0f),
+          slowFrames(0), fastFrames(0), windowGpuMs(0.0f), windowCpuMs(0.0f) {}
+
+    ResolutionController::~ResolutionController() {
+        destroy();
+    }
+
+    void ResolutionController::setScale(float newScale) {
+        scale = std::min(std::max(newScale, settings.minScale), settings.maxScale);
+        reset();
+    }
+
+    void ResolutionController::setSettings(const Settings& newSettings) {
+        settings = newSettings;
+        settings.minScale = std::max(settings.minScale, SCALE_GRANULARITY);
+        settings.maxScale = std::max(settings.maxScale, settings.minScale);
+        settings.settleFrames = std::max(settings.settleFrames, 1);
+        setScale(scale);
+    }
+
+    void ResolutionController::reset() {
+        slowFrames = fastFrames = 0;
+        windowGpuMs = windowCpuMs = 0.0f;
+    }
+
+    void ResolutionController::begin() {
+        cpuStart = now();
+        if (!glCapabilities().timerQuery) return;
+        if (queries[0] == 0) glGenQueries(QUERY_COUNT, queries);
+
+        collectResults();
+
+        // The GPU is a whole ring of frames behind; skip this frame rather than wait
+        if (queryPending[querySlot]) return;
+
+        glBeginQuery(GL_TIME_ELAPSED, queries[querySlot]);
+        queryScale[querySlot] = scale;
+        timing = true;
+    }
+
+    void ResolutionController::end() {
+        cpuMs = static_cast<float>((now() - cpuStart) * 1000.0);
+        if (!timing) return;
+
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[querySlot] = true;
+        querySlot = (querySlot + 1) % QUERY_COUNT;
+        timing = false;
+    }
+
+    void ResolutionController::collectResults() {
+        // Oldest first: the slot about to be reused holds the oldest query
+        for (int i = 0; i < QUERY_COUNT; ++i) {
+            int slot = (querySlot + i) % QUERY_COUNT;
+            if (!queryPending[slot]) continue;
+
+            GLint available = 0;
+            glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            queryPending[slot] = false;
+
+            // Frames drawn before the last change say nothing about the current scale
+            if (queryScale[slot] == scale) {
+                update(static_cast<float>(nanoseconds / 1.0e6));
+            }
+        }
+    }
+
+    void ResolutionController::update(float frameGpuMs) {
+        gpuMs = frameGpuMs;
+        bool slow = frameGpuMs > settings.targetMs * settings.highWatermark && scale > settings.minScale;
+        bool fast = frameGpuMs < settings.targetMs * settings.lowWatermark && scale < settings.maxScale;
+
+        if ((slow && fastFrames > 0) || (fast && slowFrames > 0) || (!slow && !fast)) {
+            reset();
+        }
+        if (!slow && !fast) return;
+
+        int& frames = slow ? slowFrames : fastFrames;
+        ++frames;
+        windowGpuMs += frameGpuMs;
+        windowCpuMs += cpuMs;
+
+        int needed = slow ? settings.settleFrames : settings.settleFrames * 2;
+        if (frames < needed) return;
+
+        float averageGpuMs = windowGpuMs / frames;
+        float averageCpuMs = windowCpuMs / frames;
+        if (slow && averageCpuMs > averageGpuMs) {
+            // CPU bound: a lower resolution would not make the frame any faster
+            reset();
+            return;
+        }
+        changeScale(averageGpuMs);
+    }
+
+    void ResolutionController::changeScale(float averageGpuMs) {
+        // GPU time follows the pixel count, the square of the scale; aim for
+        // the middle of the band between the watermarks
+        float middle = settings.targetMs * (settings.highWatermark + settings.lowWatermark) * 0.5f;
+        float desired = scale * std::sqrt(middle / std::max(averageGpuMs, 0.01f));
+        desired = std::min(std::max(desired, scale * (1.0f - settings.maxStep)), scale * (1.0f + settings.maxStep));
+
+        float next = quantize(desired);
+        if (next == scale) {
+            // A watermark was crossed for long enough, so move at least one step
+            next = quantize(desired < scale ? scale - SCALE_GRANULARITY : scale + SCALE_GRANULARITY);
+        }
+        scale = next;
+        reset();
+    }
+
+    float ResolutionController::quantize(float value) const {
+        value = std::round(value / SCALE_GRANULARITY) * SCALE_GRANULARITY;
+        return std::min(std::max(value, settings.minScale), settings.maxScale);
+    }
+
+    void ResolutionController::destroy() {
+        if (queries[0] != 0) {
+            if (timing) glEndQuery(GL_TIME_ELAPSED);
+            glDeleteQueries(QUERY_COUNT, queries);
+            for (int i = 0; i < QUERY_COUNT; ++i) {
+                queries[i] = 0;
+                queryPending[i] = false;
+            }
+        }
+        timing = false;
+    }
+} // namespace cridgeon
@@ -0,0 +1,83 @@
+#pragma once
+
+namespace cridgeon
+{
+    // Frame-time feedback for dynamic resolution. Times the GPU work between
+    // begin() and end() with GL_TIME_ELAPSED queries, read a few frames late
+    // so they never stall, along with the CPU time of the same span, and
+    // picks the render scale that keeps the GPU time under the target.
+    //
+    // Changes use hysteresis: the time has to stay above the high watermark
+    // (or below the low one) for several frames, the scale rises more slowly
+    // than it drops, and after a change only measurements taken at the new
+    // scale count. Without timer queries (contexts older than GL 3.3) the
+    // scale only changes through setScale().
+    class ResolutionController {
+    public:
+        struct Settings {
+            float targetMs = 14.0f;         // GPU budget of the timed span, leaving headroom under 60 Hz
+            float minScale = 0.5f;
+            float maxScale = 1.0f;
+            float highWatermark = 1.0f;     // Drop when above targetMs * highWatermark
+            float lowWatermark = 0.7f;      // Raise when below targetMs * lowWatermark
+            int settleFrames = 8;           // Frames past a watermark before dropping; twice that to raise
+            float maxStep = 0.15f;          // Largest relative change at once
+        };
+
+        // Scales are multiples of this, so tiny corrections do not add up to churn
+        static constexpr float SCALE_GRANULARITY = 1.0f / 32.0f;
+
+        ResolutionController();
+        ~ResolutionController();
+
+        // Disable copy constructor and assignment operator
+        ResolutionController(const ResolutionController&) = delete;
+        ResolutionController& operator=(const ResolutionController&) = delete;
+
+        // Start and stop timing the frame's scene work; end() may change the scale
+        void begin();
+        void end();
+
+        float getScale() const { return scale; }
+
+        // Set the scale directly; the controller continues from it
+        void setScale(float newScale);
+
+        void setSettings(const Settings& newSettings);
+        const Settings& getSettings() const { return settings; }
+
+        // Last measured times of the span, in milliseconds (GPU time is 0
+        // until the first query result arrives)
+        float getGpuTimeMs() const { return gpuMs; }
+        float getCpuTimeMs() const { return cpuMs; }
+
+        // Forget the measurements, e.g. after a scene change
+        void reset();
+
+        void destroy();
+
+    private:
+        static const int QUERY_COUNT = 4;
+
+        Settings settings;
+        float scale;
+
+        unsigned int queries[QUERY_COUNT];
+        bool queryPending[QUERY_COUNT];
+        float queryScale[QUERY_COUNT];      // Scale each query was taken at
+        int querySlot;
+        bool timing;
+
+        double cpuStart;
+        float gpuMs, cpuMs;
+
+        // Frames in a row past a watermark, and their summed times
+        int slowFrames, fastFrames;
+        float windowGpuMs, windowCpuMs;
+
+        void collectResults();
+        void update(float frameGpuMs);
+        void changeScale(float averageGpuMs);
+        float quantize(float value) const;
+    };
+} // namespace cridgeon
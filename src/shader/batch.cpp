@@ -0,0 +1,165 @@
+#include "batch.hpp"
+
+#include "gl_capabilities.hpp"
+#include "stream_buffer.hpp"
+
+#include <glad/gl.h>
+
+namespace cridgeon {
+namespace Render {
+
+    static InstanceBatch* openBatch = nullptr;
+    static StreamBuffer instanceStream;
+
+    // Triangle strip over the unit quad
+    static const float QUAD_CORNERS[8] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f
+    };
+
+    // Same quad as two triangles, for contexts without instanced arrays
+    static const int EXPANDED_CORNERS[6] = {0, 1, 2, 2, 1, 3};
+
+    InstanceBatch::InstanceBatch(std::vector<int> attributeSizes, SetupFunction setupFunction)
+        : sizes(std::move(attributeSizes)), instanceFloats(0), setup(setupFunction), key(0),
+          vao(0), quadVBO(0), initialized(false) {
+        for (int size : sizes) {
+            instanceFloats += size;
+        }
+    }
+
+    InstanceBatch::~InstanceBatch() {
+        if (openBatch == this) {
+            openBatch = nullptr;
+        }
+    }
+
+    float* InstanceBatch::append(uint64_t stateKey, size_t count) {
+        if (openBatch != this || (stateKey != key && !data.empty())) {
+            flushBatches();
+        }
+        openBatch = this;
+        key = stateKey;
+
+        size_t floats = count * instanceFloats;
+        data.resize(data.size() + floats);
+        return data.data() + data.size() - floats;
+    }
+
+    void InstanceBatch::initialize() {
+        if (initialized) return;
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &quadVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_CORNERS), QUAD_CORNERS, GL_STATIC_DRAW);
+
+        glBindVertexArray(vao);
+        for (unsigned int a = 0; a <= sizes.size(); ++a) {
+            glEnableVertexAttribArray(a);
+        }
+        if (glCapabilities().instancedArrays) {
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+            for (unsigned int a = 1; a <= sizes.size(); ++a) {
+                glVertexAttribDivisor(a, 1);
+            }
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (!instanceStream.isValid()) {
+            instanceStream.create(4 * 1024 * 1024);
+        }
+        initialized = true;
+    }
+
+    void InstanceBatch::flush() {
+        if (openBatch == this) {
+            openBatch = nullptr;
+        }
+        if (data.empty()) return;
+
+        initialize();
+        setup(key);
+
+        if (glCapabilities().instancedArrays) {
+            drawInstanced();
+        } else {
+            drawExpanded();
+        }
+        data.clear();
+    }
+
+    void InstanceBatch::drawInstanced() {
+        glBindVertexArray(vao);
+        size_t offset = instanceStream.write(data.data(), data.size() * sizeof(float));
+
+        const GLsizei stride = instanceFloats * sizeof(float);
+        size_t attributeOffset = offset;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            glVertexAttribPointer(static_cast<unsigned int>(i + 1), sizes[i], GL_FLOAT, GL_FALSE, stride, (void*)attributeOffset);
+            attributeOffset += sizes[i] * sizeof(float);
+        }
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(getPendingCount()));
+        glBindVertexArray(0);
+    }
+
+    void InstanceBatch::drawExpanded() {
+        // Duplicate the instance attributes onto the six vertices of each quad
+        const int vertexFloats = 2 + instanceFloats;
+        size_t count = getPendingCount();
+        std::vector<float> vertices;
+        vertices.reserve(count * 6 * vertexFloats);
+        for (size_t i = 0; i < count; ++i) {
+            const float* instance = &data[i * instanceFloats];
+            for (int corner : EXPANDED_CORNERS) {
+                vertices.push_back(QUAD_CORNERS[corner * 2]);
+                vertices.push_back(QUAD_CORNERS[corner * 2 + 1]);
+                vertices.insert(vertices.end(), instance, instance + instanceFloats);
+            }
+        }
+
+        glBindVertexArray(vao);
+        size_t offset = instanceStream.write(vertices.data(), vertices.size() * sizeof(float));
+
+        const GLsizei stride = vertexFloats * sizeof(float);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        size_t attributeOffset = offset + 2 * sizeof(float);
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            glVertexAttribPointer(static_cast<unsigned int>(i + 1), sizes[i], GL_FLOAT, GL_FALSE, stride, (void*)attributeOffset);
+            attributeOffset += sizes[i] * sizeof(float);
+        }
+
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count * 6));
+        glBindVertexArray(0);
+    }
+
+    void InstanceBatch::destroy() {
+        if (openBatch == this) {
+            openBatch = nullptr;
+        }
+        data.clear();
+        if (initialized) {
+            glDeleteVertexArrays(1, &vao);
+            glDeleteBuffers(1, &quadVBO);
+            vao = quadVBO = 0;
+            initialized = false;
+        }
+    }
+
+    void flushBatches() {
+        if (openBatch) {
+            openBatch->flush();
+        }
+    }
+
+    void _destroyBatches() {
+        openBatch = nullptr;
+        instanceStream.destroy();
+    }
+
+} // namespace Render
+} // namespace cridgeon
@@ -0,0 +1,81 @@
+/// @file batch.hpp
+/// @brief Instanced batching of screen-space quads. Primitives append one
+///        instance per draw; consecutive instances with the same state key
+///        are submitted with a single instanced draw call. Only one batch is
+///        open at a time, so submission order (painter's order) is kept:
+///        appending to a different batch, or with a different key, flushes
+///        the open one first. Non-batched primitives call flushBatches()
+///        before drawing.
+
+#ifndef CRIDGEON_SHADER_BATCH_HPP
+#define CRIDGEON_SHADER_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cridgeon {
+namespace Render {
+
+    class InstanceBatch {
+    public:
+        /// @brief Binds the program, uniforms and textures for a state key.
+        ///        Called right before the batch is drawn.
+        using SetupFunction = void (*)(uint64_t key);
+
+        /// @param attributeSizes Component count of each per-instance attribute.
+        ///        Attribute 0 is the unit quad corner (0..1); instance
+        ///        attributes follow at locations 1, 2, ...
+        /// @param setup Function binding the state for a key.
+        InstanceBatch(std::vector<int> attributeSizes, SetupFunction setup);
+        ~InstanceBatch();
+
+        InstanceBatch(const InstanceBatch&) = delete;
+        InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+        /// @brief Reserves instances, flushing whatever was open before if
+        ///        it belongs to another batch or key.
+        /// @param key State key; instances are only merged when keys match.
+        /// @param count Number of consecutive instances to reserve.
+        /// @returns Pointer to count * getInstanceFloats() floats to fill in.
+        float* append(uint64_t key, size_t count = 1);
+
+        /// @brief Draws and clears the pending instances.
+        void flush();
+
+        /// @brief Number of floats per instance.
+        int getInstanceFloats() const { return instanceFloats; }
+
+        /// @brief Number of instances waiting to be drawn.
+        size_t getPendingCount() const { return instanceFloats ? data.size() / instanceFloats : 0; }
+
+        /// @brief Releases GL resources.
+        void destroy();
+
+    private:
+        std::vector<int> sizes;
+        int instanceFloats;
+        SetupFunction setup;
+        uint64_t key;
+        std::vector<float> data;
+
+        unsigned int vao;
+        unsigned int quadVBO;
+        bool initialized;
+
+        void initialize();
+        void drawInstanced();
+        void drawExpanded();
+    };
+
+    /// @brief Draws the currently open batch, if any. Called by every
+    ///        non-batched draw and before render target changes.
+    void flushBatches();
+
+    /// @brief Releases the shared batch streaming buffer.
+    void _destroyBatches();
+
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_BATCH_HPP
@@ -0,0 +1,25 @@
+#include "antialiasing.hpp"
+
+#include "shader/batch.hpp"
+
+namespace cridgeon {
+namespace Render {
+
+    static bool shapeAntiAliasing = true;
+
+    void setShapeAntiAliasing(bool enabled) {
+        if (enabled == shapeAntiAliasing) return;
+        // Instances already queued were meant for the old setting
+        flushBatches();
+        shapeAntiAliasing = enabled;
+    }
+
+    bool getShapeAntiAliasing() {
+        return shapeAntiAliasing;
+    }
+
+    float shapeAntiAliasingUniform() {
+        return shapeAntiAliasing ? 1.0f : 0.0f;
+    }
+} // namespace Render
+} // namespace cridgeon
@@ -0,0 +1,19 @@
+#ifndef CRIDGEON_SHADER_ANTIALIASING_HPP
+#define CRIDGEON_SHADER_ANTIALIASING_HPP
+
+namespace cridgeon {
+namespace Render {
+    // Per-primitive anti-aliasing of the distance field shapes (radial
+    // shapes, rounded rects and curves). On by default. Turned off, edges
+    // are hard and the quads lose their pixel of padding, which suits scenes
+    // smoothed as a whole by PostProcessor's FXAA pass.
+    void setShapeAntiAliasing(bool enabled);
+    bool getShapeAntiAliasing();
+
+    // Value of the "antialias" uniform the shape shaders read: the edge
+    // padding in pixels, 1 or 0
+    float shapeAntiAliasingUniform();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_ANTIALIASING_HPP
@@ -0,0 +1,29 @@
+#include "arc.hpp"
+
+#include "radial.hpp"
+
+namespace cridgeon {
+namespace Render {
+
+    static const float TWO_PI = 6.28318530718f;
+
+    void arc(float x, float y, float radius, float startAngle, float endAngle, float width,
+             float r, float g, float b, float a) {
+        float halfWidth = width * 0.5f;
+        appendRadialShape(x, y, radius - halfWidth, radius + halfWidth, startAngle, endAngle - startAngle, true, r, g, b, a);
+    }
+
+    void ring(float x, float y, float innerRadius, float outerRadius, float r, float g, float b, float a) {
+        appendRadialShape(x, y, innerRadius, outerRadius, 0.0f, TWO_PI, false, r, g, b, a);
+    }
+
+    void ringSector(float x, float y, float innerRadius, float outerRadius, float startAngle, float endAngle,
+                    float r, float g, float b, float a) {
+        appendRadialShape(x, y, innerRadius, outerRadius, startAngle, endAngle - startAngle, false, r, g, b, a);
+    }
+
+    void pie(float x, float y, float radius, float startAngle, float endAngle, float r, float g, float b, float a) {
+        appendRadialShape(x, y, 0.0f, radius, startAngle, endAngle - startAngle, false, r, g, b, a);
+    }
+} // namespace Render
+} // namespace cridgeon
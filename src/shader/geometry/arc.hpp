@@ -0,0 +1,25 @@
+#ifndef CRIDGEON_SHADER_ARC_HPP
+#define CRIDGEON_SHADER_ARC_HPP
+
+namespace cridgeon {
+namespace Render {
+    // Arcs, rings and sectors share the instanced circle batch. Angles are in
+    // radians, counter-clockwise from +x.
+
+    // Stroke of the given width along a circle, with round caps
+    void arc(float x, float y, float radius, float startAngle, float endAngle, float width,
+             float r, float g, float b, float a);
+
+    // Annulus between two radii
+    void ring(float x, float y, float innerRadius, float outerRadius, float r, float g, float b, float a);
+
+    // Annulus limited to an angle range (flat ends)
+    void ringSector(float x, float y, float innerRadius, float outerRadius, float startAngle, float endAngle,
+                    float r, float g, float b, float a);
+
+    // Filled wedge of a circle
+    void pie(float x, float y, float radius, float startAngle, float endAngle, float r, float g, float b, float a);
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_ARC_HPP
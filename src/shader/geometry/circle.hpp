@@ -4,7 +4,6 @@
 namespace cridgeon {
 namespace Render {
     void circle(float x, float y, float radius, float r, float g, float b, float a);
-    void _destroyCircle();
 } // namespace Render
 } // namespace cridgeon
 
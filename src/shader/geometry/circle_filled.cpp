@@ -1,34 +1,12 @@
 #include "circle_filled.hpp"
 
-#include "rendering_system.hpp"
-#include "../shader.hpp"
-#include "../utility.hpp"
+#include "radial.hpp"
 
 namespace cridgeon {
 namespace Render {
 
-    static Shader circleFilledShader;
-
     void circleFilled(float x, float y, float radius, float r, float g, float b, float a) {
-        if (!circleFilledShader.isValid()) {
-            circleFilledShader.loadFromFile("resources/shaders/default.vert", "resources/shaders/geometry/circle_filled.frag");
-            if (!circleFilledShader.isValid()) {
-                throw std::runtime_error("Failed to load circle_filled shader");
-            }
-        }
-        circleFilledShader.use();
-        float w = RenderingSystem::getInstance().getWindowWidth();
-        float h = RenderingSystem::getInstance().getWindowHeight();
-        glUniform2f(circleFilledShader.getUniformLocation("resolution"), w, h);
-        glUniform2f(circleFilledShader.getUniformLocation("position"), x, y);
-        glUniform1f(circleFilledShader.getUniformLocation("radius"), radius);
-        glUniform4f(circleFilledShader.getUniformLocation("color"), r, g, b, a);
-
-        ShaderUtility::drawFullScreenQuad();
-    }
-
-    void _destroyCircleFilled() {
-        circleFilledShader.destroy();
+        appendRadialShape(x, y, 0.0f, radius, 0.0f, 6.28318530718f, false, r, g, b, a);
     }
 } // namespace Render
-} // namespace cridgeon
\ No newline at end of file
+} // namespace cridgeon
@@ -4,7 +4,6 @@
 namespace cridgeon {
 namespace Render {
     void circleFilled(float x, float y, float radius, float r, float g, float b, float a);
-    void _destroyCircleFilled();
 } // namespace Render
 } // namespace cridgeon
 
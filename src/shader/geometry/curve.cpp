@@ -0,0 +1,118 @@
+#include "curve.hpp"
+
+#include "antialiasing.hpp"
+#include "hit_testing.hpp"
+
+#include "rendering_system.hpp"
+#include "shader/batch.hpp"
+#include "shader/shader.hpp"
+#include "shader/utility.hpp"
+#include "software/rasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cridgeon {
+namespace Render {
+
+    static Shader curveShader;
+
+    static const int MAX_CURVE_SEGMENTS = 256;
+
+    static void setupCurves(uint64_t) {
+        curveShader.use();
+        auto& rs = RenderingSystem::getInstance();
+        glUniform2f(curveShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()),
+                    static_cast<float>(rs.getWindowHeight()));
+        glUniform1f(curveShader.getUniformLocation("antialias"), shapeAntiAliasingUniform());
+    }
+
+    // points p0 p1 (4), points p2 p3 (4), segment t0 t1 width (4), color (4)
+    static InstanceBatch curveBatch({4, 4, 4, 4}, setupCurves);
+
+    static void cubicPoint(float x0, float y0, float c1x, float c1y, float c2x, float c2y, float x1, float y1,
+                           float t, float& x, float& y) {
+        float u = 1.0f - t;
+        x = u * u * u * x0 + 3.0f * u * u * t * c1x + 3.0f * u * t * t * c2x + t * t * t * x1;
+        y = u * u * u * y0 + 3.0f * u * u * t * c1y + 3.0f * u * t * t * c2y + t * t * t * y1;
+    }
+
+    void cubicCurve(float x0, float y0, float c1x, float c1y, float c2x, float c2y, float x1, float y1,
+                    float width, float r, float g, float b, float a, float tolerance) {
+        // The curve lies inside its control polygon
+        auto& rs = RenderingSystem::getInstance();
+        float pad = width * 0.5f + 1.0f;
+        if (std::max(std::max(x0, x1), std::max(c1x, c2x)) < -pad ||
+            std::min(std::min(x0, x1), std::min(c1x, c2x)) > rs.getWindowWidth() + pad ||
+            std::max(std::max(y0, y1), std::max(c1y, c2y)) < -pad ||
+            std::min(std::min(y0, y1), std::min(c1y, c2y)) > rs.getWindowHeight() + pad) {
+            return;
+        }
+
+        // Wang's formula: segments needed to stay within the tolerance
+        float ddx0 = x0 - 2.0f * c1x + c2x, ddy0 = y0 - 2.0f * c1y + c2y;
+        float ddx1 = c1x - 2.0f * c2x + x1, ddy1 = c1y - 2.0f * c2y + y1;
+        float dd = std::sqrt(std::max(ddx0 * ddx0 + ddy0 * ddy0, ddx1 * ddx1 + ddy1 * ddy1));
+        int segments = static_cast<int>(std::ceil(std::sqrt(0.75f * dd / std::max(tolerance, 0.01f))));
+        segments = std::max(1, std::min(segments, MAX_CURVE_SEGMENTS));
+
+        // Recorded as the flattened segments, within the tolerance of the curve
+        if (HitIndex* index = hitRecorder()) {
+            float px = x0, py = y0;
+            for (int i = 1; i <= segments; ++i) {
+                float qx, qy;
+                cubicPoint(x0, y0, c1x, c1y, c2x, c2y, x1, y1, static_cast<float>(i) / segments, qx, qy);
+                index->addSegment(getHitId(), px, py, qx, qy, width);
+                px = qx;
+                py = qy;
+            }
+        }
+
+        if (rs.getBackend() == RenderBackend::SOFTWARE) {
+            const float color[4] = {r, g, b, a};
+            float px = x0, py = y0;
+            for (int i = 1; i <= segments; ++i) {
+                float qx, qy;
+                cubicPoint(x0, y0, c1x, c1y, c2x, c2y, x1, y1, static_cast<float>(i) / segments, qx, qy);
+                SoftwareRasterizer::getInstance().segment(px, py, qx, qy, width, color);
+                px = qx;
+                py = qy;
+            }
+            return;
+        }
+
+        if (!curveShader.isValid()) {
+            curveShader.loadFromFile("resources/shaders/instanced/curve.vert", "resources/shaders/instanced/curve.frag",
+                                     {"corner", "points01", "points23", "segment", "color"});
+            if (!curveShader.isValid()) {
+                throw std::runtime_error("Failed to load curve shader");
+            }
+        }
+
+        float* instance = curveBatch.append(0, segments);
+        for (int i = 0; i < segments; ++i, instance += 16) {
+            instance[0] = x0;   instance[1] = y0;   instance[2] = c1x;  instance[3] = c1y;
+            instance[4] = c2x;  instance[5] = c2y;  instance[6] = x1;   instance[7] = y1;
+            instance[8] = static_cast<float>(i) / segments;
+            instance[9] = static_cast<float>(i + 1) / segments;
+            instance[10] = width; instance[11] = 0.0f;
+            instance[12] = r;   instance[13] = g;   instance[14] = b;   instance[15] = a;
+        }
+    }
+
+    void quadraticCurve(float x0, float y0, float cx, float cy, float x1, float y1,
+                        float width, float r, float g, float b, float a, float tolerance) {
+        // Degree elevation: the same curve as a cubic
+        const float k = 2.0f / 3.0f;
+        cubicCurve(x0, y0, x0 + k * (cx - x0), y0 + k * (cy - y0),
+                   x1 + k * (cx - x1), y1 + k * (cy - y1), x1, y1,
+                   width, r, g, b, a, tolerance);
+    }
+
+    void _destroyCurve() {
+        curveBatch.destroy();
+        curveShader.destroy();
+    }
+} // namespace Render
+} // namespace cridgeon
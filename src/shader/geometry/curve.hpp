@@ -0,0 +1,24 @@
+#ifndef CRIDGEON_SHADER_CURVE_HPP
+#define CRIDGEON_SHADER_CURVE_HPP
+
+namespace cridgeon {
+namespace Render {
+    // Stroked Bézier curves, evaluated on the GPU. The CPU only picks a
+    // segment count from the curve's screen-space size (`tolerance` is the
+    // maximum deviation in pixels); the count grows with the square root of
+    // the zoom, up to 256 batched instances per curve.
+    //
+    // Each segment is a separate quad. Neighbours share their end edges, but
+    // on the inside of bends tighter than half the stroke width, and where
+    // the curve crosses itself, quads overlap and a translucent stroke is
+    // blended twice there. Draw such strokes opaque into a Layer and
+    // composite it with the opacity instead.
+    void quadraticCurve(float x0, float y0, float cx, float cy, float x1, float y1,
+                        float width, float r, float g, float b, float a, float tolerance = 0.25f);
+    void cubicCurve(float x0, float y0, float c1x, float c1y, float c2x, float c2y, float x1, float y1,
+                    float width, float r, float g, float b, float a, float tolerance = 0.25f);
+    void _destroyCurve();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_CURVE_HPP
@@ -3,22 +3,32 @@
 
 #include "circle.hpp"
 #include "circle_filled.hpp"
+#include "arc.hpp"
+#include "radial.hpp"
 #include "polygon.hpp"
 #include "polygon_filled.hpp"
+#include "triangulate.hpp"
 #include "line.hpp"
 #include "lines.hpp"
+#include "curve.hpp"
+#include "rect.hpp"
 #include "texture_quad.hpp"
+#include "antialiasing.hpp"
+#include "hit_testing.hpp"
+#include "shader/batch.hpp"
 
 namespace cridgeon {
 namespace Render {
     inline void destroyGeometryShaders() {
-        _destroyCircle();
-        _destroyCircleFilled();
+        _destroyRadial();     // Also covers circle() and circleFilled()
         _destroyPolygon();
         _destroyPolygonFilled();
         _destroyLine();
         _destroyLines();
+        _destroyCurve();
+        _destroyRect();
         _destroyTextureQuad();
+        _destroyBatches();
     }
 } // namespace Render
 } // namespace cridgeon
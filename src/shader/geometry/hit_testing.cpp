@@ -0,0 +1,29 @@
+#include "hit_testing.hpp"
+
+namespace cridgeon {
+namespace Render {
+
+    static HitIndex* hitIndex = nullptr;
+    static HitIndex::Id hitId = 0;
+
+    void setHitIndex(HitIndex* index) {
+        hitIndex = index;
+    }
+
+    HitIndex* getHitIndex() {
+        return hitIndex;
+    }
+
+    void setHitId(HitIndex::Id id) {
+        hitId = id;
+    }
+
+    HitIndex::Id getHitId() {
+        return hitId;
+    }
+
+    HitIndex* hitRecorder() {
+        return hitId != 0 ? hitIndex : nullptr;
+    }
+} // namespace Render
+} // namespace cridgeon
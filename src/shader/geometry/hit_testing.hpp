@@ -0,0 +1,23 @@
+#ifndef CRIDGEON_SHADER_HIT_TESTING_HPP
+#define CRIDGEON_SHADER_HIT_TESTING_HPP
+
+#include "hit_index.hpp"
+
+namespace cridgeon {
+namespace Render {
+    // While an index is set, the drawing functions also record their shapes
+    // into it under the current hit id, on either backend. Shapes drawn with
+    // the id 0 are not recorded. Pass nullptr to stop recording.
+    void setHitIndex(HitIndex* index);
+    HitIndex* getHitIndex();
+
+    void setHitId(HitIndex::Id id);
+    HitIndex::Id getHitId();
+
+    // The index to record the next shape into, or nullptr when recording is
+    // off or the id is 0
+    HitIndex* hitRecorder();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_HIT_TESTING_HPP
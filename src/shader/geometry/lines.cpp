@@ -1,8 +1,12 @@
 #include "lines.hpp"
+#include "hit_testing.hpp"
 
 #include "rendering_system.hpp"
 #include "shader/shader.hpp"
 #include "shader/utility.hpp"
+#include "shader/batch.hpp"
+#include "stream_buffer.hpp"
+#include "software/rasterizer.hpp"
 
 namespace cridgeon {
 namespace Render {
@@ -10,12 +14,27 @@ namespace Render {
     static Shader linesShader;
     static bool linesVAOInitialized = false;
     static unsigned int linesVAO = 0;
-    static unsigned int linesVBO = 0;
+    static StreamBuffer linesStream;
 
     void lines(const std::vector<float>& vertices, float r, float g, float b, float a) {
         if (vertices.size() < 4) return; // Need at least 2 vertices (4 floats) for one line
         if (vertices.size() > 512) return; // Max 128 lines * 2 vertices * 2 coords = 512 floats
 
+        if (HitIndex* index = hitRecorder()) {
+            for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+                index->addSegment(getHitId(), vertices[i], vertices[i + 1], vertices[i + 2], vertices[i + 3], 1.0f);
+            }
+        }
+
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            // GL_LINES are one pixel wide
+            const float color[4] = {r, g, b, a};
+            for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+                SoftwareRasterizer::getInstance().segment(vertices[i], vertices[i + 1], vertices[i + 2], vertices[i + 3], 1.0f, color);
+            }
+            return;
+        }
+
         // Load shader if not already loaded
         if (!linesShader.isValid()) {
             linesShader.loadFromFile("resources/shaders/default.vert", "resources/shaders/geometry/color.frag");
@@ -27,7 +46,7 @@ namespace Render {
         // Initialize VAO/VBO if needed
         if (!linesVAOInitialized) {
             glGenVertexArrays(1, &linesVAO);
-            glGenBuffers(1, &linesVBO);
+            linesStream.create(256 * 1024);
             linesVAOInitialized = true;
         }
 
@@ -45,15 +64,15 @@ namespace Render {
             screenCoords.push_back(y);
         }
 
+        flushBatches();
         linesShader.use();
         glUniform2f(linesShader.getUniformLocation("resolution"), w, h);
         glUniform4f(linesShader.getUniformLocation("color"), r, g, b, a);
 
         glBindVertexArray(linesVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, linesVBO);
-        glBufferData(GL_ARRAY_BUFFER, screenCoords.size() * sizeof(float), screenCoords.data(), GL_DYNAMIC_DRAW);
+        size_t offset = linesStream.write(screenCoords.data(), screenCoords.size() * sizeof(float));
 
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)offset);
         glEnableVertexAttribArray(0);
 
         glDrawArrays(GL_LINES, 0, screenCoords.size() / 2);
@@ -65,7 +84,7 @@ namespace Render {
         linesShader.destroy();
         if (linesVAOInitialized) {
             glDeleteVertexArrays(1, &linesVAO);
-            glDeleteBuffers(1, &linesVBO);
+            linesStream.destroy();
             linesVAOInitialized = false;
         }
     }
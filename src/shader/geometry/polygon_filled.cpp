@@ -1,8 +1,16 @@
 #include "polygon_filled.hpp"
+#include "triangulate.hpp"
+#include "hit_testing.hpp"
 
 #include "rendering_system.hpp"
 #include "shader/shader.hpp"
 #include "shader/utility.hpp"
+#include "gl_capabilities.hpp"
+#include "shader/batch.hpp"
+#include "stream_buffer.hpp"
+#include "software/rasterizer.hpp"
+
+#include <cstdint>
 
 namespace cridgeon {
 namespace Render {
@@ -10,127 +18,34 @@ namespace Render {
     static Shader polygonFilledShader;
     static bool polygonVAOInitialized = false;
     static unsigned int polygonVAO = 0;
-    static unsigned int polygonVBO = 0;
-
-    // Helper function to calculate cross product (for determining triangle orientation)
-    static float cross2D(float x1, float y1, float x2, float y2) {
-        return x1 * y2 - x2 * y1;
-    }
-
-    // Check if point P is inside triangle ABC
-    static bool isPointInTriangle(float px, float py, 
-                                   float ax, float ay, 
-                                   float bx, float by, 
-                                   float cx, float cy) {
-        float v0x = cx - ax, v0y = cy - ay;
-        float v1x = bx - ax, v1y = by - ay;
-        float v2x = px - ax, v2y = py - ay;
-
-        float dot00 = v0x * v0x + v0y * v0y;
-        float dot01 = v0x * v1x + v0y * v1y;
-        float dot02 = v0x * v2x + v0y * v2y;
-        float dot11 = v1x * v1x + v1y * v1y;
-        float dot12 = v1x * v2x + v1y * v2y;
-
-        float invDenom = 1.0f / (dot00 * dot11 - dot01 * dot01);
-        float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
-        float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
-
-        return (u >= 0) && (v >= 0) && (u + v < 1);
-    }
-
-    // Check if ear at index i is valid (no other vertices inside)
-    static bool isEar(const std::vector<float>& vertices, const std::vector<int>& indices, int i) {
-        int n = indices.size();
-        int prev = (i - 1 + n) % n;
-        int next = (i + 1) % n;
-
-        int i0 = indices[prev];
-        int i1 = indices[i];
-        int i2 = indices[next];
-
-        float x0 = vertices[i0 * 2], y0 = vertices[i0 * 2 + 1];
-        float x1 = vertices[i1 * 2], y1 = vertices[i1 * 2 + 1];
-        float x2 = vertices[i2 * 2], y2 = vertices[i2 * 2 + 1];
-
-        // Check if triangle is counter-clockwise (convex at this vertex)
-        float cross = cross2D(x1 - x0, y1 - y0, x2 - x1, y2 - y1);
-        if (cross <= 0) return false; // Reflex vertex
-
-        // Check if any other vertex is inside this triangle
-        for (int j = 0; j < n; j++) {
-            if (j == prev || j == i || j == next) continue;
-            int idx = indices[j];
-            float px = vertices[idx * 2];
-            float py = vertices[idx * 2 + 1];
-            if (isPointInTriangle(px, py, x0, y0, x1, y1, x2, y2)) {
-                return false;
-            }
-        }
-
-        return true;
-    }
+    static StreamBuffer polygonStream;
 
-    // Triangulate polygon using ear clipping algorithm
-    static std::vector<float> triangulatePolygon(const std::vector<float>& vertices) {
-        int n = vertices.size() / 2;
-        if (n < 3) return {};
+    static Shader polygonsFilledShader;
+    static unsigned int polygonsVAO = 0;
+    static StreamBuffer indirectStream;
 
-        std::vector<int> indices;
-        for (int i = 0; i < n; i++) {
-            indices.push_back(i);
-        }
+    // Layout of one glMultiDrawArraysIndirect command
+    struct DrawArraysIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t first;
+        uint32_t baseInstance;
+    };
 
-        std::vector<float> triangles;
-
-        while (indices.size() > 3) {
-            bool earFound = false;
-
-            for (int i = 0; i < indices.size(); i++) {
-                if (isEar(vertices, indices, i)) {
-                    int prev = (i - 1 + indices.size()) % indices.size();
-                    int next = (i + 1) % indices.size();
-
-                    // Add triangle
-                    int i0 = indices[prev];
-                    int i1 = indices[i];
-                    int i2 = indices[next];
-
-                    triangles.push_back(vertices[i0 * 2]);
-                    triangles.push_back(vertices[i0 * 2 + 1]);
-                    triangles.push_back(vertices[i1 * 2]);
-                    triangles.push_back(vertices[i1 * 2 + 1]);
-                    triangles.push_back(vertices[i2 * 2]);
-                    triangles.push_back(vertices[i2 * 2 + 1]);
-
-                    // Remove the ear
-                    indices.erase(indices.begin() + i);
-                    earFound = true;
-                    break;
-                }
-            }
+    void polygonFilled(const std::vector<float>& vertices, float r, float g, float b, float a) {
+        if (vertices.size() < 6) return; // Need at least 3 vertices (6 floats)
 
-            if (!earFound) {
-                // Fallback: just emit remaining triangle if algorithm fails
-                break;
-            }
+        if (HitIndex* index = hitRecorder()) {
+            index->addPolygon(getHitId(), vertices.data(), vertices.size() / 2);
         }
 
-        // Add the last triangle
-        if (indices.size() == 3) {
-            for (int i = 0; i < 3; i++) {
-                int idx = indices[i];
-                triangles.push_back(vertices[idx * 2]);
-                triangles.push_back(vertices[idx * 2 + 1]);
-            }
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            // Filled directly by winding, no triangulation needed
+            const float color[4] = {r, g, b, a};
+            SoftwareRasterizer::getInstance().polygon(vertices.data(), vertices.size() / 2, color);
+            return;
         }
 
-        return triangles;
-    }
-
-    void polygonFilled(const std::vector<float>& vertices, float r, float g, float b, float a) {
-        if (vertices.size() < 6) return; // Need at least 3 vertices (6 floats)
-
         // Triangulate the polygon
         std::vector<float> triangles = triangulatePolygon(vertices);
         if (triangles.empty()) return;
@@ -161,20 +76,21 @@ namespace Render {
         // Initialize VAO/VBO if needed
         if (!polygonVAOInitialized) {
             glGenVertexArrays(1, &polygonVAO);
-            glGenBuffers(1, &polygonVBO);
+            glGenVertexArrays(1, &polygonsVAO);
+            polygonStream.create(1024 * 1024);
             polygonVAOInitialized = true;
         }
 
+        flushBatches();
         polygonFilledShader.use();
         glUniform2f(polygonFilledShader.getUniformLocation("resolution"), w, h);
         glUniform4f(polygonFilledShader.getUniformLocation("color"), r, g, b, a);
 
         // Upload triangle data
         glBindVertexArray(polygonVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, polygonVBO);
-        glBufferData(GL_ARRAY_BUFFER, screenCoords.size() * sizeof(float), screenCoords.data(), GL_DYNAMIC_DRAW);
+        size_t offset = polygonStream.write(screenCoords.data(), screenCoords.size() * sizeof(float));
 
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)offset);
         glEnableVertexAttribArray(0);
 
         glDrawArrays(GL_TRIANGLES, 0, screenCoords.size() / 2);
@@ -182,11 +98,117 @@ namespace Render {
         glBindVertexArray(0);
     }
 
+    void polygonsFilled(const std::vector<std::vector<float>>& polygons, const std::vector<float>& colors) {
+        if (polygons.empty() || colors.size() < polygons.size() * 4) return;
+
+        // Polygon p is recorded as the hit id + p
+        if (HitIndex* index = hitRecorder()) {
+            for (size_t p = 0; p < polygons.size(); ++p) {
+                index->addPolygon(getHitId() + p, polygons[p].data(), polygons[p].size() / 2);
+            }
+        }
+
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            for (size_t p = 0; p < polygons.size(); ++p) {
+                SoftwareRasterizer::getInstance().polygon(polygons[p].data(), polygons[p].size() / 2, &colors[p * 4]);
+            }
+            return;
+        }
+
+        float w = RenderingSystem::getInstance().getWindowWidth();
+        float h = RenderingSystem::getInstance().getWindowHeight();
+
+        // Triangulate everything into one vertex array, remembering the range of each polygon
+        std::vector<float> screenCoords;
+        std::vector<DrawArraysIndirectCommand> commands;
+        commands.reserve(polygons.size());
+        for (size_t p = 0; p < polygons.size(); ++p) {
+            if (polygons[p].size() < 6) continue;
+            std::vector<float> triangles = triangulatePolygon(polygons[p]);
+            if (triangles.empty()) continue;
+
+            DrawArraysIndirectCommand command;
+            command.count = static_cast<uint32_t>(triangles.size() / 2);
+            command.instanceCount = 1;
+            command.first = static_cast<uint32_t>(screenCoords.size() / 2);
+            command.baseInstance = static_cast<uint32_t>(p); // Selects the polygon's color
+            commands.push_back(command);
+
+            for (size_t i = 0; i < triangles.size(); i += 2) {
+                screenCoords.push_back((triangles[i] / w) * 2.0f - 1.0f);
+                screenCoords.push_back((triangles[i + 1] / h) * 2.0f - 1.0f);
+            }
+        }
+        if (commands.empty()) return;
+
+        if (!polygonsFilledShader.isValid()) {
+            polygonsFilledShader.loadFromFile("resources/shaders/geometry/vertex_color.vert", "resources/shaders/geometry/vertex_color.frag",
+                                              {"position", "vertexColor"});
+            if (!polygonsFilledShader.isValid()) {
+                throw std::runtime_error("Failed to load polygons_filled shader");
+            }
+        }
+
+        if (!polygonVAOInitialized) {
+            glGenVertexArrays(1, &polygonVAO);
+            glGenVertexArrays(1, &polygonsVAO);
+            polygonStream.create(1024 * 1024);
+            polygonVAOInitialized = true;
+        }
+
+        flushBatches();
+        polygonsFilledShader.use();
+        glUniform2f(polygonsFilledShader.getUniformLocation("resolution"), w, h);
+
+        // The fast path reads the colors from the same upload, after the
+        // vertices padded to 16 bytes. A second write could orphan or grow the
+        // buffer under the vertex pointer.
+        const GLCapabilities& caps = glCapabilities();
+        bool multiDraw = caps.multiDrawIndirect && caps.instancedArrays;
+        size_t colorStart = (screenCoords.size() + 3) / 4 * 4;
+        if (multiDraw) {
+            screenCoords.resize(colorStart, 0.0f);
+            screenCoords.insert(screenCoords.end(), colors.begin(), colors.begin() + polygons.size() * 4);
+        }
+
+        glBindVertexArray(polygonsVAO);
+        size_t vertexOffset = polygonStream.write(screenCoords.data(), screenCoords.size() * sizeof(float));
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)vertexOffset);
+        glEnableVertexAttribArray(0);
+
+        if (multiDraw) {
+            // Fast path: one call for every polygon, colors fetched per instance via baseInstance
+            size_t colorOffset = vertexOffset + colorStart * sizeof(float);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)colorOffset);
+            glVertexAttribDivisor(1, 1);
+            glEnableVertexAttribArray(1);
+
+            if (!indirectStream.isValid()) {
+                indirectStream.create(64 * 1024, StreamBuffer::Target::INDIRECT);
+            }
+            size_t commandOffset = indirectStream.write(commands.data(), commands.size() * sizeof(DrawArraysIndirectCommand));
+            glExt().MultiDrawArraysIndirect(GL_TRIANGLES, (void*)commandOffset, static_cast<GLsizei>(commands.size()), 0);
+        } else {
+            // GL 3.0 path: same uploaded vertices, color as a constant attribute per draw
+            glDisableVertexAttribArray(1);
+            for (const DrawArraysIndirectCommand& command : commands) {
+                const float* c = &colors[command.baseInstance * 4];
+                glVertexAttrib4f(1, c[0], c[1], c[2], c[3]);
+                glDrawArrays(GL_TRIANGLES, command.first, command.count);
+            }
+        }
+
+        glBindVertexArray(0);
+    }
+
     void _destroyPolygonFilled() {
         polygonFilledShader.destroy();
+        polygonsFilledShader.destroy();
         if (polygonVAOInitialized) {
             glDeleteVertexArrays(1, &polygonVAO);
-            glDeleteBuffers(1, &polygonVBO);
+            glDeleteVertexArrays(1, &polygonsVAO);
+            polygonStream.destroy();
+            indirectStream.destroy();
             polygonVAOInitialized = false;
         }
     }
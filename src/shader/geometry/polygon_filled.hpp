@@ -6,6 +6,10 @@
 namespace cridgeon {
 namespace Render {
     void polygonFilled(const std::vector<float>& vertices, float r, float g, float b, float a);
+
+    // Fill many polygons in one submission. `colors` holds 4 floats (rgba) per
+    // polygon. Uses a single multi-draw-indirect call on GL 4.3+.
+    void polygonsFilled(const std::vector<std::vector<float>>& polygons, const std::vector<float>& colors);
     void _destroyPolygonFilled();
 } // namespace Render
 } // namespace cridgeon
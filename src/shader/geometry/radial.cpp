@@ -0,0 +1,113 @@
+#include "radial.hpp"
+
+#include "antialiasing.hpp"
+#include "hit_testing.hpp"
+
+#include "rendering_system.hpp"
+#include "shader/batch.hpp"
+#include "shader/shader.hpp"
+#include "shader/utility.hpp"
+#include "software/rasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cridgeon {
+namespace Render {
+
+    static const float TWO_PI = 6.28318530718f;
+
+    static Shader radialShader;
+
+    static void setupRadial(uint64_t) {
+        radialShader.use();
+        auto& rs = RenderingSystem::getInstance();
+        glUniform2f(radialShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()),
+                    static_cast<float>(rs.getWindowHeight()));
+        glUniform1f(radialShader.getUniformLocation("antialias"), shapeAntiAliasingUniform());
+    }
+
+    // bounds (4), shape: center, outer, inner radius (4), sector: start, span, caps (4), color (4)
+    static InstanceBatch radialBatch({4, 4, 4, 4}, setupRadial);
+
+    /// @brief Extends a bounding box with a point.
+    static void include(float bounds[4], float x, float y) {
+        bounds[0] = std::min(bounds[0], x);
+        bounds[1] = std::min(bounds[1], y);
+        bounds[2] = std::max(bounds[2], x);
+        bounds[3] = std::max(bounds[3], y);
+    }
+
+    void appendRadialShape(float x, float y, float innerRadius, float outerRadius,
+                           float startAngle, float span, bool roundCaps,
+                           float r, float g, float b, float a) {
+        if (HitIndex* index = hitRecorder()) {
+            index->addRadial(getHitId(), x, y, innerRadius, outerRadius, startAngle, span, roundCaps);
+        }
+
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            const float color[4] = {r, g, b, a};
+            SoftwareRasterizer::getInstance().radial(x, y, innerRadius, outerRadius, startAngle, span, roundCaps, color);
+            return;
+        }
+
+        if (!radialShader.isValid()) {
+            radialShader.loadFromFile("resources/shaders/instanced/radial.vert", "resources/shaders/instanced/radial.frag",
+                                      {"corner", "bounds", "shape", "sector", "color"});
+            if (!radialShader.isValid()) {
+                throw std::runtime_error("Failed to load radial shader");
+            }
+        }
+
+        innerRadius = std::max(innerRadius, 0.0f);
+        if (outerRadius <= innerRadius) return;
+        if (span < 0.0f) {
+            startAngle += span;
+            span = -span;
+        }
+        bool fullCircle = span >= TWO_PI;
+
+        // Tight bounds: sector end points, axis extremes inside the span and caps
+        float bounds[4] = {x, y, x, y};
+        if (fullCircle) {
+            include(bounds, x - outerRadius, y - outerRadius);
+            include(bounds, x + outerRadius, y + outerRadius);
+        } else {
+            float ends[2] = {startAngle, startAngle + span};
+            for (float angle : ends) {
+                float c = std::cos(angle), s = std::sin(angle);
+                include(bounds, x + c * outerRadius, y + s * outerRadius);
+                include(bounds, x + c * innerRadius, y + s * innerRadius);
+                if (roundCaps) {
+                    float middle = (innerRadius + outerRadius) * 0.5f;
+                    float capRadius = (outerRadius - innerRadius) * 0.5f;
+                    include(bounds, x + c * middle - capRadius, y + s * middle - capRadius);
+                    include(bounds, x + c * middle + capRadius, y + s * middle + capRadius);
+                }
+            }
+            float first = std::ceil(startAngle / (TWO_PI / 4.0f));
+            for (float quarter = first; quarter * (TWO_PI / 4.0f) <= startAngle + span; quarter += 1.0f) {
+                float angle = quarter * (TWO_PI / 4.0f);
+                include(bounds, x + std::cos(angle) * outerRadius, y + std::sin(angle) * outerRadius);
+            }
+        }
+
+        float* instance = radialBatch.append(0);
+        instance[0] = bounds[0];    instance[1] = bounds[1];
+        instance[2] = bounds[2];    instance[3] = bounds[3];
+        instance[4] = x;            instance[5] = y;
+        instance[6] = outerRadius;  instance[7] = innerRadius;
+        instance[8] = startAngle;   instance[9] = fullCircle ? TWO_PI : span;
+        instance[10] = roundCaps ? 1.0f : 0.0f;
+        instance[11] = 0.0f;
+        instance[12] = r;           instance[13] = g;
+        instance[14] = b;           instance[15] = a;
+    }
+
+    void _destroyRadial() {
+        radialBatch.destroy();
+        radialShader.destroy();
+    }
+} // namespace Render
+} // namespace cridgeon
@@ -0,0 +1,20 @@
+#ifndef CRIDGEON_SHADER_RADIAL_HPP
+#define CRIDGEON_SHADER_RADIAL_HPP
+
+namespace cridgeon {
+namespace Render {
+    // Shared instanced batch behind circles, rings, arcs and pie sectors.
+    // Every shape is an annular sector evaluated as a signed distance field
+    // over its bounding box, so cost scales with covered pixels.
+    //
+    // Angles are in radians, counter-clockwise from +x; a span of 2*pi or
+    // more draws the full ring. With roundCaps the ends of the sector are
+    // capped with half circles (used for arc strokes).
+    void appendRadialShape(float x, float y, float innerRadius, float outerRadius,
+                           float startAngle, float span, bool roundCaps,
+                           float r, float g, float b, float a);
+    void _destroyRadial();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_RADIAL_HPP
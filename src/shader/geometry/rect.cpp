@@ -0,0 +1,73 @@
+#include "rect.hpp"
+
+#include "antialiasing.hpp"
+#include "hit_testing.hpp"
+
+#include "rendering_system.hpp"
+#include "shader/batch.hpp"
+#include "shader/shader.hpp"
+#include "shader/utility.hpp"
+#include "software/rasterizer.hpp"
+
+namespace cridgeon {
+namespace Render {
+
+    static Shader rectShader;
+
+    static void setupRects(uint64_t) {
+        rectShader.use();
+        auto& rs = RenderingSystem::getInstance();
+        glUniform2f(rectShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()),
+                    static_cast<float>(rs.getWindowHeight()));
+        glUniform1f(rectShader.getUniformLocation("antialias"), shapeAntiAliasingUniform());
+    }
+
+    // rect (4), radii (4), fill color (4), border color (4), border width (1)
+    static InstanceBatch rectBatch({4, 4, 4, 4, 1}, setupRects);
+
+    void roundedRect(float x, float y, float w, float h, const float radii[4],
+                     float borderWidth, const float fillColor[4], const float borderColor[4]) {
+        if (HitIndex* index = hitRecorder()) {
+            index->addRoundedRect(getHitId(), x, y, w, h, radii);
+        }
+
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            SoftwareRasterizer::getInstance().roundedRect(x, y, w, h, radii, borderWidth, fillColor, borderColor);
+            return;
+        }
+
+        if (!rectShader.isValid()) {
+            rectShader.loadFromFile("resources/shaders/instanced/rounded_rect.vert", "resources/shaders/instanced/rounded_rect.frag",
+                                    {"corner", "rect", "radii", "fillColor", "borderColor", "borderWidth"});
+            if (!rectShader.isValid()) {
+                throw std::runtime_error("Failed to load rounded rect shader");
+            }
+        }
+
+        float* instance = rectBatch.append(0);
+        instance[0] = x;  instance[1] = y;  instance[2] = w;  instance[3] = h;
+        for (int i = 0; i < 4; ++i) {
+            instance[4 + i] = radii[i];
+            instance[8 + i] = fillColor[i];
+            instance[12 + i] = borderColor[i];
+        }
+        instance[16] = borderWidth;
+    }
+
+    void roundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a) {
+        const float radii[4] = {radius, radius, radius, radius};
+        const float color[4] = {r, g, b, a};
+        roundedRect(x, y, w, h, radii, 0.0f, color, color);
+    }
+
+    void rect(float x, float y, float w, float h, float r, float g, float b, float a) {
+        roundedRect(x, y, w, h, 0.0f, r, g, b, a);
+    }
+
+    void _destroyRect() {
+        rectBatch.destroy();
+        rectShader.destroy();
+    }
+} // namespace Render
+} // namespace cridgeon
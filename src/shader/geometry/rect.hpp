@@ -0,0 +1,20 @@
+#ifndef CRIDGEON_SHADER_RECT_HPP
+#define CRIDGEON_SHADER_RECT_HPP
+
+namespace cridgeon {
+namespace Render {
+    // Rectangles are batched: consecutive rects are drawn with one instanced
+    // call and anti-aliased with a signed distance function. (x, y) is the
+    // bottom-left corner.
+    void rect(float x, float y, float w, float h, float r, float g, float b, float a);
+    void roundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a);
+
+    // Per-corner radii are ordered bottom-left, bottom-right, top-right,
+    // top-left. The border is drawn inside the shape; a width of 0 disables it.
+    void roundedRect(float x, float y, float w, float h, const float radii[4],
+                     float borderWidth, const float fillColor[4], const float borderColor[4]);
+    void _destroyRect();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_RECT_HPP
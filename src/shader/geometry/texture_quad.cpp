@@ -1,127 +1,133 @@
 /// @file texture_quad.cpp
 /// @author Charlie Ridgeon
 /// @date Created: 2026-02-19
-/// @date Updated: 2026-02-19
+/// @date Updated: 2026-10-18
 /// @brief Implementation of textured quad rendering with OpenGL.
-///        Handles initialization, rendering, and cleanup of texture quads.
+///        Quads are appended to an instanced batch and drawn together with
+///        every following quad that uses the same texture and sampler.
 
 #include "texture_quad.hpp"
+#include "hit_testing.hpp"
 
 #include "rendering_system.hpp"
 #include "shader/shader.hpp"
 #include "shader/utility.hpp"
+#include "shader/batch.hpp"
+#include "texture/sampler.hpp"
+#include "software/rasterizer.hpp"
 
 namespace cridgeon {
 namespace Render {
 
     static Shader textureQuadShader;
 
-    /// @brief Initialize the texture quad VAO and shader if needed.
-    static bool initializeTextureQuad(
-        unsigned int& vao, unsigned int& vbo, unsigned int& ebo,
-        float x, float y, float w, float h
-    ) {
-        // Load shader (using default.vert)
-        if (!textureQuadShader.isValid() && !textureQuadShader.loadFromFile(
-            "resources/shaders/default.vert", 
-            "resources/shaders/texture.frag")) {
-            std::cerr << "Failed to load texture quad shader" << std::endl;
-            return false;
-        }
+    static const uint64_t HAS_SAMPLER_BIT = 1ull << 31;
 
-        // Create and bind VAO
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
+    /// @brief Binds the shader, texture and sampler encoded in a batch key.
+    static void setupTextureQuads(uint64_t key) {
+        unsigned int textureID = static_cast<unsigned int>(key >> 32);
 
-        // Define quad vertices (positions only, texture coords calculated in shader)
-        float vertices[] = {
-            // Position (will be transformed to rect coordinates)
-            0.0f, 0.0f,  // Bottom-left
-            1.0f, 0.0f,  // Bottom-right  
-            1.0f, 1.0f,  // Top-right
-            0.0f, 1.0f   // Top-left
-        };
+        textureQuadShader.use();
 
         auto& rs = RenderingSystem::getInstance();
-        for (int i = 0; i < 4; ++i) {
-            vertices[i * 2] =     (((vertices[i * 2]    ) * w + x) / rs.getWindowWidth() ) * 2.0 - 1.0;
-            vertices[i * 2 + 1] = (((vertices[i * 2 + 1]) * h + y) / rs.getWindowHeight()) * 2.0 - 1.0;
+        glUniform2f(textureQuadShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()),
+                    static_cast<float>(rs.getWindowHeight()));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        if (key & HAS_SAMPLER_BIT) {
+            SamplerState sampler;
+            sampler.min_filter = static_cast<Texture::Filter>(key & 0xF);
+            sampler.mag_filter = static_cast<Texture::Filter>((key >> 4) & 0xF);
+            sampler.wrap_s = static_cast<Texture::Wrap>((key >> 8) & 0xF);
+            sampler.wrap_t = static_cast<Texture::Wrap>((key >> 12) & 0xF);
+            SamplerCache::getInstance().bind(0, sampler, textureID);
+        } else {
+            SamplerCache::getInstance().unbind(0, textureID);
         }
+        glUniform1i(textureQuadShader.getUniformLocation("textureSampler"), 0);
+    }
+
+    // rect (4), subtexture (4), tint (4)
+    static InstanceBatch textureQuadBatch({4, 4, 4}, setupTextureQuads);
 
-        // Define indices for two triangles
-        unsigned int indices[] = {
-            0, 1, 2,  // First triangle
-            2, 3, 0   // Second triangle
-        };
-
-        // Create and set up VBO
-        glGenBuffers(1, &vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-        // Create and set up EBO
-        glGenBuffers(1, &ebo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-        // Position attribute (only attribute needed for default.vert)
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+    /// @brief Load the texture quad shader if needed.
+    static bool initializeTextureQuad() {
+        if (!textureQuadShader.isValid() && !textureQuadShader.loadFromFile(
+            "resources/shaders/instanced/texture_quad.vert",
+            "resources/shaders/instanced/texture_quad.frag",
+            {"corner", "rect", "subtexture", "tint"})) {
+            std::cerr << "Failed to load texture quad shader" << std::endl;
+            return false;
+        }
         return true;
     }
 
-    void textureQuad(unsigned int textureID, 
-                     float x, float y, float w, float h,
-                     float subX, float subY, float subW, float subH,
-                     float r, float g, float b, float a) {
-        
-        // Initialize if needed
-
-        unsigned int textureVAO, textureVBO, textureEBO;
-        if (!initializeTextureQuad(
-            textureVAO, textureVBO, textureEBO, 
-            x, y, w, h
-        )) {
-            std::cerr << "Texture quad shader is not valid" << std::endl;
+    /// @brief Appends a textured quad to the batch, optionally with an explicit sampler state.
+    static void drawTextureQuad(unsigned int textureID, const SamplerState* sampler,
+                                float x, float y, float w, float h,
+                                float subX, float subY, float subW, float subH,
+                                float r, float g, float b, float a) {
+        if (HitIndex* index = hitRecorder()) {
+            index->addBox(getHitId(), x, y, w, h);
+        }
+
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            float* quad = SoftwareRasterizer::getInstance().texturedQuads(textureID, 1, sampler);
+            if (!quad) return;
+            quad[0] = x;    quad[1] = y;    quad[2] = w;    quad[3] = h;
+            quad[4] = subX; quad[5] = subY; quad[6] = subW; quad[7] = subH;
+            quad[8] = r;    quad[9] = g;    quad[10] = b;   quad[11] = a;
             return;
         }
 
-        // Use shader program
-        textureQuadShader.use();
+        if (!initializeTextureQuad()) {
+            std::cerr << "Texture quad shader is not valid" << std::endl;
+            return;
+        }
 
-        // Get rendering system for resolution
-        auto& rs = RenderingSystem::getInstance();
-        
-        // Set uniforms
-        glUniform2f(glGetUniformLocation(textureQuadShader.getID(), "resolution"), 
-                    static_cast<float>(rs.getWindowWidth()), 
-                    static_cast<float>(rs.getWindowHeight()));
+        uint64_t key = static_cast<uint64_t>(textureID) << 32;
+        if (sampler) {
+            key |= HAS_SAMPLER_BIT | sampler->key();
+        }
 
-        glUniform4f(glGetUniformLocation(textureQuadShader.getID(), "rect"), x, y, w, h);
-        glUniform4f(glGetUniformLocation(textureQuadShader.getID(), "subtexture"), subX, subY, subW, subH);
-        glUniform4f(glGetUniformLocation(textureQuadShader.getID(), "color"), r, g, b, a);
+        float* instance = textureQuadBatch.append(key);
+        instance[0] = x;    instance[1] = y;    instance[2] = w;    instance[3] = h;
+        instance[4] = subX; instance[5] = subY; instance[6] = subW; instance[7] = subH;
+        instance[8] = r;    instance[9] = g;    instance[10] = b;   instance[11] = a;
+    }
 
-        // Bind texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glUniform1i(glGetUniformLocation(textureQuadShader.getID(), "textureSampler"), 0);
+    void textureQuad(unsigned int textureID,
+                     float x, float y, float w, float h,
+                     float subX, float subY, float subW, float subH,
+                     float r, float g, float b, float a) {
+        drawTextureQuad(textureID, nullptr, x, y, w, h, subX, subY, subW, subH, r, g, b, a);
+    }
 
-        // Bind VAO and draw
-        glBindVertexArray(textureVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    void textureQuad(unsigned int textureID, const SamplerState& sampler,
+                     float x, float y, float w, float h,
+                     float subX, float subY, float subW, float subH,
+                     float r, float g, float b, float a) {
+        drawTextureQuad(textureID, &sampler, x, y, w, h, subX, subY, subW, subH, r, g, b, a);
+    }
 
-        // Clean up
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    float* appendTextureQuads(unsigned int textureID, size_t count) {
+        if (RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE) {
+            return SoftwareRasterizer::getInstance().texturedQuads(textureID, count);
+        }
 
-        glDeleteVertexArrays(1, &textureVAO);
-        glDeleteBuffers(1, &textureVBO);
-        glDeleteBuffers(1, &textureEBO);
+        if (!initializeTextureQuad()) {
+            std::cerr << "Texture quad shader is not valid" << std::endl;
+            return nullptr;
+        }
+        return textureQuadBatch.append(static_cast<uint64_t>(textureID) << 32, count);
     }
 
     void _destroyTextureQuad() {
+        textureQuadBatch.destroy();
         textureQuadShader.destroy();
     }
 
 } // namespace Render
-} // namespace cridgeon
\ No newline at end of file
+} // namespace cridgeon
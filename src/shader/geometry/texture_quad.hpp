@@ -1,7 +1,7 @@
 /// @file texture_quad.hpp
 /// @author Charlie Ridgeon
 /// @date Created: 2026-02-19
-/// @date Updated: 2026-02-19
+/// @date Updated: 2026-10-18
 /// @brief Renders textured quads with position, dimensions, and subtexture support.
 ///        Provides functionality to render any portion of a texture to any
 ///        screen region using OpenGL.
@@ -9,9 +9,15 @@
 #ifndef CRIDGEON_SHADER_TEXTURE_QUAD_HPP
 #define CRIDGEON_SHADER_TEXTURE_QUAD_HPP
 
+#include <cstddef>
+
 namespace cridgeon {
+struct SamplerState;
+
 namespace Render {
-    /// @brief Renders a textured quad to the screen.
+    /// @brief Renders a textured quad to the screen. Quads are batched: they
+    ///        are drawn together, in order, when another primitive is drawn,
+    ///        the texture changes, or Render::flushBatches() is called.
     /// @param textureID The OpenGL texture ID to render.
     /// @param x The x position on screen.
     /// @param y The y position on screen.
@@ -31,6 +37,32 @@ namespace Render {
                      float subW = 1.0f, float subH = 1.0f,
                      float r = 1.0f, float g = 1.0f, 
                      float b = 1.0f, float a = 1.0f);
+
+    /// @brief Renders a textured quad sampled with an explicit sampler state.
+    ///        The texture's own filter and wrap parameters are left untouched
+    ///        on GL 3.3+, so the same texture can be drawn with different
+    ///        sampling in one frame without parameter churn.
+    /// @param textureID The OpenGL texture ID to render.
+    /// @param sampler The sampling state to use for this draw.
+    /// @see textureQuad for the remaining parameters.
+    void textureQuad(unsigned int textureID, const SamplerState& sampler,
+                     float x, float y, float w, float h,
+                     float subX = 0.0f, float subY = 0.0f, 
+                     float subW = 1.0f, float subH = 1.0f,
+                     float r = 1.0f, float g = 1.0f, 
+                     float b = 1.0f, float a = 1.0f);
+
+    /// @brief Number of floats per quad written through appendTextureQuads():
+    ///        rect (x, y, w, h), subtexture (x, y, w, h), tint (r, g, b, a).
+    const int TEXTURE_QUAD_FLOATS = 12;
+
+    /// @brief Reserves several textured quads in the batch at once, for
+    ///        callers that build quad data in bulk (e.g. text runs).
+    /// @param textureID The OpenGL texture ID shared by every quad.
+    /// @param count Number of quads to reserve.
+    /// @returns Pointer to count * TEXTURE_QUAD_FLOATS floats to fill in,
+    ///          or nullptr if the shader could not be loaded.
+    float* appendTextureQuads(unsigned int textureID, size_t count);
     
     /// @brief Clean up texture quad rendering resources.
     void _destroyTextureQuad();
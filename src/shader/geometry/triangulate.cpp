@@ -0,0 +1,124 @@
+#include "triangulate.hpp"
+
+#include <cstddef>
+
+namespace cridgeon {
+namespace Render {
+
+    // Helper function to calculate cross product (for determining triangle orientation)
+    static float cross2D(float x1, float y1, float x2, float y2) {
+        return x1 * y2 - x2 * y1;
+    }
+
+    // Check if point P is inside triangle ABC
+    static bool isPointInTriangle(float px, float py, 
+                                   float ax, float ay, 
+                                   float bx, float by, 
+                                   float cx, float cy) {
+        float v0x = cx - ax, v0y = cy - ay;
+        float v1x = bx - ax, v1y = by - ay;
+        float v2x = px - ax, v2y = py - ay;
+
+        float dot00 = v0x * v0x + v0y * v0y;
+        float dot01 = v0x * v1x + v0y * v1y;
+        float dot02 = v0x * v2x + v0y * v2y;
+        float dot11 = v1x * v1x + v1y * v1y;
+        float dot12 = v1x * v2x + v1y * v2y;
+
+        float invDenom = 1.0f / (dot00 * dot11 - dot01 * dot01);
+        float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+        float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+
+        return (u >= 0) && (v >= 0) && (u + v < 1);
+    }
+
+    // Check if ear at index i is valid (no other vertices inside)
+    static bool isEar(const std::vector<float>& vertices, const std::vector<int>& indices, size_t i) {
+        size_t n = indices.size();
+        size_t prev = (i + n - 1) % n;
+        size_t next = (i + 1) % n;
+
+        int i0 = indices[prev];
+        int i1 = indices[i];
+        int i2 = indices[next];
+
+        float x0 = vertices[i0 * 2], y0 = vertices[i0 * 2 + 1];
+        float x1 = vertices[i1 * 2], y1 = vertices[i1 * 2 + 1];
+        float x2 = vertices[i2 * 2], y2 = vertices[i2 * 2 + 1];
+
+        // Check if triangle is counter-clockwise (convex at this vertex)
+        float cross = cross2D(x1 - x0, y1 - y0, x2 - x1, y2 - y1);
+        if (cross <= 0) return false; // Reflex vertex
+
+        // Check if any other vertex is inside this triangle
+        for (size_t j = 0; j < n; j++) {
+            if (j == prev || j == i || j == next) continue;
+            int idx = indices[j];
+            float px = vertices[idx * 2];
+            float py = vertices[idx * 2 + 1];
+            if (isPointInTriangle(px, py, x0, y0, x1, y1, x2, y2)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Triangulate polygon using ear clipping algorithm
+    std::vector<float> triangulatePolygon(const std::vector<float>& vertices) {
+        int n = vertices.size() / 2;
+        if (n < 3) return {};
+
+        std::vector<int> indices;
+        for (int i = 0; i < n; i++) {
+            indices.push_back(i);
+        }
+
+        std::vector<float> triangles;
+
+        while (indices.size() > 3) {
+            bool earFound = false;
+
+            for (size_t i = 0; i < indices.size(); i++) {
+                if (isEar(vertices, indices, i)) {
+                    size_t prev = (i + indices.size() - 1) % indices.size();
+                    size_t next = (i + 1) % indices.size();
+
+                    // Add triangle
+                    int i0 = indices[prev];
+                    int i1 = indices[i];
+                    int i2 = indices[next];
+
+                    triangles.push_back(vertices[i0 * 2]);
+                    triangles.push_back(vertices[i0 * 2 + 1]);
+                    triangles.push_back(vertices[i1 * 2]);
+                    triangles.push_back(vertices[i1 * 2 + 1]);
+                    triangles.push_back(vertices[i2 * 2]);
+                    triangles.push_back(vertices[i2 * 2 + 1]);
+
+                    // Remove the ear
+                    indices.erase(indices.begin() + i);
+                    earFound = true;
+                    break;
+                }
+            }
+
+            if (!earFound) {
+                // Fallback: just emit remaining triangle if algorithm fails
+                break;
+            }
+        }
+
+        // Add the last triangle
+        if (indices.size() == 3) {
+            for (int i = 0; i < 3; i++) {
+                int idx = indices[i];
+                triangles.push_back(vertices[idx * 2]);
+                triangles.push_back(vertices[idx * 2 + 1]);
+            }
+        }
+
+        return triangles;
+    }
+} // namespace Render
+} // namespace cridgeon
@@ -0,0 +1,14 @@
+#ifndef CRIDGEON_SHADER_TRIANGULATE_HPP
+#define CRIDGEON_SHADER_TRIANGULATE_HPP
+
+#include <vector>
+
+namespace cridgeon {
+namespace Render {
+    // Triangulate a simple counter-clockwise polygon (x, y pairs) by ear
+    // clipping. Returns x, y pairs, three vertices per triangle.
+    std::vector<float> triangulatePolygon(const std::vector<float>& vertices);
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_SHADER_TRIANGULATE_HPP
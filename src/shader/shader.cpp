@@ -1,4 +1,5 @@
 #include "shader.hpp"
+#include "gl_capabilities.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -28,7 +29,8 @@ namespace cridgeon
         return *this;
     }
     
-    bool Shader::loadFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
+    bool Shader::loadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                                const std::vector<std::string>& attributes) {
         unsigned int vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
         if (vertexShader == 0) return false;
     
@@ -38,7 +40,7 @@ namespace cridgeon
             return false;
         }
     
-        programID = createProgram(vertexShader, fragmentShader);
+        programID = createProgram(vertexShader, fragmentShader, attributes);
         
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
@@ -46,7 +48,8 @@ namespace cridgeon
         return programID != 0;
     }
     
-    bool Shader::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath) {
+    bool Shader::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                              const std::vector<std::string>& attributes) {
         std::string vertexSource = loadFile(vertexPath);
         std::string fragmentSource = loadFile(fragmentPath);
         
@@ -54,7 +57,81 @@ namespace cridgeon
             return false;
         }
         
-        return loadFromSource(vertexSource, fragmentSource);
+        return loadFromSource(vertexSource, fragmentSource, attributes);
+    }
+    
+    bool Shader::loadFeedbackFromSource(const std::string& vertexSource, const std::vector<std::string>& varyings,
+                                        const std::vector<std::string>& attributes) {
+        unsigned int vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
+        if (vertexShader == 0) return false;
+
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        for (size_t i = 0; i < attributes.size(); ++i) {
+            glBindAttribLocation(program, static_cast<unsigned int>(i), attributes[i].c_str());
+        }
+
+        std::vector<const char*> names;
+        names.reserve(varyings.size());
+        for (const std::string& varying : varyings) {
+            names.push_back(varying.c_str());
+        }
+        glTransformFeedbackVaryings(program, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+        glLinkProgram(program);
+
+        checkCompileErrors(program, Type::PROGRAM);
+        glDeleteShader(vertexShader);
+
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            return false;
+        }
+
+        programID = program;
+        return true;
+    }
+
+    bool Shader::loadFeedbackFromFile(const std::string& vertexPath, const std::vector<std::string>& varyings,
+                                      const std::vector<std::string>& attributes) {
+        std::string vertexSource = loadFile(vertexPath);
+        if (vertexSource.empty()) {
+            return false;
+        }
+
+        return loadFeedbackFromSource(vertexSource, varyings, attributes);
+    }
+
+    bool Shader::loadComputeFromSource(const std::string& computeSource) {
+        unsigned int computeShader = compileShader(computeSource, GL_COMPUTE_SHADER);
+        if (computeShader == 0) return false;
+
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, computeShader);
+        glLinkProgram(program);
+
+        checkCompileErrors(program, Type::PROGRAM);
+        glDeleteShader(computeShader);
+
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            return false;
+        }
+
+        programID = program;
+        return true;
+    }
+
+    bool Shader::loadComputeFromFile(const std::string& computePath) {
+        std::string computeSource = loadFile(computePath);
+        if (computeSource.empty()) {
+            return false;
+        }
+
+        return loadComputeFromSource(computeSource);
     }
     
     void Shader::use() const {
@@ -87,7 +164,8 @@ namespace cridgeon
         glShaderSource(shader, 1, &src, nullptr);
         glCompileShader(shader);
         
-        checkCompileErrors(shader, type == GL_VERTEX_SHADER ? Type::VERTEX : Type::FRAGMENT);
+        checkCompileErrors(shader, type == GL_VERTEX_SHADER ? Type::VERTEX :
+                                   type == GL_COMPUTE_SHADER ? Type::COMPUTE : Type::FRAGMENT);
         
         int success;
         glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
@@ -99,10 +177,14 @@ namespace cridgeon
         return shader;
     }
     
-    unsigned int Shader::createProgram(unsigned int vertexShader, unsigned int fragmentShader) {
+    unsigned int Shader::createProgram(unsigned int vertexShader, unsigned int fragmentShader,
+                                       const std::vector<std::string>& attributes) {
         unsigned int program = glCreateProgram();
         glAttachShader(program, vertexShader);
         glAttachShader(program, fragmentShader);
+        for (size_t i = 0; i < attributes.size(); ++i) {
+            glBindAttribLocation(program, static_cast<unsigned int>(i), attributes[i].c_str());
+        }
         glLinkProgram(program);
         
         checkCompileErrors(program, Type::PROGRAM);
@@ -137,7 +219,7 @@ namespace cridgeon
             if (!success) {
                 glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
                 std::cerr << "ERROR::SHADER_COMPILATION_ERROR of type: " 
-                          << (type == Type::VERTEX ? "VERTEX" : "FRAGMENT") << "\n" 
+                          << (type == Type::VERTEX ? "VERTEX" : type == Type::COMPUTE ? "COMPUTE" : "FRAGMENT") << "\n" 
                           << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         } else {
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <iostream>
 
 namespace cridgeon {
@@ -10,6 +11,7 @@ namespace cridgeon {
         enum class Type {
             VERTEX,
             FRAGMENT,
+            COMPUTE,
             PROGRAM
         };
 
@@ -24,11 +26,25 @@ namespace cridgeon {
         Shader(Shader&& other) noexcept;
         Shader& operator=(Shader&& other) noexcept;
 
-        // Load and compile shader from source code
-        bool loadFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+        // Load and compile shader from source code. Vertex attributes listed in
+        // `attributes` are bound to locations 0, 1, 2... in order before linking.
+        bool loadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                            const std::vector<std::string>& attributes = {});
         
         // Load shader from files
-        bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath);
+        bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                          const std::vector<std::string>& attributes = {});
+
+        // Load a vertex-only program whose outputs are captured with transform
+        // feedback. `varyings` are written interleaved into one buffer, in order.
+        bool loadFeedbackFromSource(const std::string& vertexSource, const std::vector<std::string>& varyings,
+                                    const std::vector<std::string>& attributes = {});
+        bool loadFeedbackFromFile(const std::string& vertexPath, const std::vector<std::string>& varyings,
+                                  const std::vector<std::string>& attributes = {});
+
+        // Load a compute program (GL 4.3+; check glCapabilities().computeShader)
+        bool loadComputeFromSource(const std::string& computeSource);
+        bool loadComputeFromFile(const std::string& computePath);
 
         // Use the shader program
         void use() const;
@@ -51,7 +67,8 @@ namespace cridgeon {
 
         // Helper functions
         unsigned int compileShader(const std::string& source, unsigned int type);
-        unsigned int createProgram(unsigned int vertexShader, unsigned int fragmentShader);
+        unsigned int createProgram(unsigned int vertexShader, unsigned int fragmentShader,
+                                   const std::vector<std::string>& attributes);
         void checkCompileErrors(unsigned int shader, Type type);
         std::string loadFile(const std::string& path);
     };
@@ -0,0 +1,210 @@
+#include "shape_prototype.hpp"
+#include "rendering_system.hpp"
+#include "gl_capabilities.hpp"
+#include "shader/batch.hpp"
+#include "shader/geometry/hit_testing.hpp"
+#include "shader/geometry/triangulate.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <glad/gl.h>
+
+namespace cridgeon
+{
+    static const int INSTANCE_FLOATS = 8;
+
+    // Miters reaching further than this many half widths are beveled (the SVG default)
+    static const float MITER_LIMIT = 4.0f;
+
+    ShapePrototype::ShapePrototype()
+        : verticesDirty(false), vao(0), vbo(0), vboCapacity(0) {}
+
+    ShapePrototype::~ShapePrototype() {
+        destroy();
+    }
+
+    void ShapePrototype::addTriangle(float x0, float y0, float x1, float y1, float x2, float y2,
+                                     float r, float g, float b, float a) {
+        const float triangle[3 * VERTEX_FLOATS] = {
+            x0, y0, r, g, b, a,
+            x1, y1, r, g, b, a,
+            x2, y2, r, g, b, a
+        };
+        vertices.insert(vertices.end(), triangle, triangle + 3 * VERTEX_FLOATS);
+        verticesDirty = true;
+    }
+
+    void ShapePrototype::addPolygon(const std::vector<float>& polygon, float r, float g, float b, float a) {
+        if (polygon.size() < 6) return;
+        std::vector<float> triangles = Render::triangulatePolygon(polygon);
+        for (size_t i = 0; i + 5 < triangles.size(); i += 6) {
+            addTriangle(triangles[i], triangles[i + 1], triangles[i + 2], triangles[i + 3],
+                        triangles[i + 4], triangles[i + 5], r, g, b, a);
+        }
+    }
+
+    void ShapePrototype::addPolyline(const std::vector<float>& polyline, float width,
+                                     float r, float g, float b, float a, bool closed) {
+        // Repeated points have no direction to join
+        std::vector<float> points;
+        points.reserve(polyline.size());
+        for (size_t i = 0; i + 1 < polyline.size(); i += 2) {
+            if (points.empty() || polyline[i] != points[points.size() - 2] || polyline[i + 1] != points.back()) {
+                points.push_back(polyline[i]);
+                points.push_back(polyline[i + 1]);
+            }
+        }
+        if (closed && points.size() > 4 && points[0] == points[points.size() - 2] && points[1] == points.back()) {
+            points.resize(points.size() - 2);
+        }
+        size_t count = points.size() / 2;
+        if (count < 2) return;
+
+        // One quad per segment
+        float halfWidth = width * 0.5f;
+        size_t segments = closed ? count : count - 1;
+        std::vector<float> directions(segments * 2);
+        for (size_t i = 0; i < segments; ++i) {
+            size_t j = (i + 1) % count;
+            float x0 = points[i * 2], y0 = points[i * 2 + 1];
+            float x1 = points[j * 2], y1 = points[j * 2 + 1];
+            float dx = x1 - x0, dy = y1 - y0;
+            float length = std::sqrt(dx * dx + dy * dy);
+            directions[i * 2] = dx / length;
+            directions[i * 2 + 1] = dy / length;
+            float nx = -dy / length * halfWidth, ny = dx / length * halfWidth;
+
+            addTriangle(x0 + nx, y0 + ny, x0 - nx, y0 - ny, x1 - nx, y1 - ny, r, g, b, a);
+            addTriangle(x0 + nx, y0 + ny, x1 - nx, y1 - ny, x1 + nx, y1 + ny, r, g, b, a);
+        }
+
+        // The quads overlap on the inside of each turn and leave a wedge open
+        // on the outside, filled with a miter, or a bevel past the limit
+        size_t joints = closed ? segments : segments - 1;
+        for (size_t k = 0; k < joints; ++k) {
+            float ax = directions[k * 2], ay = directions[k * 2 + 1];
+            float bx = directions[((k + 1) % segments) * 2], by = directions[((k + 1) % segments) * 2 + 1];
+            float turn = ax * by - ay * bx;
+            if (turn == 0.0f) continue;     // Straight on, or turning back with flat ends
+
+            size_t joint = (k + 1) % count;
+            float px = points[joint * 2], py = points[joint * 2 + 1];
+            float side = turn > 0.0f ? -halfWidth : halfWidth;
+            float nax = -ay * side, nay = ax * side;
+            float nbx = -by * side, nby = bx * side;
+
+            // The miter tip is (na + nb) / (1 + cos), 1 / sin(angle / 2) half widths out
+            float cosine = ax * bx + ay * by;
+            if (2.0f / (1.0f + cosine) <= MITER_LIMIT * MITER_LIMIT) {
+                float scale = 1.0f / (1.0f + cosine);
+                float mx = px + (nax + nbx) * scale, my = py + (nay + nby) * scale;
+                addTriangle(px, py, px + nax, py + nay, mx, my, r, g, b, a);
+                addTriangle(px, py, mx, my, px + nbx, py + nby, r, g, b, a);
+            } else {
+                addTriangle(px, py, px + nax, py + nay, px + nbx, py + nby, r, g, b, a);
+            }
+        }
+    }
+
+    void ShapePrototype::clear() {
+        vertices.clear();
+        verticesDirty = true;
+    }
+
+    bool ShapePrototype::initialize() {
+        if (!shader.isValid()) {
+            shader.loadFromFile("resources/shaders/instanced/shape.vert", "resources/shaders/geometry/vertex_color.frag",
+                                {"position", "vertexColor", "transform", "instanceColor"});
+            if (!shader.isValid()) {
+                std::cerr << "Failed to load shape prototype shader" << std::endl;
+                return false;
+            }
+        }
+
+        if (vao == 0) {
+            glGenVertexArrays(1, &vao);
+            glGenBuffers(1, &vbo);
+            instanceStream.create(256 * 1024);
+
+            const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+            glEnableVertexAttribArray(0);
+            glEnableVertexAttribArray(1);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            verticesDirty = true;
+        }
+        return true;
+    }
+
+    void ShapePrototype::draw(const std::vector<Instance>& instances) {
+        draw(instances.data(), instances.size());
+    }
+
+    void ShapePrototype::draw(const Instance* instances, size_t count) {
+        if (count == 0 || vertices.empty()) return;
+
+        if (HitIndex* index = Render::hitRecorder()) {
+            index->addTriangleInstances(Render::getHitId(), vertices.data(), getVertexCount(), VERTEX_FLOATS,
+                                        &instances[0].x, count, INSTANCE_FLOATS);
+        }
+
+        if (!initialize()) return;
+        Render::flushBatches();
+
+        if (verticesDirty) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            if (vertices.size() > vboCapacity) {
+                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+                vboCapacity = vertices.size();
+            } else {
+                glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            verticesDirty = false;
+        }
+
+        auto& rs = RenderingSystem::getInstance();
+        shader.use();
+        glUniform2f(shader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()), static_cast<float>(rs.getWindowHeight()));
+
+        GLsizei vertexCount = static_cast<GLsizei>(getVertexCount());
+        glBindVertexArray(vao);
+        if (glCapabilities().instancedArrays) {
+            size_t offset = instanceStream.write(instances, count * sizeof(Instance));
+            const GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 4 * sizeof(float)));
+            glEnableVertexAttribArray(2);
+            glEnableVertexAttribArray(3);
+            glVertexAttribDivisor(2, 1);
+            glVertexAttribDivisor(3, 1);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, vertexCount, static_cast<GLsizei>(count));
+        } else {
+            // GL 3.0 path: the shared vertices stay on the GPU, the transform is a constant attribute
+            for (size_t i = 0; i < count; ++i) {
+                const Instance& instance = instances[i];
+                glVertexAttrib4f(2, instance.x, instance.y, instance.rotation, instance.scale);
+                glVertexAttrib4f(3, instance.r, instance.g, instance.b, instance.a);
+                glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+            }
+        }
+        glBindVertexArray(0);
+    }
+
+    void ShapePrototype::destroy() {
+        if (vao != 0) {
+            glDeleteVertexArrays(1, &vao);
+            glDeleteBuffers(1, &vbo);
+            vao = vbo = 0;
+            instanceStream.destroy();
+        }
+        shader.destroy();
+        vboCapacity = 0;
+        verticesDirty = !vertices.empty();
+    }
+} // namespace cridgeon
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "shader/shader.hpp"
+#include "stream_buffer.hpp"
+#include <vector>
+
+namespace cridgeon
+{
+    // Vector shape recorded once and stamped many times. Polygons are
+    // triangulated and strokes expanded when they are added; drawing uploads
+    // only the compact per-instance array and issues one instanced draw.
+    class ShapePrototype {
+    public:
+        // Placement of one copy: the shape is scaled, rotated (radians,
+        // counter-clockwise) and moved to (x, y). Its colors are multiplied
+        // by the instance color.
+        struct Instance {
+            float x, y;
+            float rotation;
+            float scale;
+            float r, g, b, a;
+        };
+
+        ShapePrototype();
+        ~ShapePrototype();
+
+        // Disable copy constructor and assignment operator
+        ShapePrototype(const ShapePrototype&) = delete;
+        ShapePrototype& operator=(const ShapePrototype&) = delete;
+
+        // Add a filled polygon; `vertices` holds counter-clockwise x, y pairs
+        // in shape units around the shape origin
+        void addPolygon(const std::vector<float>& vertices, float r, float g, float b, float a);
+
+        // Add a stroked polyline; width is in shape units and scales with
+        // instances. Joints are mitered, or beveled where the miter would
+        // reach past 4 half widths; the ends are flat.
+        void addPolyline(const std::vector<float>& vertices, float width,
+                         float r, float g, float b, float a, bool closed = false);
+
+        // Remove all geometry
+        void clear();
+
+        // Draw one copy per instance. With a hit index set, instance i is
+        // recorded under the hit id + i (see Render::setHitIndex()).
+        void draw(const std::vector<Instance>& instances);
+        void draw(const Instance* instances, size_t count);
+
+        size_t getVertexCount() const { return vertices.size() / VERTEX_FLOATS; }
+
+        void destroy();
+
+    private:
+        static const int VERTEX_FLOATS = 6;     // position (2), color (4)
+
+        Shader shader;
+        std::vector<float> vertices;
+        bool verticesDirty;
+
+        unsigned int vao, vbo;
+        size_t vboCapacity;
+        StreamBuffer instanceStream;
+
+        bool initialize();
+        void addTriangle(float x0, float y0, float x1, float y1, float x2, float y2,
+                         float r, float g, float b, float a);
+    };
+} // namespace cridgeon
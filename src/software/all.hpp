@@ -0,0 +1,7 @@
+#ifndef CRIDGEON_SOFTWARE_ALL_HPP
+#define CRIDGEON_SOFTWARE_ALL_HPP
+
+#include "kernels.hpp"
+#include "rasterizer.hpp"
+
+#endif // CRIDGEON_SOFTWARE_ALL_HPP
@@ -0,0 +1,284 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// AVX2 kernels are compiled with a function target on GCC and Clang, so the
+// rest of the library keeps the default instruction set; other compilers
+// only use them when the whole build targets AVX2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CRIDGEON_SOFTWARE_AVX2 1
+#define CRIDGEON_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define CRIDGEON_SOFTWARE_AVX2 1
+#define CRIDGEON_AVX2_TARGET
+#include <immintrin.h>
+#endif
+
+namespace cridgeon {
+namespace Software {
+
+    static const float PI = 3.14159265359f;
+    static const float TWO_PI = 6.28318530718f;
+
+    static inline float clamp01(float value) {
+        return std::min(std::max(value, 0.0f), 1.0f);
+    }
+
+    // --- Scalar kernels ---
+
+    static void radialRowScalar(const float* p, int x0, float y, int n, float* coverage) {
+        float ly = y - p[RADIAL_CY];
+        float span = p[RADIAL_SPAN];
+        float middle = (p[RADIAL_OUTER] + p[RADIAL_INNER]) * 0.5f;
+        float capRadius = (p[RADIAL_OUTER] - p[RADIAL_INNER]) * 0.5f;
+        for (int i = 0; i < n; ++i) {
+            float lx = x0 + i + 0.5f - p[RADIAL_CX];
+            float length = std::sqrt(lx * lx + ly * ly);
+            float distance = std::max(length - p[RADIAL_OUTER], p[RADIAL_INNER] - length);
+
+            if (span < TWO_PI) {
+                float toStart = lx * p[RADIAL_SIN_START] - ly * p[RADIAL_COS_START];
+                float toEnd = -lx * p[RADIAL_SIN_END] + ly * p[RADIAL_COS_END];
+                float wedge = span <= PI ? std::max(toStart, toEnd) : std::min(toStart, toEnd);
+                distance = std::max(distance, wedge);
+
+                if (p[RADIAL_CAPS] > 0.5f) {
+                    float sx = lx - p[RADIAL_COS_START] * middle, sy = ly - p[RADIAL_SIN_START] * middle;
+                    float ex = lx - p[RADIAL_COS_END] * middle, ey = ly - p[RADIAL_SIN_END] * middle;
+                    float startCap = std::sqrt(sx * sx + sy * sy) - capRadius;
+                    float endCap = std::sqrt(ex * ex + ey * ey) - capRadius;
+                    distance = std::min(distance, std::min(startCap, endCap));
+                }
+            }
+            coverage[i] = clamp01(0.5f - distance);
+        }
+    }
+
+    static void rectRowScalar(const float* p, int x0, float y, int n, float* coverage, float* border) {
+        float ly = y - p[RECT_CY];
+        float borderWidth = p[RECT_BORDER_WIDTH];
+        for (int i = 0; i < n; ++i) {
+            float lx = x0 + i + 0.5f - p[RECT_CX];
+            float radius = lx > 0.0f ? (ly > 0.0f ? p[RECT_RADIUS_TR] : p[RECT_RADIUS_BR])
+                                     : (ly > 0.0f ? p[RECT_RADIUS_TL] : p[RECT_RADIUS_BL]);
+            float qx = std::fabs(lx) - p[RECT_HALF_W] + radius;
+            float qy = std::fabs(ly) - p[RECT_HALF_H] + radius;
+            float ox = std::max(qx, 0.0f), oy = std::max(qy, 0.0f);
+            float distance = std::min(std::max(qx, qy), 0.0f) + std::sqrt(ox * ox + oy * oy) - radius;
+            coverage[i] = clamp01(0.5f - distance);
+            border[i] = borderWidth > 0.0f ? clamp01(distance + borderWidth + 0.5f) : 0.0f;
+        }
+    }
+
+    static void segmentRowScalar(const float* p, int x0, float y, int n, float* coverage) {
+        float py = y - p[SEGMENT_Y];
+        for (int i = 0; i < n; ++i) {
+            float px = x0 + i + 0.5f - p[SEGMENT_X];
+            float t = clamp01((px * p[SEGMENT_DX] + py * p[SEGMENT_DY]) * p[SEGMENT_INV_LENGTH_SQ]);
+            float ex = px - t * p[SEGMENT_DX], ey = py - t * p[SEGMENT_DY];
+            float distance = std::sqrt(ex * ex + ey * ey) - p[SEGMENT_HALF_WIDTH];
+            coverage[i] = clamp01(0.5f - distance);
+        }
+    }
+
+    // Matches glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on every channel
+    static void blendConstantScalar(float* r, float* g, float* b, float* a, int n,
+                                    const float color[4], const float* coverage) {
+        for (int i = 0; i < n; ++i) {
+            float alpha = color[3] * coverage[i];
+            float keep = 1.0f - alpha;
+            r[i] = color[0] * alpha + r[i] * keep;
+            g[i] = color[1] * alpha + g[i] * keep;
+            b[i] = color[2] * alpha + b[i] * keep;
+            a[i] = alpha * alpha + a[i] * keep;
+        }
+    }
+
+    static void blendVaryingScalar(float* r, float* g, float* b, float* a, int n,
+                                   const float* sr, const float* sg, const float* sb, const float* sa) {
+        for (int i = 0; i < n; ++i) {
+            float alpha = sa[i];
+            float keep = 1.0f - alpha;
+            r[i] = sr[i] * alpha + r[i] * keep;
+            g[i] = sg[i] * alpha + g[i] * keep;
+            b[i] = sb[i] * alpha + b[i] * keep;
+            a[i] = alpha * alpha + a[i] * keep;
+        }
+    }
+
+#ifdef CRIDGEON_SOFTWARE_AVX2
+    // --- AVX2 kernels: 8 pixels per step, the remainder goes to the scalar path ---
+
+    CRIDGEON_AVX2_TARGET static inline __m256 pixelCenters(int x) {
+        return _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x) + 0.5f),
+                             _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    }
+
+    CRIDGEON_AVX2_TARGET static inline __m256 clamp01(__m256 value) {
+        return _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    }
+
+    CRIDGEON_AVX2_TARGET static inline __m256 length(__m256 x, __m256 y) {
+        return _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+    }
+
+    CRIDGEON_AVX2_TARGET static void radialRowAVX2(const float* p, int x0, float y, int n, float* coverage) {
+        const __m256 ly = _mm256_set1_ps(y - p[RADIAL_CY]);
+        const __m256 outer = _mm256_set1_ps(p[RADIAL_OUTER]);
+        const __m256 inner = _mm256_set1_ps(p[RADIAL_INNER]);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const float span = p[RADIAL_SPAN];
+        const bool sector = span < TWO_PI;
+        const bool caps = sector && p[RADIAL_CAPS] > 0.5f;
+        const float middle = (p[RADIAL_OUTER] + p[RADIAL_INNER]) * 0.5f;
+        const __m256 capRadius = _mm256_set1_ps((p[RADIAL_OUTER] - p[RADIAL_INNER]) * 0.5f);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 lx = _mm256_sub_ps(pixelCenters(x0 + i), _mm256_set1_ps(p[RADIAL_CX]));
+            __m256 len = length(lx, ly);
+            __m256 distance = _mm256_max_ps(_mm256_sub_ps(len, outer), _mm256_sub_ps(inner, len));
+
+            if (sector) {
+                __m256 toStart = _mm256_sub_ps(_mm256_mul_ps(lx, _mm256_set1_ps(p[RADIAL_SIN_START])),
+                                               _mm256_mul_ps(ly, _mm256_set1_ps(p[RADIAL_COS_START])));
+                __m256 toEnd = _mm256_sub_ps(_mm256_mul_ps(ly, _mm256_set1_ps(p[RADIAL_COS_END])),
+                                             _mm256_mul_ps(lx, _mm256_set1_ps(p[RADIAL_SIN_END])));
+                __m256 wedge = span <= PI ? _mm256_max_ps(toStart, toEnd) : _mm256_min_ps(toStart, toEnd);
+                distance = _mm256_max_ps(distance, wedge);
+
+                if (caps) {
+                    __m256 startCap = _mm256_sub_ps(length(_mm256_sub_ps(lx, _mm256_set1_ps(p[RADIAL_COS_START] * middle)),
+                                                           _mm256_sub_ps(ly, _mm256_set1_ps(p[RADIAL_SIN_START] * middle))),
+                                                    capRadius);
+                    __m256 endCap = _mm256_sub_ps(length(_mm256_sub_ps(lx, _mm256_set1_ps(p[RADIAL_COS_END] * middle)),
+                                                         _mm256_sub_ps(ly, _mm256_set1_ps(p[RADIAL_SIN_END] * middle))),
+                                                  capRadius);
+                    distance = _mm256_min_ps(distance, _mm256_min_ps(startCap, endCap));
+                }
+            }
+            _mm256_storeu_ps(coverage + i, clamp01(_mm256_sub_ps(half, distance)));
+        }
+        if (i < n) radialRowScalar(p, x0 + i, y, n - i, coverage + i);
+    }
+
+    CRIDGEON_AVX2_TARGET static void rectRowAVX2(const float* p, int x0, float y, int n, float* coverage, float* border) {
+        const float lyScalar = y - p[RECT_CY];
+        const __m256 absLy = _mm256_set1_ps(std::fabs(lyScalar));
+        const __m256 halfW = _mm256_set1_ps(p[RECT_HALF_W]);
+        const __m256 halfH = _mm256_set1_ps(p[RECT_HALF_H]);
+        // The row fixes the top or bottom pair of radii; the sign of x picks one
+        const __m256 radiusLeft = _mm256_set1_ps(lyScalar > 0.0f ? p[RECT_RADIUS_TL] : p[RECT_RADIUS_BL]);
+        const __m256 radiusRight = _mm256_set1_ps(lyScalar > 0.0f ? p[RECT_RADIUS_TR] : p[RECT_RADIUS_BR]);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const float borderWidth = p[RECT_BORDER_WIDTH];
+        const __m256 borderOffset = _mm256_set1_ps(borderWidth + 0.5f);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 lx = _mm256_sub_ps(pixelCenters(x0 + i), _mm256_set1_ps(p[RECT_CX]));
+            __m256 radius = _mm256_blendv_ps(radiusLeft, radiusRight, _mm256_cmp_ps(lx, zero, _CMP_GT_OQ));
+            __m256 qx = _mm256_add_ps(_mm256_sub_ps(_mm256_andnot_ps(signMask, lx), halfW), radius);
+            __m256 qy = _mm256_add_ps(_mm256_sub_ps(absLy, halfH), radius);
+            __m256 outside = length(_mm256_max_ps(qx, zero), _mm256_max_ps(qy, zero));
+            __m256 distance = _mm256_sub_ps(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(qx, qy), zero), outside), radius);
+            _mm256_storeu_ps(coverage + i, clamp01(_mm256_sub_ps(half, distance)));
+            _mm256_storeu_ps(border + i, borderWidth > 0.0f ? clamp01(_mm256_add_ps(distance, borderOffset)) : zero);
+        }
+        if (i < n) rectRowScalar(p, x0 + i, y, n - i, coverage + i, border + i);
+    }
+
+    CRIDGEON_AVX2_TARGET static void segmentRowAVX2(const float* p, int x0, float y, int n, float* coverage) {
+        const __m256 py = _mm256_set1_ps(y - p[SEGMENT_Y]);
+        const __m256 dx = _mm256_set1_ps(p[SEGMENT_DX]);
+        const __m256 dy = _mm256_set1_ps(p[SEGMENT_DY]);
+        const __m256 invLengthSq = _mm256_set1_ps(p[SEGMENT_INV_LENGTH_SQ]);
+        const __m256 halfWidth = _mm256_set1_ps(p[SEGMENT_HALF_WIDTH]);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 px = _mm256_sub_ps(pixelCenters(x0 + i), _mm256_set1_ps(p[SEGMENT_X]));
+            __m256 t = clamp01(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(px, dx), _mm256_mul_ps(py, dy)), invLengthSq));
+            __m256 ex = _mm256_sub_ps(px, _mm256_mul_ps(t, dx));
+            __m256 ey = _mm256_sub_ps(py, _mm256_mul_ps(t, dy));
+            __m256 distance = _mm256_sub_ps(length(ex, ey), halfWidth);
+            _mm256_storeu_ps(coverage + i, clamp01(_mm256_sub_ps(half, distance)));
+        }
+        if (i < n) segmentRowScalar(p, x0 + i, y, n - i, coverage + i);
+    }
+
+    CRIDGEON_AVX2_TARGET static inline void blend8(float* r, float* g, float* b, float* a,
+                                                   __m256 sr, __m256 sg, __m256 sb, __m256 alpha) {
+        __m256 keep = _mm256_sub_ps(_mm256_set1_ps(1.0f), alpha);
+        _mm256_storeu_ps(r, _mm256_add_ps(_mm256_mul_ps(sr, alpha), _mm256_mul_ps(_mm256_loadu_ps(r), keep)));
+        _mm256_storeu_ps(g, _mm256_add_ps(_mm256_mul_ps(sg, alpha), _mm256_mul_ps(_mm256_loadu_ps(g), keep)));
+        _mm256_storeu_ps(b, _mm256_add_ps(_mm256_mul_ps(sb, alpha), _mm256_mul_ps(_mm256_loadu_ps(b), keep)));
+        _mm256_storeu_ps(a, _mm256_add_ps(_mm256_mul_ps(alpha, alpha), _mm256_mul_ps(_mm256_loadu_ps(a), keep)));
+    }
+
+    CRIDGEON_AVX2_TARGET static void blendConstantAVX2(float* r, float* g, float* b, float* a, int n,
+                                                       const float color[4], const float* coverage) {
+        const __m256 sr = _mm256_set1_ps(color[0]);
+        const __m256 sg = _mm256_set1_ps(color[1]);
+        const __m256 sb = _mm256_set1_ps(color[2]);
+        const __m256 sa = _mm256_set1_ps(color[3]);
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 alpha = _mm256_mul_ps(sa, _mm256_loadu_ps(coverage + i));
+            // Most rows of a round shape start and end outside it
+            if (_mm256_movemask_ps(_mm256_cmp_ps(alpha, _mm256_setzero_ps(), _CMP_GT_OQ)) == 0) continue;
+            blend8(r + i, g + i, b + i, a + i, sr, sg, sb, alpha);
+        }
+        if (i < n) blendConstantScalar(r + i, g + i, b + i, a + i, n - i, color, coverage + i);
+    }
+
+    CRIDGEON_AVX2_TARGET static void blendVaryingAVX2(float* r, float* g, float* b, float* a, int n,
+                                                      const float* sr, const float* sg, const float* sb, const float* sa) {
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            blend8(r + i, g + i, b + i, a + i, _mm256_loadu_ps(sr + i), _mm256_loadu_ps(sg + i),
+                   _mm256_loadu_ps(sb + i), _mm256_loadu_ps(sa + i));
+        }
+        if (i < n) blendVaryingScalar(r + i, g + i, b + i, a + i, n - i, sr + i, sg + i, sb + i, sa + i);
+    }
+
+    static bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return true;    // The build itself targets AVX2
+#endif
+    }
+#endif // CRIDGEON_SOFTWARE_AVX2
+
+    static Kernels selectKernels(bool& avx2) {
+        avx2 = false;
+#ifdef CRIDGEON_SOFTWARE_AVX2
+        if (cpuHasAVX2()) {
+            avx2 = true;
+            return {radialRowAVX2, rectRowAVX2, segmentRowAVX2, blendConstantAVX2, blendVaryingAVX2};
+        }
+#endif
+        return {radialRowScalar, rectRowScalar, segmentRowScalar, blendConstantScalar, blendVaryingScalar};
+    }
+
+    static bool avx2Selected = false;
+
+    const Kernels& kernels() {
+        static const Kernels selected = selectKernels(avx2Selected);
+        return selected;
+    }
+
+    bool usingAVX2() {
+        kernels();
+        return avx2Selected;
+    }
+
+} // namespace Software
+} // namespace cridgeon
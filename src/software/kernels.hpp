@@ -0,0 +1,67 @@
+/// @file kernels.hpp
+/// @brief Per-row coverage and blending kernels of the software rasterizer.
+///        Each kernel processes a horizontal run of pixels; the AVX2 versions
+///        handle 8 pixels per step and are selected at runtime when the CPU
+///        supports them. Pixel centers are at (x + 0.5, y + 0.5), y up.
+
+#ifndef CRIDGEON_SOFTWARE_KERNELS_HPP
+#define CRIDGEON_SOFTWARE_KERNELS_HPP
+
+namespace cridgeon {
+namespace Software {
+
+    // Parameter layouts of the analytic shapes, relative to the pixel center
+    // coordinates; see SoftwareRasterizer for how they are filled in.
+    enum RadialParam {
+        RADIAL_CX, RADIAL_CY, RADIAL_OUTER, RADIAL_INNER, RADIAL_SPAN, RADIAL_CAPS,
+        RADIAL_SIN_START, RADIAL_COS_START, RADIAL_SIN_END, RADIAL_COS_END,
+        RADIAL_R, RADIAL_G, RADIAL_B, RADIAL_A,
+        RADIAL_FLOATS
+    };
+
+    enum RectParam {
+        RECT_CX, RECT_CY, RECT_HALF_W, RECT_HALF_H,
+        RECT_RADIUS_BL, RECT_RADIUS_BR, RECT_RADIUS_TR, RECT_RADIUS_TL,
+        RECT_BORDER_WIDTH,
+        RECT_FILL_R, RECT_FILL_G, RECT_FILL_B, RECT_FILL_A,
+        RECT_BORDER_R, RECT_BORDER_G, RECT_BORDER_B, RECT_BORDER_A,
+        RECT_FLOATS
+    };
+
+    enum SegmentParam {
+        SEGMENT_X, SEGMENT_Y, SEGMENT_DX, SEGMENT_DY, SEGMENT_INV_LENGTH_SQ, SEGMENT_HALF_WIDTH,
+        SEGMENT_R, SEGMENT_G, SEGMENT_B, SEGMENT_A,
+        SEGMENT_FLOATS
+    };
+
+    /// @brief Row kernels. `x0` is the first pixel's column, `y` the row's
+    ///        pixel center and `n` the run length (at most one tile row).
+    struct Kernels {
+        /// @brief Coverage of an annulus sector.
+        void (*radialRow)(const float* params, int x0, float y, int n, float* coverage);
+
+        /// @brief Coverage of a rounded rectangle and the border blend factor.
+        void (*rectRow)(const float* params, int x0, float y, int n, float* coverage, float* border);
+
+        /// @brief Coverage of a capsule around a segment.
+        void (*segmentRow)(const float* params, int x0, float y, int n, float* coverage);
+
+        /// @brief Blends one color scaled by coverage over planar RGBA floats.
+        void (*blendConstant)(float* r, float* g, float* b, float* a, int n,
+                              const float color[4], const float* coverage);
+
+        /// @brief Blends per-pixel colors (alpha already includes coverage).
+        void (*blendVarying)(float* r, float* g, float* b, float* a, int n,
+                             const float* sr, const float* sg, const float* sb, const float* sa);
+    };
+
+    /// @brief The fastest kernels supported by this CPU.
+    const Kernels& kernels();
+
+    /// @brief Checks whether the AVX2 kernels are in use.
+    bool usingAVX2();
+
+} // namespace Software
+} // namespace cridgeon
+
+#endif // CRIDGEON_SOFTWARE_KERNELS_HPP
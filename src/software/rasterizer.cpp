@@ -0,0 +1,679 @@
+#include "rasterizer.hpp"
+#include "kernels.hpp"
+
+#include "texture/sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <glad/gl.h>
+
+namespace cridgeon {
+
+    using namespace Software;
+
+    const int SoftwareRasterizer::TILE_SIZE;
+
+    static const float TWO_PI = 6.28318530718f;
+
+    SoftwareRasterizer& SoftwareRasterizer::getInstance() {
+        static SoftwareRasterizer instance;
+        return instance;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer()
+        : tiles_x(0), tiles_y(0), width(0), height(0), clear_color{0.0f, 0.0f, 0.0f, 1.0f},
+          read_framebuffer(0), job(nullptr), job_count(0), next_job(0), job_generation(0),
+          joined_workers(0), busy_workers(0), stopping(false), thread_count(0) {}
+
+    SoftwareRasterizer::~SoftwareRasterizer() {
+        stopWorkers();
+    }
+
+    bool SoftwareRasterizer::usingAVX2() {
+        return Software::usingAVX2();
+    }
+
+    void SoftwareRasterizer::begin(int frameWidth, int frameHeight, const float clearColor[4]) {
+        width = std::max(frameWidth, 0);
+        height = std::max(frameHeight, 0);
+        for (int i = 0; i < 4; ++i) {
+            clear_color[i] = clearColor[i];
+        }
+        commands.clear();
+        params.clear();
+    }
+
+    float* SoftwareRasterizer::addCommand(Shape shape, size_t floatCount, float minX, float minY, float maxX, float maxY) {
+        Command command;
+        command.shape = shape;
+        command.linear = false;
+        command.wrap_s = command.wrap_t = Wrap::CLAMP;
+        command.distance_range = 0.0f;
+        command.params = static_cast<uint32_t>(params.size());
+        command.count = 0;
+        // Anti-aliased edges reach half a pixel past the shape
+        command.min_x = minX - 1.0f;
+        command.min_y = minY - 1.0f;
+        command.max_x = maxX + 1.0f;
+        command.max_y = maxY + 1.0f;
+        commands.push_back(std::move(command));
+
+        params.resize(params.size() + floatCount);
+        return params.data() + commands.back().params;
+    }
+
+    void SoftwareRasterizer::radial(float x, float y, float innerRadius, float outerRadius,
+                                    float startAngle, float span, bool roundCaps, const float color[4]) {
+        innerRadius = std::max(innerRadius, 0.0f);
+        if (outerRadius <= innerRadius) return;
+        if (span < 0.0f) {
+            startAngle += span;
+            span = -span;
+        }
+        span = std::min(span, TWO_PI);
+        float endAngle = startAngle + span;
+
+        float* p = addCommand(Shape::RADIAL, RADIAL_FLOATS,
+                              x - outerRadius, y - outerRadius, x + outerRadius, y + outerRadius);
+        p[RADIAL_CX] = x;
+        p[RADIAL_CY] = y;
+        p[RADIAL_OUTER] = outerRadius;
+        p[RADIAL_INNER] = innerRadius;
+        p[RADIAL_SPAN] = span;
+        p[RADIAL_CAPS] = roundCaps ? 1.0f : 0.0f;
+        p[RADIAL_SIN_START] = std::sin(startAngle);
+        p[RADIAL_COS_START] = std::cos(startAngle);
+        p[RADIAL_SIN_END] = std::sin(endAngle);
+        p[RADIAL_COS_END] = std::cos(endAngle);
+        std::copy(color, color + 4, p + RADIAL_R);
+    }
+
+    void SoftwareRasterizer::roundedRect(float x, float y, float w, float h, const float radii[4],
+                                         float borderWidth, const float fillColor[4], const float borderColor[4]) {
+        if (w < 0.0f) { x += w; w = -w; }
+        if (h < 0.0f) { y += h; h = -h; }
+
+        float* p = addCommand(Shape::ROUNDED_RECT, RECT_FLOATS, x, y, x + w, y + h);
+        p[RECT_CX] = x + w * 0.5f;
+        p[RECT_CY] = y + h * 0.5f;
+        p[RECT_HALF_W] = w * 0.5f;
+        p[RECT_HALF_H] = h * 0.5f;
+        float maxRadius = std::min(w, h) * 0.5f;
+        for (int i = 0; i < 4; ++i) {
+            p[RECT_RADIUS_BL + i] = std::min(std::max(radii[i], 0.0f), maxRadius);
+        }
+        p[RECT_BORDER_WIDTH] = borderWidth;
+        std::copy(fillColor, fillColor + 4, p + RECT_FILL_R);
+        std::copy(borderColor, borderColor + 4, p + RECT_BORDER_R);
+    }
+
+    void SoftwareRasterizer::segment(float x0, float y0, float x1, float y1, float lineWidth, const float color[4]) {
+        float halfWidth = lineWidth * 0.5f;
+        float* p = addCommand(Shape::SEGMENT, SEGMENT_FLOATS,
+                              std::min(x0, x1) - halfWidth, std::min(y0, y1) - halfWidth,
+                              std::max(x0, x1) + halfWidth, std::max(y0, y1) + halfWidth);
+        float dx = x1 - x0, dy = y1 - y0;
+        float lengthSquared = dx * dx + dy * dy;
+        p[SEGMENT_X] = x0;
+        p[SEGMENT_Y] = y0;
+        p[SEGMENT_DX] = dx;
+        p[SEGMENT_DY] = dy;
+        p[SEGMENT_INV_LENGTH_SQ] = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+        p[SEGMENT_HALF_WIDTH] = halfWidth;
+        std::copy(color, color + 4, p + SEGMENT_R);
+    }
+
+    void SoftwareRasterizer::polygon(const float* vertices, size_t pointCount, const float color[4]) {
+        if (pointCount < 3) return;
+
+        float minX = vertices[0], minY = vertices[1], maxX = vertices[0], maxY = vertices[1];
+        for (size_t i = 1; i < pointCount; ++i) {
+            minX = std::min(minX, vertices[i * 2]);
+            maxX = std::max(maxX, vertices[i * 2]);
+            minY = std::min(minY, vertices[i * 2 + 1]);
+            maxY = std::max(maxY, vertices[i * 2 + 1]);
+        }
+
+        // Color (4) followed by the points
+        float* p = addCommand(Shape::POLYGON, 4 + pointCount * 2, minX, minY, maxX, maxY);
+        std::copy(color, color + 4, p);
+        std::copy(vertices, vertices + pointCount * 2, p + 4);
+        commands.back().count = static_cast<uint32_t>(pointCount);
+    }
+
+    static SoftwareRasterizer::Wrap wrapFromGL(GLint wrap) {
+        switch (wrap) {
+            case GL_REPEAT:             return SoftwareRasterizer::Wrap::REPEAT;
+            case GL_MIRRORED_REPEAT:    return SoftwareRasterizer::Wrap::MIRROR;
+            default:                    return SoftwareRasterizer::Wrap::CLAMP;
+        }
+    }
+
+    static SoftwareRasterizer::Wrap wrapFromTexture(Texture::Wrap wrap) {
+        switch (wrap) {
+            case Texture::Wrap::REPEAT:             return SoftwareRasterizer::Wrap::REPEAT;
+            case Texture::Wrap::MIRRORED_REPEAT:    return SoftwareRasterizer::Wrap::MIRROR;
+            default:                                return SoftwareRasterizer::Wrap::CLAMP;
+        }
+    }
+
+    std::shared_ptr<const SoftwareRasterizer::Image> SoftwareRasterizer::getImage(unsigned int textureID) {
+        auto found = images.find(textureID);
+        if (found != images.end()) {
+            return found->second;
+        }
+
+        std::shared_ptr<Image> image = std::make_shared<Image>();
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &image->width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &image->height);
+        if (image->width <= 0 || image->height <= 0) {
+            glBindTexture(GL_TEXTURE_2D, 0);
+            std::cerr << "Software rasterizer cannot read texture " << textureID << std::endl;
+            return nullptr;
+        }
+
+        GLint magFilter = GL_LINEAR, wrapS = GL_REPEAT, wrapT = GL_REPEAT;
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &magFilter);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &wrapS);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &wrapT);
+        image->linear = magFilter != GL_NEAREST;
+        image->wrap_s = wrapFromGL(wrapS);
+        image->wrap_t = wrapFromGL(wrapT);
+
+        image->rgba.resize(static_cast<size_t>(image->width) * image->height * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image->rgba.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        images[textureID] = image;
+        return image;
+    }
+
+    float* SoftwareRasterizer::texturedQuads(unsigned int textureID, size_t count,
+                                             const SamplerState* sampler, float distanceRange) {
+        if (count == 0) return nullptr;
+        std::shared_ptr<const Image> image = getImage(textureID);
+        if (!image) return nullptr;
+
+        bool linear = image->linear || distanceRange > 0.0f;
+        Wrap wrapS = image->wrap_s, wrapT = image->wrap_t;
+        if (sampler) {
+            linear = sampler->mag_filter != Texture::Filter::NEAREST || distanceRange > 0.0f;
+            wrapS = wrapFromTexture(sampler->wrap_s);
+            wrapT = wrapFromTexture(sampler->wrap_t);
+        }
+
+        // Bounds are taken from the rects when binning, as they are filled in after this call
+        uint32_t first = static_cast<uint32_t>(params.size());
+        params.resize(params.size() + count * QUAD_FLOATS);
+        for (size_t i = 0; i < count; ++i) {
+            Command command;
+            command.shape = Shape::TEXTURED_QUAD;
+            command.linear = linear;
+            command.wrap_s = wrapS;
+            command.wrap_t = wrapT;
+            command.distance_range = distanceRange;
+            command.params = first + static_cast<uint32_t>(i * QUAD_FLOATS);
+            command.count = 0;
+            command.min_x = command.min_y = command.max_x = command.max_y = 0.0f;
+            command.image = image;
+            commands.push_back(std::move(command));
+        }
+        return params.data() + first;
+    }
+
+    void SoftwareRasterizer::forgetTexture(unsigned int textureID) {
+        if (!images.empty()) {
+            images.erase(textureID);
+        }
+    }
+
+    void SoftwareRasterizer::updateTexture(unsigned int textureID, int x, int y, int w, int h,
+                                           const unsigned char* data, int channels) {
+        auto found = images.find(textureID);
+        if (found == images.end()) return;
+
+        // Commands queued this frame keep the old contents, like the GPU
+        // path, which flushes before uploading
+        std::shared_ptr<Image> image;
+        if (found->second.use_count() == 1) {
+            image = std::const_pointer_cast<Image>(found->second);
+        } else {
+            image = std::make_shared<Image>(*found->second);
+            found->second = image;
+        }
+        if (x < 0 || y < 0 || x + w > image->width || y + h > image->height) {
+            images.erase(found);
+            return;
+        }
+
+        for (int row = 0; row < h; ++row) {
+            const unsigned char* in = data + static_cast<size_t>(row) * w * channels;
+            unsigned char* out = &image->rgba[(static_cast<size_t>(y + row) * image->width + x) * 4];
+            for (int i = 0; i < w; ++i, in += channels, out += 4) {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                out[3] = channels == 4 ? in[3] : 255;
+            }
+        }
+    }
+
+    void SoftwareRasterizer::binCommands() {
+        tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+        tiles.resize(static_cast<size_t>(tiles_x) * tiles_y);
+        for (auto& tile : tiles) {
+            tile.clear();
+        }
+
+        for (size_t i = 0; i < commands.size(); ++i) {
+            Command& command = commands[i];
+            if (command.shape == Shape::TEXTURED_QUAD) {
+                const float* p = params.data() + command.params;
+                command.min_x = std::min(p[0], p[0] + p[2]);
+                command.max_x = std::max(p[0], p[0] + p[2]);
+                command.min_y = std::min(p[1], p[1] + p[3]);
+                command.max_y = std::max(p[1], p[1] + p[3]);
+            }
+
+            int x0 = std::max(0, static_cast<int>(std::floor(command.min_x)));
+            int y0 = std::max(0, static_cast<int>(std::floor(command.min_y)));
+            int x1 = std::min(width, static_cast<int>(std::ceil(command.max_x)));
+            int y1 = std::min(height, static_cast<int>(std::ceil(command.max_y)));
+            if (x0 >= x1 || y0 >= y1) continue;
+
+            for (int ty = y0 / TILE_SIZE; ty <= (y1 - 1) / TILE_SIZE; ++ty) {
+                for (int tx = x0 / TILE_SIZE; tx <= (x1 - 1) / TILE_SIZE; ++tx) {
+                    tiles[static_cast<size_t>(ty) * tiles_x + tx].push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    }
+
+    /// @brief Coverage of a nonzero-winding polygon along a row: inside or
+    ///        outside from the crossings at the pixel centers, blended over the
+    ///        distance to the nearest edge within a pixel of the row.
+    static void polygonRow(const float* points, uint32_t count, int x0, float y, int n, float* coverage,
+                           std::vector<std::pair<float, int>>& crossings, std::vector<uint32_t>& nearEdges) {
+        crossings.clear();
+        nearEdges.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t j = i + 1 == count ? 0 : i + 1;
+            float xa = points[i * 2], ya = points[i * 2 + 1];
+            float xb = points[j * 2], yb = points[j * 2 + 1];
+            if ((ya <= y) != (yb <= y)) {
+                crossings.emplace_back(xa + (y - ya) * (xb - xa) / (yb - ya), yb > ya ? 1 : -1);
+            }
+            if (std::max(ya, yb) >= y - 1.0f && std::min(ya, yb) <= y + 1.0f) {
+                nearEdges.push_back(i);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        size_t next = 0;
+        int winding = 0;
+        for (int i = 0; i < n; ++i) {
+            float x = x0 + i + 0.5f;
+            while (next < crossings.size() && crossings[next].first < x) {
+                winding += crossings[next++].second;
+            }
+
+            float closest = 1.0f;
+            for (uint32_t edge : nearEdges) {
+                uint32_t other = edge + 1 == count ? 0 : edge + 1;
+                float xa = points[edge * 2], ya = points[edge * 2 + 1];
+                float dx = points[other * 2] - xa, dy = points[other * 2 + 1] - ya;
+                float lengthSquared = dx * dx + dy * dy;
+                float t = lengthSquared > 0.0f ? ((x - xa) * dx + (y - ya) * dy) / lengthSquared : 0.0f;
+                t = std::min(std::max(t, 0.0f), 1.0f);
+                float ex = xa + t * dx - x, ey = ya + t * dy - y;
+                closest = std::min(closest, std::sqrt(ex * ex + ey * ey));
+            }
+
+            float distance = winding != 0 ? -closest : closest;
+            coverage[i] = std::min(std::max(0.5f - distance, 0.0f), 1.0f);
+        }
+    }
+
+    static inline int wrapTexel(int i, int size, SoftwareRasterizer::Wrap wrap) {
+        switch (wrap) {
+            case SoftwareRasterizer::Wrap::REPEAT:
+                i %= size;
+                return i < 0 ? i + size : i;
+            case SoftwareRasterizer::Wrap::MIRROR:
+                // Every other copy is flipped
+                i %= 2 * size;
+                if (i < 0) i += 2 * size;
+                return i < size ? i : 2 * size - 1 - i;
+            default:
+                return std::min(std::max(i, 0), size - 1);
+        }
+    }
+
+    void SoftwareRasterizer::rasterizeTile(int tile) {
+        const Kernels& k = kernels();
+        const int originX = (tile % tiles_x) * TILE_SIZE;
+        const int originY = (tile / tiles_x) * TILE_SIZE;
+        const int tileWidth = std::min(TILE_SIZE, width - originX);
+        const int tileHeight = std::min(TILE_SIZE, height - originY);
+
+        // Planar channels so the kernels can load 8 neighbouring pixels at once
+        float r[TILE_SIZE * TILE_SIZE], g[TILE_SIZE * TILE_SIZE], b[TILE_SIZE * TILE_SIZE], a[TILE_SIZE * TILE_SIZE];
+        std::fill(r, r + TILE_SIZE * TILE_SIZE, clear_color[0]);
+        std::fill(g, g + TILE_SIZE * TILE_SIZE, clear_color[1]);
+        std::fill(b, b + TILE_SIZE * TILE_SIZE, clear_color[2]);
+        std::fill(a, a + TILE_SIZE * TILE_SIZE, clear_color[3]);
+
+        float coverage[TILE_SIZE], border[TILE_SIZE];
+        float sr[TILE_SIZE], sg[TILE_SIZE], sb[TILE_SIZE], sa[TILE_SIZE];
+        std::vector<std::pair<float, int>> crossings;
+        std::vector<uint32_t> nearEdges;
+
+        for (uint32_t index : tiles[tile]) {
+            const Command& command = commands[index];
+            const float* p = params.data() + command.params;
+
+            int x0 = std::max(originX, static_cast<int>(std::floor(command.min_x)));
+            int x1 = std::min(originX + tileWidth, static_cast<int>(std::ceil(command.max_x)));
+            int y0 = std::max(originY, static_cast<int>(std::floor(command.min_y)));
+            int y1 = std::min(originY + tileHeight, static_cast<int>(std::ceil(command.max_y)));
+            int n = x1 - x0;
+            if (n <= 0) continue;
+
+            for (int py = y0; py < y1; ++py) {
+                const int offset = (py - originY) * TILE_SIZE + (x0 - originX);
+                const float y = py + 0.5f;
+                float* dr = r + offset;
+                float* dg = g + offset;
+                float* db = b + offset;
+                float* da = a + offset;
+
+                switch (command.shape) {
+                case Shape::RADIAL:
+                    k.radialRow(p, x0, y, n, coverage);
+                    k.blendConstant(dr, dg, db, da, n, p + RADIAL_R, coverage);
+                    break;
+
+                case Shape::ROUNDED_RECT:
+                    k.rectRow(p, x0, y, n, coverage, border);
+                    if (p[RECT_BORDER_WIDTH] > 0.0f) {
+                        for (int i = 0; i < n; ++i) {
+                            float t = border[i];
+                            sr[i] = p[RECT_FILL_R] + (p[RECT_BORDER_R] - p[RECT_FILL_R]) * t;
+                            sg[i] = p[RECT_FILL_G] + (p[RECT_BORDER_G] - p[RECT_FILL_G]) * t;
+                            sb[i] = p[RECT_FILL_B] + (p[RECT_BORDER_B] - p[RECT_FILL_B]) * t;
+                            sa[i] = (p[RECT_FILL_A] + (p[RECT_BORDER_A] - p[RECT_FILL_A]) * t) * coverage[i];
+                        }
+                        k.blendVarying(dr, dg, db, da, n, sr, sg, sb, sa);
+                    } else {
+                        k.blendConstant(dr, dg, db, da, n, p + RECT_FILL_R, coverage);
+                    }
+                    break;
+
+                case Shape::SEGMENT:
+                    k.segmentRow(p, x0, y, n, coverage);
+                    k.blendConstant(dr, dg, db, da, n, p + SEGMENT_R, coverage);
+                    break;
+
+                case Shape::POLYGON:
+                    polygonRow(p + 4, command.count, x0, y, n, coverage, crossings, nearEdges);
+                    k.blendConstant(dr, dg, db, da, n, p, coverage);
+                    break;
+
+                case Shape::TEXTURED_QUAD: {
+                    const Image& image = *command.image;
+                    const float iw = static_cast<float>(image.width), ih = static_cast<float>(image.height);
+                    const float v = p[5] + (y - p[1]) / p[3] * p[7];
+                    float distanceWidth = 0.0f;
+                    if (command.distance_range > 0.0f) {
+                        // Smooth over one screen pixel, like fwidth() in the shader
+                        float texelsPerPixel = std::max(std::fabs(p[6] * iw / p[2]), std::fabs(p[7] * ih / p[3]));
+                        distanceWidth = std::max(0.5f * texelsPerPixel / command.distance_range, 1e-4f);
+                    }
+
+                    for (int i = 0; i < n; ++i) {
+                        const float u = p[4] + (x0 + i + 0.5f - p[0]) / p[2] * p[6];
+                        float texel[4];
+                        if (command.linear) {
+                            float fx = u * iw - 0.5f, fy = v * ih - 0.5f;
+                            int ix = static_cast<int>(std::floor(fx)), iy = static_cast<int>(std::floor(fy));
+                            float tx = fx - ix, ty = fy - iy;
+                            int xa = wrapTexel(ix, image.width, command.wrap_s), xb = wrapTexel(ix + 1, image.width, command.wrap_s);
+                            int ya = wrapTexel(iy, image.height, command.wrap_t), yb = wrapTexel(iy + 1, image.height, command.wrap_t);
+                            const unsigned char* t00 = &image.rgba[(static_cast<size_t>(ya) * image.width + xa) * 4];
+                            const unsigned char* t10 = &image.rgba[(static_cast<size_t>(ya) * image.width + xb) * 4];
+                            const unsigned char* t01 = &image.rgba[(static_cast<size_t>(yb) * image.width + xa) * 4];
+                            const unsigned char* t11 = &image.rgba[(static_cast<size_t>(yb) * image.width + xb) * 4];
+                            for (int c = 0; c < 4; ++c) {
+                                float bottom = t00[c] + (t10[c] - t00[c]) * tx;
+                                float top = t01[c] + (t11[c] - t01[c]) * tx;
+                                texel[c] = (bottom + (top - bottom) * ty) * (1.0f / 255.0f);
+                            }
+                        } else {
+                            int ix = wrapTexel(static_cast<int>(std::floor(u * iw)), image.width, command.wrap_s);
+                            int iy = wrapTexel(static_cast<int>(std::floor(v * ih)), image.height, command.wrap_t);
+                            const unsigned char* t = &image.rgba[(static_cast<size_t>(iy) * image.width + ix) * 4];
+                            for (int c = 0; c < 4; ++c) {
+                                texel[c] = t[c] * (1.0f / 255.0f);
+                            }
+                        }
+
+                        if (command.distance_range > 0.0f) {
+                            float s = std::min(std::max((texel[3] - (0.5f - distanceWidth)) / (2.0f * distanceWidth), 0.0f), 1.0f);
+                            sr[i] = p[8];
+                            sg[i] = p[9];
+                            sb[i] = p[10];
+                            sa[i] = p[11] * s * s * (3.0f - 2.0f * s);
+                        } else {
+                            sr[i] = texel[0] * p[8];
+                            sg[i] = texel[1] * p[9];
+                            sb[i] = texel[2] * p[10];
+                            sa[i] = texel[3] * p[11];
+                        }
+                    }
+                    k.blendVarying(dr, dg, db, da, n, sr, sg, sb, sa);
+                    break;
+                }
+                }
+            }
+        }
+
+        for (int py = 0; py < tileHeight; ++py) {
+            unsigned char* out = &pixels[(static_cast<size_t>(originY + py) * width + originX) * 4];
+            const int row = py * TILE_SIZE;
+            for (int px = 0; px < tileWidth; ++px, out += 4) {
+                out[0] = static_cast<unsigned char>(std::min(std::max(r[row + px], 0.0f), 1.0f) * 255.0f + 0.5f);
+                out[1] = static_cast<unsigned char>(std::min(std::max(g[row + px], 0.0f), 1.0f) * 255.0f + 0.5f);
+                out[2] = static_cast<unsigned char>(std::min(std::max(b[row + px], 0.0f), 1.0f) * 255.0f + 0.5f);
+                out[3] = static_cast<unsigned char>(std::min(std::max(a[row + px], 0.0f), 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::applyEffect(Effect effect) {
+        if (effect == Effect::BLUR) {
+            // 3x3 box blur, clamped at the edges
+            std::vector<unsigned char> source(pixels);
+            std::function<void(int)> blurRow = [this, &source](int y) {
+                for (int x = 0; x < width; ++x) {
+                    int sum[3] = {0, 0, 0};
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        int sy = std::min(std::max(y + dy, 0), height - 1);
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            int sx = std::min(std::max(x + dx, 0), width - 1);
+                            const unsigned char* s = &source[(static_cast<size_t>(sy) * width + sx) * 4];
+                            sum[0] += s[0];
+                            sum[1] += s[1];
+                            sum[2] += s[2];
+                        }
+                    }
+                    unsigned char* out = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+                    out[0] = static_cast<unsigned char>((sum[0] + 4) / 9);
+                    out[1] = static_cast<unsigned char>((sum[1] + 4) / 9);
+                    out[2] = static_cast<unsigned char>((sum[2] + 4) / 9);
+                    out[3] = 255;
+                }
+            };
+            runParallel(height, blurRow);
+            return;
+        }
+
+        std::function<void(int)> colorRow = [this, effect](int y) {
+            unsigned char* out = &pixels[static_cast<size_t>(y) * width * 4];
+            for (int x = 0; x < width; ++x, out += 4) {
+                if (effect == Effect::GRAYSCALE) {
+                    unsigned char gray = static_cast<unsigned char>(0.299f * out[0] + 0.587f * out[1] + 0.114f * out[2] + 0.5f);
+                    out[0] = out[1] = out[2] = gray;
+                } else {
+                    out[0] = 255 - out[0];
+                    out[1] = 255 - out[1];
+                    out[2] = 255 - out[2];
+                }
+                out[3] = 255;
+            }
+        };
+        runParallel(height, colorRow);
+    }
+
+    void SoftwareRasterizer::render() {
+        pixels.resize(static_cast<size_t>(width) * height * 4);
+        if (width == 0 || height == 0) return;
+
+        binCommands();
+
+        std::function<void(int)> tileJob = [this](int tile) { rasterizeTile(tile); };
+        runParallel(tiles_x * tiles_y, tileJob);
+
+        for (Effect effect : effects) {
+            applyEffect(effect);
+        }
+    }
+
+    bool SoftwareRasterizer::copyTo(Texture& texture) const {
+        if (width == 0 || height == 0 || pixels.empty()) return false;
+        if (!texture.isValid() || texture.getWidth() != width || texture.getHeight() != height) {
+            if (!texture.create(width, height, Texture::Format::RGBA)) return false;
+        }
+        return texture.updateRegion(0, 0, width, height, pixels.data(), Texture::Format::RGBA);
+    }
+
+    void SoftwareRasterizer::present() {
+        if (!copyTo(frame_texture)) return;
+
+        GLint previousRead = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+        if (read_framebuffer == 0) glGenFramebuffers(1, &read_framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame_texture.getID(), 0);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+    }
+
+    void SoftwareRasterizer::setThreadCount(int count) {
+        if (count == thread_count) return;
+        stopWorkers();
+        thread_count = std::max(count, 0);
+    }
+
+    void SoftwareRasterizer::startWorkers() {
+        if (!workers.empty()) return;
+        int count = thread_count > 0 ? thread_count : static_cast<int>(std::thread::hardware_concurrency());
+        uint64_t generation = job_generation;
+        for (int i = 1; i < count; ++i) {
+            workers.emplace_back(&SoftwareRasterizer::workerLoop, this, generation);
+        }
+    }
+
+    void SoftwareRasterizer::stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            stopping = true;
+        }
+        wake_condition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stopping = false;
+    }
+
+    void SoftwareRasterizer::workerLoop(uint64_t seen) {
+        for (;;) {
+            const std::function<void(int)>* function;
+            int count;
+            {
+                std::unique_lock<std::mutex> lock(pool_mutex);
+                wake_condition.wait(lock, [this, seen] { return stopping || job_generation != seen; });
+                if (stopping) return;
+                seen = job_generation;
+                function = job;
+                count = job_count;
+                ++joined_workers;
+                ++busy_workers;
+            }
+
+            for (int i = next_job.fetch_add(1); i < count; i = next_job.fetch_add(1)) {
+                (*function)(i);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex);
+                --busy_workers;
+            }
+            done_condition.notify_all();
+        }
+    }
+
+    void SoftwareRasterizer::runParallel(int count, const std::function<void(int)>& function) {
+        if (count <= 0) return;
+        kernels();  // Select the kernels before any worker needs them
+        startWorkers();
+        if (workers.empty() || count == 1) {
+            for (int i = 0; i < count; ++i) function(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            job = &function;
+            job_count = count;
+            next_job = 0;
+            joined_workers = 0;
+            ++job_generation;
+        }
+        wake_condition.notify_all();
+
+        for (int i = next_job.fetch_add(1); i < count; i = next_job.fetch_add(1)) {
+            function(i);
+        }
+
+        // Every worker must have joined this generation, so none can pick up
+        // the function after it goes out of scope
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        done_condition.wait(lock, [this] {
+            return joined_workers == static_cast<int>(workers.size()) && busy_workers == 0;
+        });
+        job = nullptr;
+    }
+
+    void SoftwareRasterizer::destroy() {
+        stopWorkers();
+        commands.clear();
+        params.clear();
+        tiles.clear();
+        images.clear();
+        pixels.clear();
+        pixels.shrink_to_fit();
+        frame_texture.destroy();
+        if (read_framebuffer != 0) {
+            glDeleteFramebuffers(1, &read_framebuffer);
+            read_framebuffer = 0;
+        }
+    }
+} // namespace cridgeon
@@ -0,0 +1,207 @@
+/// @file rasterizer.hpp
+/// @brief CPU rasterizer for the 2D primitive set, used by the Render::
+///        functions when RenderingSystem's software backend is selected.
+///        Primitives are recorded in submission order, binned into square
+///        screen tiles, and the tiles are rasterized in parallel: each tile
+///        blends its commands in order into a local float buffer, so the
+///        result keeps painter's order. Coverage uses the same signed
+///        distance functions as the GL shaders, evaluated 8 pixels at a time
+///        with AVX2 when the CPU supports it.
+
+#ifndef CRIDGEON_SOFTWARE_RASTERIZER_HPP
+#define CRIDGEON_SOFTWARE_RASTERIZER_HPP
+
+#include "texture/texture.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cridgeon {
+    struct SamplerState;
+
+    class SoftwareRasterizer {
+    public:
+        static const int TILE_SIZE = 64;
+
+        /// @brief Floats per textured quad: rect (4), subtexture (4), tint (4),
+        ///        the same layout as Render::appendTextureQuads.
+        static const int QUAD_FLOATS = 12;
+
+        /// @brief Full-frame effects applied after rasterization, matching
+        ///        the shaders in resources/shaders/postprocess.
+        enum class Effect {
+            GRAYSCALE,
+            INVERT,
+            BLUR
+        };
+
+        static SoftwareRasterizer& getInstance();
+
+        SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+        SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+        /// @brief Starts a frame, dropping the commands of the previous one.
+        /// @param width The frame width in pixels.
+        /// @param height The frame height in pixels.
+        /// @param clearColor The RGBA color every pixel starts with.
+        void begin(int width, int height, const float clearColor[4]);
+
+        /// @brief Records an annulus sector; see Render::appendRadialShape.
+        void radial(float x, float y, float innerRadius, float outerRadius,
+                    float startAngle, float span, bool roundCaps, const float color[4]);
+
+        /// @brief Records a rounded rectangle; see Render::roundedRect.
+        void roundedRect(float x, float y, float w, float h, const float radii[4],
+                         float borderWidth, const float fillColor[4], const float borderColor[4]);
+
+        /// @brief Records a line segment with round ends.
+        void segment(float x0, float y0, float x1, float y1, float width, const float color[4]);
+
+        /// @brief Records a filled polygon (nonzero winding, any shape).
+        /// @param vertices x, y pairs.
+        /// @param pointCount Number of points.
+        void polygon(const float* vertices, size_t pointCount, const float color[4]);
+
+        /// @brief Reserves textured quads to fill in, like Render::appendTextureQuads.
+        ///        The texture is read back once and cached until it changes.
+        /// @param textureID The GL texture to sample.
+        /// @param count Number of quads.
+        /// @param sampler Sampling state, or null for the texture's own parameters.
+        /// @param distanceRange When positive, the texture's alpha is a distance
+        ///        field spanning this many texels from 0 to 1, drawn like
+        ///        Render::sdfText.
+        /// @returns Pointer to count * QUAD_FLOATS floats, valid until the next
+        ///          call, or null if the texture could not be read.
+        float* texturedQuads(unsigned int textureID, size_t count,
+                             const SamplerState* sampler = nullptr, float distanceRange = 0.0f);
+
+        /// @brief Sets the effects applied, in order, at the end of render().
+        void setEffects(const std::vector<Effect>& frameEffects) { effects = frameEffects; }
+
+        /// @brief Rasterizes the recorded commands into the pixel buffer.
+        void render();
+
+        /// @brief The last rendered frame: RGBA bytes, bottom row first, so it
+        ///        can be uploaded to a Texture as is.
+        const std::vector<unsigned char>& getPixels() const { return pixels; }
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+
+        /// @brief Uploads the last rendered frame, (re)creating the texture at
+        ///        the frame size if needed.
+        bool copyTo(Texture& texture) const;
+
+        /// @brief Uploads the last rendered frame and copies it to the bound
+        ///        draw framebuffer.
+        void present();
+
+        /// @brief Texture wrap modes of the sampling code; clamp to border
+        ///        is sampled as clamp to edge.
+        enum class Wrap : uint8_t {
+            CLAMP,
+            REPEAT,
+            MIRROR
+        };
+
+        /// @brief Drops the cached copy of a texture; called whenever a
+        ///        texture's parameters change or it is deleted.
+        void forgetTexture(unsigned int textureID);
+
+        /// @brief Copies new texels into the cached copy of a texture, if
+        ///        there is one; called by Texture::updateRegion().
+        /// @param channels 4 for RGBA data, 3 for RGB, rows tightly packed.
+        void updateTexture(unsigned int textureID, int x, int y, int w, int h,
+                           const unsigned char* data, int channels);
+
+        /// @brief Sets the number of threads rasterizing tiles, including the
+        ///        calling thread. 0 uses every hardware thread.
+        void setThreadCount(int count);
+
+        /// @brief Checks whether the AVX2 kernels are in use.
+        static bool usingAVX2();
+
+        /// @brief Stops the worker threads and releases all buffers and textures.
+        void destroy();
+
+    private:
+        enum class Shape : uint8_t {
+            RADIAL,
+            ROUNDED_RECT,
+            SEGMENT,
+            POLYGON,
+            TEXTURED_QUAD
+        };
+
+        struct Image {
+            int width = 0;
+            int height = 0;
+            bool linear = true;
+            Wrap wrap_s = Wrap::CLAMP;
+            Wrap wrap_t = Wrap::CLAMP;
+            std::vector<unsigned char> rgba;
+        };
+
+        struct Command {
+            Shape shape;
+            bool linear;            // Textured quads: bilinear filtering
+            Wrap wrap_s, wrap_t;
+            float distance_range;   // Textured quads: distance field range in texels, 0 for color
+            uint32_t params;        // Offset into params
+            uint32_t count;         // Polygon point count
+            float min_x, min_y, max_x, max_y;
+            std::shared_ptr<const Image> image;
+        };
+
+        std::vector<Command> commands;
+        std::vector<float> params;
+        std::vector<std::vector<uint32_t>> tiles;
+        int tiles_x, tiles_y;
+
+        int width, height;
+        float clear_color[4];
+        std::vector<unsigned char> pixels;
+        std::vector<Effect> effects;
+
+        std::unordered_map<unsigned int, std::shared_ptr<const Image>> images;
+        Texture frame_texture;
+        unsigned int read_framebuffer;
+
+        // Worker pool; the thread calling render() takes part as well
+        std::vector<std::thread> workers;
+        std::mutex pool_mutex;
+        std::condition_variable wake_condition;
+        std::condition_variable done_condition;
+        const std::function<void(int)>* job;
+        int job_count;
+        std::atomic<int> next_job;
+        uint64_t job_generation;
+        int joined_workers;     // Workers that picked up the current generation
+        int busy_workers;
+        bool stopping;
+        int thread_count;
+
+        SoftwareRasterizer();
+        ~SoftwareRasterizer();
+
+        std::shared_ptr<const Image> getImage(unsigned int textureID);
+        float* addCommand(Shape shape, size_t floatCount, float minX, float minY, float maxX, float maxY);
+        void binCommands();
+        void rasterizeTile(int tile);
+        void applyEffect(Effect effect);
+
+        void runParallel(int count, const std::function<void(int)>& function);
+        void startWorkers();
+        void stopWorkers();
+        void workerLoop(uint64_t generation);
+    };
+} // namespace cridgeon
+
+#endif // CRIDGEON_SOFTWARE_RASTERIZER_HPP
@@ -0,0 +1,161 @@
+#include "stream_buffer.hpp"
+#include "gl_capabilities.hpp"
+
+#include <glad/gl.h>
+#include <cstring>
+#include <iostream>
+
+namespace cridgeon
+{
+    static GLenum targetToGL(StreamBuffer::Target target) {
+        return target == StreamBuffer::Target::INDIRECT ? GL_DRAW_INDIRECT_BUFFER : GL_ARRAY_BUFFER;
+    }
+
+    StreamBuffer::StreamBuffer()
+        : bufferID(0), target(Target::VERTEX), capacity(0), head(0), section(0), mapped(nullptr), fences{} {}
+
+    StreamBuffer::~StreamBuffer() {
+        destroy();
+    }
+
+    bool StreamBuffer::create(size_t size, Target bufferTarget) {
+        destroy();
+
+        target = bufferTarget;
+        capacity = size;
+        head = 0;
+        section = 0;
+
+        const GLCapabilities& caps = glCapabilities();
+        const GLExtFunctions& ext = glExt();
+        GLenum glTarget = targetToGL(target);
+
+        if (caps.bufferStorage) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            if (caps.directStateAccess) {
+                ext.CreateBuffers(1, &bufferID);
+                ext.NamedBufferStorage(bufferID, capacity, nullptr, flags);
+                mapped = static_cast<unsigned char*>(ext.MapNamedBufferRange(bufferID, 0, capacity, flags));
+            } else {
+                glGenBuffers(1, &bufferID);
+                glBindBuffer(glTarget, bufferID);
+                ext.BufferStorage(glTarget, capacity, nullptr, flags);
+                mapped = static_cast<unsigned char*>(glMapBufferRange(glTarget, 0, capacity, flags));
+            }
+
+            if (mapped == nullptr) {
+                std::cerr << "Warning: Persistent mapping failed, falling back to orphaning stream buffer" << std::endl;
+                glDeleteBuffers(1, &bufferID);
+                bufferID = 0;
+            }
+        }
+
+        if (bufferID == 0) {
+            glGenBuffers(1, &bufferID);
+            glBindBuffer(glTarget, bufferID);
+            glBufferData(glTarget, capacity, nullptr, GL_STREAM_DRAW);
+        }
+
+        return bufferID != 0;
+    }
+
+    size_t StreamBuffer::write(const void* data, size_t size, size_t alignment) {
+        if (bufferID == 0 || size > capacity) {
+            size_t newCapacity = capacity > 0 ? capacity : 64 * 1024;
+            while (newCapacity < size) newCapacity *= 2;
+            if (!create(newCapacity, target)) {
+                return 0;
+            }
+        }
+
+        GLenum glTarget = targetToGL(target);
+        size_t offset = (head + alignment - 1) / alignment * alignment;
+        bool wrapped = offset + size > capacity;
+        if (wrapped) {
+            offset = 0;
+        }
+
+        if (mapped) {
+            // Fence the sections we are leaving and wait for the GPU to finish
+            // reading the ones we are about to overwrite.
+            if (wrapped) {
+                for (int s = section; s < SECTIONS; ++s) {
+                    leaveSection(s);
+                }
+                section = 0;
+                enterSection(0);
+            }
+            int lastSection = static_cast<int>((offset + size - 1) * SECTIONS / capacity);
+            while (section < lastSection) {
+                leaveSection(section);
+                ++section;
+                enterSection(section);
+            }
+
+            std::memcpy(mapped + offset, data, size);
+            glBindBuffer(glTarget, bufferID);
+        } else {
+            glBindBuffer(glTarget, bufferID);
+            if (wrapped) {
+                // Orphan the old storage; the driver keeps it alive for in-flight draws
+                glBufferData(glTarget, capacity, nullptr, GL_STREAM_DRAW);
+            }
+            void* destination = glMapBufferRange(glTarget, offset, size,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (destination) {
+                std::memcpy(destination, data, size);
+                glUnmapBuffer(glTarget);
+            } else {
+                glBufferSubData(glTarget, offset, size, data);
+            }
+        }
+
+        head = offset + size;
+        return offset;
+    }
+
+    void StreamBuffer::bind() const {
+        glBindBuffer(targetToGL(target), bufferID);
+    }
+
+    void StreamBuffer::enterSection(int index) {
+        GLsync fence = static_cast<GLsync>(fences[index]);
+        if (fence) {
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            glDeleteSync(fence);
+            fences[index] = nullptr;
+        }
+    }
+
+    void StreamBuffer::leaveSection(int index) {
+        if (fences[index]) {
+            glDeleteSync(static_cast<GLsync>(fences[index]));
+        }
+        fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void StreamBuffer::destroy() {
+        for (int s = 0; s < SECTIONS; ++s) {
+            if (fences[s]) {
+                glDeleteSync(static_cast<GLsync>(fences[s]));
+                fences[s] = nullptr;
+            }
+        }
+        if (bufferID != 0) {
+            if (mapped) {
+                GLenum glTarget = targetToGL(target);
+                glBindBuffer(glTarget, bufferID);
+                glUnmapBuffer(glTarget);
+                mapped = nullptr;
+            }
+            glDeleteBuffers(1, &bufferID);
+            bufferID = 0;
+        }
+        capacity = 0;
+        head = 0;
+        section = 0;
+    }
+} // namespace cridgeon
@@ -0,0 +1,71 @@
+/// @file stream_buffer.hpp
+/// @brief Ring buffer for streaming per-frame vertex data to the GPU.
+///        On GL 4.4+ the buffer is allocated with glBufferStorage and mapped
+///        once, persistently and coherently; writes are plain memcpys fenced
+///        per ring section. Older contexts map unsynchronized ranges and
+///        orphan the buffer when the ring wraps.
+#ifndef CRIDGEON_STREAM_BUFFER_HPP
+#define CRIDGEON_STREAM_BUFFER_HPP
+
+#include <cstddef>
+
+namespace cridgeon {
+    class StreamBuffer {
+    public:
+        enum class Target {
+            VERTEX,     // GL_ARRAY_BUFFER
+            INDIRECT    // GL_DRAW_INDIRECT_BUFFER (GL 4.0+)
+        };
+
+        StreamBuffer();
+        ~StreamBuffer();
+
+        // Disable copy constructor and assignment operator
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+        /// @brief Allocates the ring.
+        /// @param capacity Size of the ring in bytes.
+        /// @param target What the buffer will be bound as.
+        /// @returns True if the buffer was created.
+        bool create(size_t capacity, Target target = Target::VERTEX);
+
+        /// @brief Copies data into the ring, growing it if the data does not fit.
+        /// @param data The data to copy.
+        /// @param size The number of bytes to copy.
+        /// @param alignment Required alignment of the returned offset.
+        /// @returns The byte offset of the data inside the buffer. The buffer
+        ///          is left bound to its target.
+        size_t write(const void* data, size_t size, size_t alignment = 16);
+
+        /// @brief Binds the buffer to its target.
+        void bind() const;
+
+        /// @brief Gets the OpenGL buffer ID.
+        unsigned int getID() const { return bufferID; }
+
+        /// @brief Checks whether the persistent-mapped path is in use.
+        bool isPersistent() const { return mapped != nullptr; }
+
+        bool isValid() const { return bufferID != 0; }
+
+        /// @brief Releases the buffer and any pending fences.
+        void destroy();
+
+    private:
+        static const int SECTIONS = 3;
+
+        unsigned int bufferID;
+        Target target;
+        size_t capacity;
+        size_t head;
+        int section;
+        unsigned char* mapped;
+        void* fences[SECTIONS];
+
+        void enterSection(int index);
+        void leaveSection(int index);
+    };
+} // namespace cridgeon
+
+#endif // CRIDGEON_STREAM_BUFFER_HPP
@@ -0,0 +1,15 @@
+#ifndef CRIDGEON_TEXT_ALL_HPP
+#define CRIDGEON_TEXT_ALL_HPP
+
+#include "font.hpp"
+#include "glyph_atlas.hpp"
+#include "sdf_atlas.hpp"
+#include "text.hpp"
+
+namespace cridgeon::Render {
+    inline void destroyAllText() {
+        _destroyText();
+    }
+}
+
+#endif // CRIDGEON_TEXT_ALL_HPP
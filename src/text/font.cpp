@@ -0,0 +1,614 @@
+#include "font.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace cridgeon {
+
+    static uint32_t nextFontID = 1;
+
+    // Simple glyph point flags
+    static const uint8_t FLAG_ON_CURVE = 0x01;
+    static const uint8_t FLAG_X_SHORT = 0x02;
+    static const uint8_t FLAG_Y_SHORT = 0x04;
+    static const uint8_t FLAG_REPEAT = 0x08;
+    static const uint8_t FLAG_X_SAME_OR_POSITIVE = 0x10;
+    static const uint8_t FLAG_Y_SAME_OR_POSITIVE = 0x20;
+
+    // Composite glyph component flags
+    static const uint16_t COMPONENT_ARGS_ARE_WORDS = 0x0001;
+    static const uint16_t COMPONENT_ARGS_ARE_XY = 0x0002;
+    static const uint16_t COMPONENT_HAS_SCALE = 0x0008;
+    static const uint16_t COMPONENT_MORE = 0x0020;
+    static const uint16_t COMPONENT_HAS_XY_SCALE = 0x0040;
+    static const uint16_t COMPONENT_HAS_2X2 = 0x0080;
+
+    static const int MAX_COMPOSITE_DEPTH = 8;
+
+    Font::Font()
+        : font_id(0), content_hash(0), cmap_offset(0), loca_offset(0), glyf_offset(0), hmtx_offset(0), kern_offset(0),
+          units_per_em(0), index_to_loc_format(0), num_glyphs(0), num_hmetrics(0),
+          ascender(0), descender(0), line_gap(0) {}
+
+    bool Font::loadFromFile(const std::string& file_path) {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to open font file: " << file_path << std::endl;
+            return false;
+        }
+        std::vector<unsigned char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!loadFromMemory(contents)) {
+            std::cerr << "Failed to load font: " << file_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool Font::loadFromMemory(const std::vector<unsigned char>& contents) {
+        data = contents;
+        if (!parse()) {
+            data.clear();
+            return false;
+        }
+        font_id = nextFontID++;
+
+        // 64-bit FNV-1a
+        content_hash = 0xcbf29ce484222325ull;
+        for (unsigned char byte : data) {
+            content_hash = (content_hash ^ byte) * 0x100000001b3ull;
+        }
+        return true;
+    }
+
+    uint8_t Font::u8(uint32_t offset) const {
+        return offset < data.size() ? data[offset] : 0;
+    }
+
+    uint16_t Font::u16(uint32_t offset) const {
+        return static_cast<uint16_t>((u8(offset) << 8) | u8(offset + 1));
+    }
+
+    int16_t Font::i16(uint32_t offset) const {
+        return static_cast<int16_t>(u16(offset));
+    }
+
+    uint32_t Font::u32(uint32_t offset) const {
+        return (static_cast<uint32_t>(u16(offset)) << 16) | u16(offset + 2);
+    }
+
+    uint32_t Font::findTable(uint32_t font_start, const char* tag) const {
+        uint16_t num_tables = u16(font_start + 4);
+        for (uint16_t i = 0; i < num_tables; ++i) {
+            uint32_t record = font_start + 12 + 16u * i;
+            if (record + 16 > data.size()) break;
+            if (std::memcmp(&data[record], tag, 4) == 0) {
+                return u32(record + 8);
+            }
+        }
+        return 0;
+    }
+
+    bool Font::parse() {
+        if (data.size() < 12) return false;
+
+        uint32_t font_start = 0;
+        if (std::memcmp(data.data(), "ttcf", 4) == 0) {
+            font_start = u32(12);
+        }
+        uint32_t version = u32(font_start);
+        if (version != 0x00010000 && version != 0x74727565) {   // 1.0 or 'true'
+            std::cerr << "Unsupported font format (only TrueType outlines are supported)" << std::endl;
+            return false;
+        }
+
+        uint32_t head = findTable(font_start, "head");
+        uint32_t maxp = findTable(font_start, "maxp");
+        uint32_t hhea = findTable(font_start, "hhea");
+        uint32_t cmap = findTable(font_start, "cmap");
+        hmtx_offset = findTable(font_start, "hmtx");
+        loca_offset = findTable(font_start, "loca");
+        glyf_offset = findTable(font_start, "glyf");
+        if (!head || !maxp || !hhea || !cmap || !hmtx_offset || !loca_offset || !glyf_offset) {
+            std::cerr << "Font is missing a required table" << std::endl;
+            return false;
+        }
+
+        units_per_em = u16(head + 18);
+        index_to_loc_format = i16(head + 50);
+        num_glyphs = u16(maxp + 4);
+        ascender = i16(hhea + 4);
+        descender = i16(hhea + 6);
+        line_gap = i16(hhea + 8);
+        num_hmetrics = u16(hhea + 34);
+        if (units_per_em == 0 || num_hmetrics == 0) return false;
+
+        // Prefer a full Unicode (format 12) map, then the BMP (format 4) map
+        cmap_offset = 0;
+        uint16_t num_maps = u16(cmap + 2);
+        for (uint16_t i = 0; i < num_maps; ++i) {
+            uint32_t record = cmap + 4 + 8u * i;
+            uint16_t platform = u16(record);
+            uint16_t encoding = u16(record + 2);
+            uint32_t subtable = cmap + u32(record + 4);
+            uint16_t format = u16(subtable);
+            bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+            if (!unicode || (format != 4 && format != 12)) continue;
+            if (cmap_offset == 0 || format == 12) {
+                cmap_offset = subtable;
+            }
+        }
+        if (cmap_offset == 0) {
+            std::cerr << "Font has no supported Unicode character map" << std::endl;
+            return false;
+        }
+
+        // Only the classic horizontal format 0 kerning subtable is read
+        kern_offset = 0;
+        uint32_t kern = findTable(font_start, "kern");
+        if (kern && u16(kern) == 0 && u16(kern + 2) > 0) {
+            uint32_t subtable = kern + 4;
+            uint16_t coverage = u16(subtable + 4);
+            if ((coverage >> 8) == 0 && (coverage & 1)) {
+                kern_offset = subtable;
+            }
+        }
+        return true;
+    }
+
+    int Font::getGlyphIndex(uint32_t codepoint) const {
+        if (!isValid()) return 0;
+
+        uint16_t format = u16(cmap_offset);
+        if (format == 12) {
+            uint32_t groups = u32(cmap_offset + 12);
+            uint32_t low = 0, high = groups;
+            while (low < high) {
+                uint32_t mid = (low + high) / 2;
+                uint32_t group = cmap_offset + 16 + 12 * mid;
+                uint32_t start = u32(group);
+                uint32_t end = u32(group + 4);
+                if (codepoint < start) {
+                    high = mid;
+                } else if (codepoint > end) {
+                    low = mid + 1;
+                } else {
+                    return static_cast<int>(u32(group + 8) + (codepoint - start));
+                }
+            }
+            return 0;
+        }
+
+        if (codepoint > 0xFFFF) return 0;
+        uint16_t seg_count_x2 = u16(cmap_offset + 6);
+        uint32_t end_codes = cmap_offset + 14;
+        uint32_t start_codes = end_codes + seg_count_x2 + 2;
+        uint32_t id_deltas = start_codes + seg_count_x2;
+        uint32_t id_range_offsets = id_deltas + seg_count_x2;
+
+        uint32_t low = 0, high = seg_count_x2 / 2;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (u16(end_codes + 2 * mid) < codepoint) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low >= seg_count_x2 / 2u) return 0;
+
+        uint16_t start = u16(start_codes + 2 * low);
+        if (codepoint < start) return 0;
+        uint16_t delta = u16(id_deltas + 2 * low);
+        uint32_t range_offset_address = id_range_offsets + 2 * low;
+        uint16_t range_offset = u16(range_offset_address);
+        if (range_offset == 0) {
+            return (codepoint + delta) & 0xFFFF;
+        }
+        uint16_t glyph = u16(range_offset_address + range_offset + 2 * (codepoint - start));
+        return glyph == 0 ? 0 : (glyph + delta) & 0xFFFF;
+    }
+
+    float Font::getScale(float pixel_size) const {
+        return units_per_em > 0 ? pixel_size / units_per_em : 0.0f;
+    }
+
+    float Font::getAdvance(int glyph, float pixel_size) const {
+        if (!isValid()) return 0.0f;
+        int metric = std::min(glyph, num_hmetrics - 1);
+        return u16(hmtx_offset + 4 * metric) * getScale(pixel_size);
+    }
+
+    float Font::getKerning(int left_glyph, int right_glyph, float pixel_size) const {
+        if (kern_offset == 0) return 0.0f;
+
+        uint32_t pairs = u16(kern_offset + 6);
+        uint32_t needle = (static_cast<uint32_t>(left_glyph) << 16) | static_cast<uint32_t>(right_glyph);
+        uint32_t low = 0, high = pairs;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            uint32_t pair = kern_offset + 14 + 6 * mid;
+            uint32_t value = u32(pair);
+            if (needle < value) {
+                high = mid;
+            } else if (needle > value) {
+                low = mid + 1;
+            } else {
+                return i16(pair + 4) * getScale(pixel_size);
+            }
+        }
+        return 0.0f;
+    }
+
+    float Font::getAscender(float pixel_size) const {
+        return ascender * getScale(pixel_size);
+    }
+
+    float Font::getDescender(float pixel_size) const {
+        return descender * getScale(pixel_size);
+    }
+
+    float Font::getLineHeight(float pixel_size) const {
+        return (ascender - descender + line_gap) * getScale(pixel_size);
+    }
+
+    uint32_t Font::getGlyphOffset(int glyph, uint32_t* length) const {
+        *length = 0;
+        if (glyph < 0 || glyph >= num_glyphs) return 0;
+
+        uint32_t start, end;
+        if (index_to_loc_format == 0) {
+            start = u16(loca_offset + 2 * glyph) * 2u;
+            end = u16(loca_offset + 2 * glyph + 2) * 2u;
+        } else {
+            start = u32(loca_offset + 4 * glyph);
+            end = u32(loca_offset + 4 * glyph + 4);
+        }
+        if (end <= start) return 0;
+        *length = end - start;
+        return glyf_offset + start;
+    }
+
+    /// @brief Appends a quadratic curve as line segments, excluding its start point.
+    static void flattenQuadratic(std::vector<Font::Point>& contour, Font::Point p0, Font::Point p1, Font::Point p2,
+                                 float tolerance) {
+        float ddx = p0.x - 2.0f * p1.x + p2.x;
+        float ddy = p0.y - 2.0f * p1.y + p2.y;
+        float dd = std::sqrt(ddx * ddx + ddy * ddy);
+        // The deviation of an n-segment approximation is |p0 - 2 p1 + p2| / (8 n^2)
+        int segments = static_cast<int>(std::ceil(std::sqrt(dd / (8.0f * tolerance))));
+        segments = std::max(1, std::min(segments, 64));
+
+        for (int i = 1; i <= segments; ++i) {
+            float t = static_cast<float>(i) / segments;
+            float mt = 1.0f - t;
+            contour.push_back({mt * mt * p0.x + 2.0f * mt * t * p1.x + t * t * p2.x,
+                               mt * mt * p0.y + 2.0f * mt * t * p1.y + t * t * p2.y});
+        }
+    }
+
+    void Font::appendGlyphContours(int glyph, const float transform[6], float tolerance,
+                                   Outline& outline, int depth) const {
+        uint32_t length = 0;
+        uint32_t offset = getGlyphOffset(glyph, &length);
+        if (length == 0) return;
+
+        auto apply = [transform](float x, float y) {
+            return Point{transform[0] * x + transform[2] * y + transform[4],
+                         transform[1] * x + transform[3] * y + transform[5]};
+        };
+
+        int16_t contour_count = i16(offset);
+        if (contour_count < 0) {
+            if (depth >= MAX_COMPOSITE_DEPTH) return;
+
+            uint32_t p = offset + 10;
+            uint16_t flags;
+            do {
+                flags = u16(p);
+                int component = u16(p + 2);
+                p += 4;
+
+                float dx = 0.0f, dy = 0.0f;
+                if (flags & COMPONENT_ARGS_ARE_WORDS) {
+                    if (flags & COMPONENT_ARGS_ARE_XY) { dx = i16(p); dy = i16(p + 2); }
+                    p += 4;
+                } else {
+                    if (flags & COMPONENT_ARGS_ARE_XY) {
+                        dx = static_cast<int8_t>(u8(p));
+                        dy = static_cast<int8_t>(u8(p + 1));
+                    }
+                    p += 2;
+                }
+                // Point-matched placement is not supported; such components stay at the origin
+
+                float a = 1.0f, b = 0.0f, c = 0.0f, d = 1.0f;
+                if (flags & COMPONENT_HAS_SCALE) {
+                    a = d = i16(p) / 16384.0f;
+                    p += 2;
+                } else if (flags & COMPONENT_HAS_XY_SCALE) {
+                    a = i16(p) / 16384.0f;
+                    d = i16(p + 2) / 16384.0f;
+                    p += 4;
+                } else if (flags & COMPONENT_HAS_2X2) {
+                    a = i16(p) / 16384.0f;
+                    b = i16(p + 2) / 16384.0f;
+                    c = i16(p + 4) / 16384.0f;
+                    d = i16(p + 6) / 16384.0f;
+                    p += 8;
+                }
+
+                // Parent transform applied after the component's own
+                float combined[6] = {
+                    transform[0] * a + transform[2] * b,
+                    transform[1] * a + transform[3] * b,
+                    transform[0] * c + transform[2] * d,
+                    transform[1] * c + transform[3] * d,
+                    transform[0] * dx + transform[2] * dy + transform[4],
+                    transform[1] * dx + transform[3] * dy + transform[5]
+                };
+                appendGlyphContours(component, combined, tolerance, outline, depth + 1);
+            } while ((flags & COMPONENT_MORE) && p < offset + length);
+            return;
+        }
+
+        // Simple glyph: end points, instructions, flags, then delta-encoded coordinates
+        std::vector<uint16_t> end_points(contour_count);
+        for (int i = 0; i < contour_count; ++i) {
+            end_points[i] = u16(offset + 10 + 2 * i);
+        }
+        if (contour_count == 0) return;
+        int point_count = end_points.back() + 1;
+
+        uint32_t p = offset + 10 + 2 * contour_count;
+        p += 2 + u16(p);
+
+        std::vector<uint8_t> flags(point_count);
+        for (int i = 0; i < point_count;) {
+            uint8_t flag = u8(p++);
+            int repeat = (flag & FLAG_REPEAT) ? u8(p++) : 0;
+            for (int r = 0; r <= repeat && i < point_count; ++r) {
+                flags[i++] = flag;
+            }
+        }
+
+        std::vector<Point> points(point_count);
+        int value = 0;
+        for (int i = 0; i < point_count; ++i) {
+            if (flags[i] & FLAG_X_SHORT) {
+                int delta = u8(p++);
+                value += (flags[i] & FLAG_X_SAME_OR_POSITIVE) ? delta : -delta;
+            } else if (!(flags[i] & FLAG_X_SAME_OR_POSITIVE)) {
+                value += i16(p);
+                p += 2;
+            }
+            points[i].x = static_cast<float>(value);
+        }
+        value = 0;
+        for (int i = 0; i < point_count; ++i) {
+            if (flags[i] & FLAG_Y_SHORT) {
+                int delta = u8(p++);
+                value += (flags[i] & FLAG_Y_SAME_OR_POSITIVE) ? delta : -delta;
+            } else if (!(flags[i] & FLAG_Y_SAME_OR_POSITIVE)) {
+                value += i16(p);
+                p += 2;
+            }
+            points[i].y = static_cast<float>(value);
+        }
+
+        int first = 0;
+        for (int c = 0; c < contour_count; ++c) {
+            int last = end_points[c];
+            if (last < first || last >= point_count) break;
+            int count = last - first + 1;
+
+            auto pointAt = [&](int i) { return apply(points[first + i].x, points[first + i].y); };
+            auto onCurve = [&](int i) { return (flags[first + i] & FLAG_ON_CURVE) != 0; };
+
+            // Start on an on-curve point, synthesizing one if every point is off-curve
+            int start = 0;
+            while (start < count && !onCurve(start)) ++start;
+            Point start_point;
+            if (start < count) {
+                start_point = pointAt(start);
+            } else {
+                Point a = pointAt(0), b = pointAt(count - 1);
+                start_point = {(a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f};
+                start = count - 1;
+            }
+
+            std::vector<Point> contour;
+            contour.push_back(start_point);
+            Point previous = start_point;
+            bool has_control = false;
+            Point control = start_point;
+            for (int k = 1; k <= count; ++k) {
+                int i = (start + k) % count;
+                Point point = pointAt(i);
+                if (onCurve(i)) {
+                    if (has_control) {
+                        flattenQuadratic(contour, previous, control, point, tolerance);
+                    } else {
+                        contour.push_back(point);
+                    }
+                    previous = point;
+                    has_control = false;
+                } else {
+                    if (has_control) {
+                        // Two consecutive off-curve points imply an on-curve midpoint
+                        Point middle = {(control.x + point.x) * 0.5f, (control.y + point.y) * 0.5f};
+                        flattenQuadratic(contour, previous, control, middle, tolerance);
+                        previous = middle;
+                    }
+                    control = point;
+                    has_control = true;
+                }
+            }
+            if (has_control) {
+                flattenQuadratic(contour, previous, control, start_point, tolerance);
+            }
+            contour.pop_back();     // The last point repeats the start
+
+            if (contour.size() >= 2) {
+                outline.contours.push_back(std::move(contour));
+            }
+            first = last + 1;
+        }
+    }
+
+    Font::Outline Font::getGlyphOutline(int glyph, float tolerance) const {
+        Outline outline;
+        if (!isValid()) return outline;
+
+        const float identity[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+        appendGlyphContours(glyph, identity, std::max(tolerance, 0.01f), outline, 0);
+
+        bool first = true;
+        for (const auto& contour : outline.contours) {
+            for (const auto& point : contour) {
+                if (first) {
+                    outline.x_min = outline.x_max = point.x;
+                    outline.y_min = outline.y_max = point.y;
+                    first = false;
+                }
+                outline.x_min = std::min(outline.x_min, point.x);
+                outline.x_max = std::max(outline.x_max, point.x);
+                outline.y_min = std::min(outline.y_min, point.y);
+                outline.y_max = std::max(outline.y_max, point.y);
+            }
+        }
+        return outline;
+    }
+
+    /// @brief Accumulates the signed area a line covers in each pixel. A running
+    ///        sum over the buffer then yields the coverage of the filled shape.
+    static void accumulateLine(std::vector<float>& accumulation, int width, int height, Font::Point p0, Font::Point p1) {
+        if (p0.y == p1.y) return;
+        float direction = 1.0f;
+        if (p0.y > p1.y) {
+            std::swap(p0, p1);
+            direction = -1.0f;
+        }
+
+        float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+        float x = p0.x;
+        if (p0.y < 0.0f) {
+            x -= p0.y * dxdy;
+        }
+
+        int y_start = std::max(0, static_cast<int>(std::floor(p0.y)));
+        int y_end = std::min(height, static_cast<int>(std::ceil(p1.y)));
+        for (int y = y_start; y < y_end; ++y) {
+            size_t row = static_cast<size_t>(y) * width;
+            float dy = std::min(static_cast<float>(y + 1), p1.y) - std::max(static_cast<float>(y), p0.y);
+            float x_next = x + dxdy * dy;
+            float d = dy * direction;
+
+            float x0 = std::min(x, x_next);
+            float x1 = std::max(x, x_next);
+            float x0_floor = std::floor(x0);
+            int x0i = static_cast<int>(x0_floor);
+            float x1_ceil = std::ceil(x1);
+            int x1i = static_cast<int>(x1_ceil);
+
+            if (x1i <= x0i + 1) {
+                float middle = 0.5f * (x + x_next) - x0_floor;
+                accumulation[row + x0i] += d - d * middle;
+                accumulation[row + x0i + 1] += d * middle;
+            } else {
+                float s = 1.0f / (x1 - x0);
+                float x0_fraction = x0 - x0_floor;
+                float a0 = 0.5f * s * (1.0f - x0_fraction) * (1.0f - x0_fraction);
+                float x1_fraction = x1 - x1_ceil + 1.0f;
+                float am = 0.5f * s * x1_fraction * x1_fraction;
+                accumulation[row + x0i] += d * a0;
+                if (x1i == x0i + 2) {
+                    accumulation[row + x0i + 1] += d * (1.0f - a0 - am);
+                } else {
+                    float a1 = s * (1.5f - x0_fraction);
+                    accumulation[row + x0i + 1] += d * (a1 - a0);
+                    for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                        accumulation[row + xi] += d * s;
+                    }
+                    float a2 = a1 + (x1i - x0i - 3) * s;
+                    accumulation[row + x1i - 1] += d * (1.0f - a2 - am);
+                }
+                accumulation[row + x1i] += d * am;
+            }
+            x = x_next;
+        }
+    }
+
+    bool Font::rasterizeGlyph(int glyph, float pixel_size, Bitmap& bitmap) const {
+        bitmap = Bitmap();
+        if (!isValid() || glyph < 0 || glyph >= num_glyphs || pixel_size <= 0.0f) return false;
+
+        float scale = getScale(pixel_size);
+        Outline outline = getGlyphOutline(glyph, 0.2f / scale);
+        if (outline.empty()) return true;
+
+        int left = static_cast<int>(std::floor(outline.x_min * scale));
+        int right = static_cast<int>(std::ceil(outline.x_max * scale));
+        int bottom = static_cast<int>(std::floor(outline.y_min * scale));
+        int top = static_cast<int>(std::ceil(outline.y_max * scale));
+        bitmap.width = std::max(1, right - left);
+        bitmap.height = std::max(1, top - bottom);
+        bitmap.left = left;
+        bitmap.top = top;
+
+        // Two spare cells: coverage may spill one past the last column of the last row
+        std::vector<float> accumulation(static_cast<size_t>(bitmap.width) * bitmap.height + 2, 0.0f);
+        const float max_x = static_cast<float>(bitmap.width);
+        for (const auto& contour : outline.contours) {
+            for (size_t i = 0; i < contour.size(); ++i) {
+                const Point& a = contour[i];
+                const Point& b = contour[(i + 1) % contour.size()];
+                Point p0 = {std::min(std::max(a.x * scale - left, 0.0f), max_x), top - a.y * scale};
+                Point p1 = {std::min(std::max(b.x * scale - left, 0.0f), max_x), top - b.y * scale};
+                accumulateLine(accumulation, bitmap.width, bitmap.height, p0, p1);
+            }
+        }
+
+        bitmap.pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.height);
+        float sum = 0.0f;
+        for (size_t i = 0; i < bitmap.pixels.size(); ++i) {
+            sum += accumulation[i];
+            float coverage = std::min(std::fabs(sum), 1.0f);
+            bitmap.pixels[i] = static_cast<unsigned char>(coverage * 255.0f + 0.5f);
+        }
+        return true;
+    }
+
+    uint32_t decodeUTF8(const std::string& text, size_t& index) {
+        const uint32_t REPLACEMENT = 0xFFFD;
+        unsigned char lead = static_cast<unsigned char>(text[index++]);
+        if (lead < 0x80) return lead;
+
+        int continuation;
+        uint32_t codepoint;
+        if ((lead & 0xE0) == 0xC0) {
+            continuation = 1;
+            codepoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            continuation = 2;
+            codepoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            continuation = 3;
+            codepoint = lead & 0x07;
+        } else {
+            return REPLACEMENT;
+        }
+
+        for (int i = 0; i < continuation; ++i) {
+            if (index >= text.size()) return REPLACEMENT;
+            unsigned char next = static_cast<unsigned char>(text[index]);
+            if ((next & 0xC0) != 0x80) return REPLACEMENT;
+            codepoint = (codepoint << 6) | (next & 0x3F);
+            ++index;
+        }
+        return codepoint > 0x10FFFF ? REPLACEMENT : codepoint;
+    }
+}
@@ -0,0 +1,136 @@
+/// @file font.hpp
+/// @brief Minimal TrueType font loader and glyph rasterizer. Reads the
+///        tables needed for horizontal Latin-style text (cmap, hmtx, glyf,
+///        loca, kern) and rasterizes quadratic outlines with exact area
+///        coverage anti-aliasing. OpenType CFF outlines and GPOS/GSUB
+///        shaping are not supported.
+///
+///        This parser stands in for stb_truetype, which is meant to be
+///        vendored into include/ next to stb_image.h. Once it is, the table
+///        parsing here (cmap, glyf/loca, kern) goes away and this class keeps
+///        only its interface, backed by stbtt_FindGlyphIndex,
+///        stbtt_GetGlyphShape and stbtt_MakeGlyphBitmap.
+#ifndef CRIDGEON_FONT_HPP
+#define CRIDGEON_FONT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cridgeon {
+    class Font {
+    public:
+        struct Point {
+            float x, y;
+        };
+
+        /// @brief A glyph outline flattened into closed polylines, in font
+        ///        units with y pointing up.
+        struct Outline {
+            std::vector<std::vector<Point>> contours;
+            float x_min = 0.0f, y_min = 0.0f, x_max = 0.0f, y_max = 0.0f;
+
+            bool empty() const { return contours.empty(); }
+        };
+
+        /// @brief A rasterized glyph. Rows are stored top to bottom.
+        struct Bitmap {
+            int width = 0;
+            int height = 0;
+            int left = 0;       // Offset from the pen position to the left column, in pixels
+            int top = 0;        // Offset from the baseline up to the top row, in pixels
+            std::vector<unsigned char> pixels;  // One byte per pixel
+        };
+
+        Font();
+
+        /// @brief Loads a TrueType (.ttf) font, or the first font of a collection.
+        /// @param file_path The path to the font file.
+        /// @returns True if the font was loaded, false otherwise.
+        bool loadFromFile(const std::string& file_path);
+
+        /// @brief Loads a TrueType font from memory. The data is copied.
+        /// @param data The font file contents.
+        /// @returns True if the font was loaded, false otherwise.
+        bool loadFromMemory(const std::vector<unsigned char>& data);
+
+        /// @brief Checks if a font has been loaded.
+        bool isValid() const { return !data.empty(); }
+
+        /// @brief Gets an identifier unique to this loaded font, for cache keys.
+        uint32_t getID() const { return font_id; }
+
+        /// @brief Gets a hash of the font file contents, stable across runs.
+        uint64_t getContentHash() const { return content_hash; }
+
+        /// @brief Maps a Unicode code point to a glyph index (0 if missing).
+        int getGlyphIndex(uint32_t codepoint) const;
+
+        /// @brief Pixels per font unit for a font size given in pixels per em.
+        float getScale(float pixel_size) const;
+
+        /// @brief Gets the horizontal advance of a glyph in pixels.
+        float getAdvance(int glyph, float pixel_size) const;
+
+        /// @brief Gets the kerning adjustment between two glyphs in pixels.
+        float getKerning(int left_glyph, int right_glyph, float pixel_size) const;
+
+        /// @brief Distance from the baseline to the top of the tallest glyphs, in pixels.
+        float getAscender(float pixel_size) const;
+
+        /// @brief Distance from the baseline to the bottom of the lowest glyphs
+        ///        (negative), in pixels.
+        float getDescender(float pixel_size) const;
+
+        /// @brief Recommended distance between baselines, in pixels.
+        float getLineHeight(float pixel_size) const;
+
+        /// @brief Gets a glyph outline with curves flattened to polylines.
+        /// @param glyph The glyph index.
+        /// @param tolerance Maximum flattening error in font units.
+        /// @returns The outline, empty for blank glyphs such as space.
+        Outline getGlyphOutline(int glyph, float tolerance) const;
+
+        /// @brief Rasterizes a glyph with anti-aliasing.
+        /// @param glyph The glyph index.
+        /// @param pixel_size The font size in pixels per em.
+        /// @param bitmap Receives the coverage bitmap (empty for blank glyphs).
+        /// @returns True on success, false if the glyph could not be read.
+        bool rasterizeGlyph(int glyph, float pixel_size, Bitmap& bitmap) const;
+
+    private:
+        std::vector<unsigned char> data;
+        uint32_t font_id;
+        uint64_t content_hash;
+
+        uint32_t cmap_offset;   // Offset of the selected cmap subtable
+        uint32_t loca_offset;
+        uint32_t glyf_offset;
+        uint32_t hmtx_offset;
+        uint32_t kern_offset;   // Offset of the first format 0 kern subtable, 0 if none
+        int units_per_em;
+        int index_to_loc_format;
+        int num_glyphs;
+        int num_hmetrics;
+        int ascender;
+        int descender;
+        int line_gap;
+
+        bool parse();
+        uint32_t findTable(uint32_t font_start, const char* tag) const;
+        uint32_t getGlyphOffset(int glyph, uint32_t* length) const;
+        void appendGlyphContours(int glyph, const float transform[6], float tolerance,
+                                 Outline& outline, int depth) const;
+
+        uint8_t u8(uint32_t offset) const;
+        uint16_t u16(uint32_t offset) const;
+        int16_t i16(uint32_t offset) const;
+        uint32_t u32(uint32_t offset) const;
+    };
+
+    /// @brief Decodes the UTF-8 code point starting at `index` and advances it.
+    ///        Invalid sequences decode to U+FFFD.
+    uint32_t decodeUTF8(const std::string& text, size_t& index);
+}
+
+#endif // CRIDGEON_FONT_HPP
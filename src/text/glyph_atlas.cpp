@@ -0,0 +1,95 @@
+#include "glyph_atlas.hpp"
+
+#include "shader/batch.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace cridgeon {
+
+    GlyphAtlas& GlyphAtlas::getInstance() {
+        static GlyphAtlas instance;
+        return instance;
+    }
+
+    GlyphAtlas::GlyphAtlas() : packer(ATLAS_SIZE), generation(0) {}
+
+    /// @brief Builds a cache key from font, glyph and size (quantized to 1/4 pixel).
+    static uint64_t glyphKey(const Font& font, int glyph, float pixel_size) {
+        uint64_t size = static_cast<uint64_t>(std::lround(pixel_size * 4.0f)) & 0xFFFF;
+        return (static_cast<uint64_t>(font.getID()) << 32) |
+               (static_cast<uint64_t>(glyph & 0xFFFF) << 16) | size;
+    }
+
+    const GlyphAtlas::Glyph* GlyphAtlas::getGlyph(const Font& font, int glyph, float pixel_size) {
+        if (!font.isValid()) return nullptr;
+
+        uint64_t key = glyphKey(font, glyph, pixel_size);
+        auto found = glyphs.find(key);
+        if (found != glyphs.end()) {
+            return &found->second;
+        }
+
+        Font::Bitmap bitmap;
+        if (!font.rasterizeGlyph(glyph, std::lround(pixel_size * 4.0f) / 4.0f, bitmap)) {
+            return nullptr;
+        }
+
+        Glyph entry;
+        entry.left = bitmap.left;
+        entry.top = bitmap.top;
+        if (bitmap.pixels.empty()) {
+            return &(glyphs[key] = entry);
+        }
+
+        if (!texture.isValid() && !texture.create(ATLAS_SIZE, ATLAS_SIZE, Texture::Format::RGBA)) {
+            std::cerr << "Failed to create glyph atlas texture" << std::endl;
+            return nullptr;
+        }
+
+        // Transparent border keeps neighbours out of linear filtering
+        int padded_width = bitmap.width + 2 * PADDING;
+        int padded_height = bitmap.height + 2 * PADDING;
+        int x, y;
+        if (!packer.pack(padded_width, padded_height, x, y)) {
+            clear();
+            if (!packer.pack(padded_width, padded_height, x, y)) {
+                std::cerr << "Glyph too large for atlas: " << bitmap.width << "x" << bitmap.height << std::endl;
+                return nullptr;
+            }
+        }
+
+        std::vector<unsigned char> pixels(static_cast<size_t>(padded_width) * padded_height * 4, 0);
+        for (int row = 0; row < bitmap.height; ++row) {
+            for (int column = 0; column < bitmap.width; ++column) {
+                unsigned char* pixel = &pixels[((row + PADDING) * padded_width + column + PADDING) * 4];
+                pixel[0] = pixel[1] = pixel[2] = 255;
+                pixel[3] = bitmap.pixels[row * bitmap.width + column];
+            }
+        }
+        texture.updateRegion(x, y, padded_width, padded_height, pixels.data(), Texture::Format::RGBA);
+
+        entry.width = bitmap.width;
+        entry.height = bitmap.height;
+        entry.u = static_cast<float>(x + PADDING) / ATLAS_SIZE;
+        entry.v = static_cast<float>(y + PADDING) / ATLAS_SIZE;
+        entry.u_size = static_cast<float>(bitmap.width) / ATLAS_SIZE;
+        entry.v_size = static_cast<float>(bitmap.height) / ATLAS_SIZE;
+        return &(glyphs[key] = entry);
+    }
+
+    void GlyphAtlas::clear() {
+        // Quads already queued must be drawn before their texels are reused
+        Render::flushBatches();
+        glyphs.clear();
+        packer.clear();
+        ++generation;
+    }
+
+    void GlyphAtlas::destroy() {
+        glyphs.clear();
+        packer.clear();
+        ++generation;
+        texture.destroy();
+    }
+}
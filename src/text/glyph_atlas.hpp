@@ -0,0 +1,65 @@
+/// @file glyph_atlas.hpp
+/// @brief Shared texture atlas of rasterized glyphs. Glyphs are rasterized on
+///        first use and shelf-packed into a single RGBA texture (white color,
+///        coverage in alpha), so every string drawn with any font and size
+///        samples the same texture and batches into the same draw calls.
+
+#ifndef CRIDGEON_GLYPH_ATLAS_HPP
+#define CRIDGEON_GLYPH_ATLAS_HPP
+
+#include "font.hpp"
+#include "shelf_packer.hpp"
+#include "texture/texture.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace cridgeon {
+    class GlyphAtlas {
+    public:
+        /// @brief Location and placement of a glyph in the atlas.
+        struct Glyph {
+            float u = 0.0f, v = 0.0f;           // Top-left texture coordinate
+            float u_size = 0.0f, v_size = 0.0f; // Size in texture coordinates
+            int width = 0, height = 0;          // Size in pixels (0 for blank glyphs)
+            int left = 0, top = 0;              // Offset from the pen position, y up
+        };
+
+        static GlyphAtlas& getInstance();
+
+        /// @brief Looks up a glyph, rasterizing and packing it on a miss. When
+        ///        the atlas is full it is cleared and the generation advances;
+        ///        any pending batched quads are flushed first.
+        /// @param font The font to rasterize from.
+        /// @param glyph The glyph index.
+        /// @param pixel_size The font size in pixels per em.
+        /// @returns The glyph, or nullptr if it could not be rasterized or packed.
+        const Glyph* getGlyph(const Font& font, int glyph, float pixel_size);
+
+        /// @brief Gets the atlas texture ID (0 before the first glyph is packed).
+        unsigned int getTextureID() const { return texture.getID(); }
+
+        /// @brief Counter incremented whenever packed glyphs are discarded.
+        ///        Cached texture coordinates are stale once it changes.
+        uint32_t getGeneration() const { return generation; }
+
+        /// @brief Discards every packed glyph.
+        void clear();
+
+        /// @brief Releases the atlas texture.
+        void destroy();
+
+    private:
+        static const int ATLAS_SIZE = 1024;
+        static const int PADDING = 1;
+
+        Texture texture;
+        ShelfPacker packer;
+        uint32_t generation;
+        std::unordered_map<uint64_t, Glyph> glyphs;
+
+        GlyphAtlas();
+    };
+}
+
+#endif // CRIDGEON_GLYPH_ATLAS_HPP
@@ -0,0 +1,336 @@
+#include "sdf_atlas.hpp"
+
+#include "shader/batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace cridgeon {
+
+    static const char CACHE_MAGIC[4] = {'C', 'S', 'D', 'F'};
+    static const int32_t CACHE_VERSION = 1;
+
+    SDFAtlas& SDFAtlas::getInstance() {
+        static SDFAtlas instance;
+        return instance;
+    }
+
+    SDFAtlas::SDFAtlas()
+        : packer(ATLAS_SIZE), generation(0), cache_directory("sdf_cache"), busy_workers(0), stopping(false) {}
+
+    SDFAtlas::~SDFAtlas() {
+        stopWorkers();
+    }
+
+    static uint64_t fieldKey(const Font& font, int glyph) {
+        return (static_cast<uint64_t>(font.getID()) << 32) | static_cast<uint32_t>(glyph);
+    }
+
+    void SDFAtlas::setCacheDirectory(const std::string& directory) {
+        cache_directory = directory;
+    }
+
+    /// @brief Computes a distance field from a glyph outline. Values map the
+    ///        signed distance (positive inside) from [-SPREAD, SPREAD] pixels
+    ///        to [0, 255], so the outline sits at 128.
+    static void generateField(const Font::Outline& outline, float scale, int spread,
+                              int& width, int& height, int& left, int& top,
+                              std::vector<unsigned char>& distances) {
+        left = static_cast<int>(std::floor(outline.x_min * scale)) - spread;
+        top = static_cast<int>(std::ceil(outline.y_max * scale)) + spread;
+        width = static_cast<int>(std::ceil(outline.x_max * scale)) + spread - left;
+        height = top - (static_cast<int>(std::floor(outline.y_min * scale)) - spread);
+
+        // Edges in bitmap space, y down
+        std::vector<float> edges;
+        for (const auto& contour : outline.contours) {
+            for (size_t i = 0; i < contour.size(); ++i) {
+                const Font::Point& a = contour[i];
+                const Font::Point& b = contour[(i + 1) % contour.size()];
+                const float edge[4] = {a.x * scale - left, top - a.y * scale, b.x * scale - left, top - b.y * scale};
+                edges.insert(edges.end(), edge, edge + 4);
+            }
+        }
+
+        distances.resize(static_cast<size_t>(width) * height);
+        for (int py = 0; py < height; ++py) {
+            float cy = py + 0.5f;
+            for (int px = 0; px < width; ++px) {
+                float cx = px + 0.5f;
+                float closest = 1e30f;
+                int winding = 0;
+                for (size_t e = 0; e < edges.size(); e += 4) {
+                    float x0 = edges[e], y0 = edges[e + 1], x1 = edges[e + 2], y1 = edges[e + 3];
+                    float dx = x1 - x0, dy = y1 - y0;
+                    float length_squared = dx * dx + dy * dy;
+                    float t = length_squared > 0.0f ? ((cx - x0) * dx + (cy - y0) * dy) / length_squared : 0.0f;
+                    t = std::min(std::max(t, 0.0f), 1.0f);
+                    float ex = x0 + t * dx - cx, ey = y0 + t * dy - cy;
+                    closest = std::min(closest, ex * ex + ey * ey);
+
+                    // Nonzero winding of a ray cast towards +x
+                    float side = dx * (cy - y0) - (cx - x0) * dy;
+                    if (y0 <= cy) {
+                        if (y1 > cy && side > 0.0f) ++winding;
+                    } else if (y1 <= cy && side < 0.0f) {
+                        --winding;
+                    }
+                }
+
+                float distance = std::sqrt(closest);
+                if (winding == 0) distance = -distance;
+                float value = 0.5f + distance / (2.0f * spread);
+                value = std::min(std::max(value, 0.0f), 1.0f);
+                distances[static_cast<size_t>(py) * width + px] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    void SDFAtlas::startWorkers() {
+        if (!workers.empty()) return;
+        int count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        count = std::max(1, std::min(count, 4));
+        for (int i = 0; i < count; ++i) {
+            workers.emplace_back(&SDFAtlas::workerLoop, this);
+        }
+    }
+
+    void SDFAtlas::stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+            jobs.clear();
+        }
+        queue_condition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = false;
+    }
+
+    void SDFAtlas::workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                ++busy_workers;
+            }
+
+            Result result;
+            result.key = job.key;
+            Field& field = result.field;
+            generateField(job.outline, job.scale, SPREAD, field.width, field.height, field.left, field.top, field.distances);
+
+            if (!job.cache_file.empty()) {
+                std::lock_guard<std::mutex> lock(file_mutex);
+                std::ofstream file(job.cache_file, std::ios::binary | std::ios::app);
+                const int32_t header[5] = {static_cast<int32_t>(job.key & 0xFFFFFFFF),
+                                           field.width, field.height, field.left, field.top};
+                file.write(reinterpret_cast<const char*>(header), sizeof(header));
+                file.write(reinterpret_cast<const char*>(field.distances.data()), field.distances.size());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                results.push_back(std::move(result));
+                --busy_workers;
+            }
+            done_condition.notify_all();
+        }
+    }
+
+    const std::string& SDFAtlas::openFontCache(const Font& font) {
+        auto found = font_cache_files.find(font.getID());
+        if (found != font_cache_files.end()) {
+            return found->second;
+        }
+
+        std::string& path = font_cache_files[font.getID()];
+        if (cache_directory.empty()) {
+            return path;
+        }
+
+#ifdef _WIN32
+        _mkdir(cache_directory.c_str());
+#else
+        mkdir(cache_directory.c_str(), 0755);
+#endif
+        char name[32];
+        std::snprintf(name, sizeof(name), "/%016llx.sdf", static_cast<unsigned long long>(font.getContentHash()));
+        path = cache_directory + name;
+
+        std::lock_guard<std::mutex> lock(file_mutex);
+        std::ifstream input(path, std::ios::binary);
+        char magic[4] = {};
+        int32_t parameters[3] = {};
+        input.read(magic, sizeof(magic));
+        input.read(reinterpret_cast<char*>(parameters), sizeof(parameters));
+        bool compatible = input && std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) == 0 &&
+                          parameters[0] == CACHE_VERSION && parameters[1] == BASE_SIZE && parameters[2] == SPREAD;
+
+        if (compatible) {
+            int32_t header[5];
+            while (input.read(reinterpret_cast<char*>(header), sizeof(header))) {
+                Field field;
+                field.width = header[1];
+                field.height = header[2];
+                field.left = header[3];
+                field.top = header[4];
+                if (field.width < 0 || field.height < 0 || field.width > ATLAS_SIZE || field.height > ATLAS_SIZE) break;
+                field.distances.resize(static_cast<size_t>(field.width) * field.height);
+                if (!input.read(reinterpret_cast<char*>(field.distances.data()), field.distances.size())) break;
+                fields[fieldKey(font, header[0])] = std::move(field);
+            }
+            return path;
+        }
+
+        // Missing or written with other parameters: start a fresh file
+        input.close();
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            std::cerr << "Failed to create SDF cache file: " << path << std::endl;
+            path.clear();
+            return path;
+        }
+        const int32_t new_parameters[3] = {CACHE_VERSION, BASE_SIZE, SPREAD};
+        output.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        output.write(reinterpret_cast<const char*>(new_parameters), sizeof(new_parameters));
+        return path;
+    }
+
+    void SDFAtlas::update() {
+        std::vector<Result> finished;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            finished.swap(results);
+        }
+        for (auto& result : finished) {
+            queued.erase(result.key);
+            fields[result.key] = std::move(result.field);
+        }
+    }
+
+    void SDFAtlas::finishPending() {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            done_condition.wait(lock, [this] { return jobs.empty() && busy_workers == 0; });
+        }
+        update();
+    }
+
+    const SDFAtlas::Glyph* SDFAtlas::packField(uint64_t key, const Field& field) {
+        Glyph entry;
+        entry.left = field.left;
+        entry.top = field.top;
+        if (field.width == 0 || field.height == 0) {
+            return &(glyphs[key] = entry);
+        }
+
+        if (!texture.isValid() && !texture.create(ATLAS_SIZE, ATLAS_SIZE, Texture::Format::RGBA)) {
+            std::cerr << "Failed to create SDF atlas texture" << std::endl;
+            return nullptr;
+        }
+
+        int x, y;
+        if (!packer.pack(field.width, field.height, x, y)) {
+            clear();
+            if (!packer.pack(field.width, field.height, x, y)) {
+                std::cerr << "Glyph too large for SDF atlas: " << field.width << "x" << field.height << std::endl;
+                return nullptr;
+            }
+        }
+
+        std::vector<unsigned char> pixels(field.distances.size() * 4);
+        for (size_t i = 0; i < field.distances.size(); ++i) {
+            pixels[i * 4] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = 255;
+            pixels[i * 4 + 3] = field.distances[i];
+        }
+        texture.updateRegion(x, y, field.width, field.height, pixels.data(), Texture::Format::RGBA);
+
+        entry.width = field.width;
+        entry.height = field.height;
+        entry.u = static_cast<float>(x) / ATLAS_SIZE;
+        entry.v = static_cast<float>(y) / ATLAS_SIZE;
+        entry.u_size = static_cast<float>(field.width) / ATLAS_SIZE;
+        entry.v_size = static_cast<float>(field.height) / ATLAS_SIZE;
+        return &(glyphs[key] = entry);
+    }
+
+    const SDFAtlas::Glyph* SDFAtlas::getGlyph(const Font& font, int glyph, bool* pending) {
+        if (pending) *pending = false;
+        if (!font.isValid()) return nullptr;
+
+        update();
+
+        uint64_t key = fieldKey(font, glyph);
+        auto packed = glyphs.find(key);
+        if (packed != glyphs.end()) {
+            return &packed->second;
+        }
+
+        if (queued.count(key)) {
+            if (pending) *pending = true;
+            return nullptr;
+        }
+
+        const std::string& cache_file = openFontCache(font);
+        auto generated = fields.find(key);
+        if (generated != fields.end()) {
+            return packField(key, generated->second);
+        }
+
+        float scale = font.getScale(static_cast<float>(BASE_SIZE));
+        Font::Outline outline = font.getGlyphOutline(glyph, 0.1f / scale);
+        if (outline.empty()) {
+            return packField(key, fields[key]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            jobs.push_back({key, std::move(outline), scale, cache_file});
+        }
+        queued.insert(key);
+        startWorkers();
+        queue_condition.notify_one();
+
+        if (pending) *pending = true;
+        return nullptr;
+    }
+
+    void SDFAtlas::clear() {
+        // Quads already queued must be drawn before their texels are reused
+        Render::flushBatches();
+        glyphs.clear();
+        packer.clear();
+        ++generation;
+    }
+
+    void SDFAtlas::destroy() {
+        stopWorkers();
+        results.clear();
+        queued.clear();
+        fields.clear();
+        font_cache_files.clear();
+        glyphs.clear();
+        packer.clear();
+        ++generation;
+        texture.destroy();
+    }
+}
@@ -0,0 +1,127 @@
+/// @file sdf_atlas.hpp
+/// @brief Signed distance field glyph atlas. Each glyph is stored once, at a
+///        fixed base size, as a distance field that renders sharply at any
+///        size, so zooming text never rasterizes or packs new glyphs.
+///        Distance fields are generated on worker threads and persisted to
+///        an on-disk cache keyed by the font file contents.
+
+#ifndef CRIDGEON_SDF_ATLAS_HPP
+#define CRIDGEON_SDF_ATLAS_HPP
+
+#include "font.hpp"
+#include "shelf_packer.hpp"
+#include "texture/texture.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cridgeon {
+    class SDFAtlas {
+    public:
+        /// Font size, in pixels per em, distance fields are generated at
+        static const int BASE_SIZE = 32;
+        /// Distance range in base size pixels on each side of the outline
+        static const int SPREAD = 4;
+
+        /// @brief Location and placement of a glyph, in base size pixels.
+        struct Glyph {
+            float u = 0.0f, v = 0.0f;           // Top-left texture coordinate
+            float u_size = 0.0f, v_size = 0.0f; // Size in texture coordinates
+            int width = 0, height = 0;          // Size including the spread (0 for blank glyphs)
+            int left = 0, top = 0;              // Offset from the pen position, y up
+        };
+
+        static SDFAtlas& getInstance();
+
+        /// @brief Sets the directory distance fields are cached in. An empty
+        ///        path disables the disk cache. Applies to fonts not used yet.
+        void setCacheDirectory(const std::string& directory);
+
+        /// @brief Looks up a glyph. Missing glyphs are loaded from the disk
+        ///        cache or queued for generation on a worker thread.
+        /// @param font The font the glyph belongs to.
+        /// @param glyph The glyph index.
+        /// @param pending Set to true if the glyph is still being generated.
+        /// @returns The glyph, or nullptr if it is pending or failed.
+        const Glyph* getGlyph(const Font& font, int glyph, bool* pending = nullptr);
+
+        /// @brief Uploads distance fields finished by the workers. Called by
+        ///        getGlyph; call it once per frame when no text is drawn.
+        void update();
+
+        /// @brief Blocks until every queued glyph has been generated and uploaded.
+        void finishPending();
+
+        /// @brief Gets the atlas texture ID (0 before the first glyph is packed).
+        unsigned int getTextureID() const { return texture.getID(); }
+
+        /// @brief Counter incremented whenever packed glyphs are discarded.
+        uint32_t getGeneration() const { return generation; }
+
+        /// @brief Discards every packed glyph. Generated distance fields stay
+        ///        in memory and are repacked on demand.
+        void clear();
+
+        /// @brief Stops the workers and releases the atlas texture.
+        void destroy();
+
+    private:
+        struct Field {
+            int width = 0, height = 0;
+            int left = 0, top = 0;
+            std::vector<unsigned char> distances;
+        };
+
+        struct Job {
+            uint64_t key;
+            Font::Outline outline;
+            float scale;
+            std::string cache_file;
+        };
+
+        struct Result {
+            uint64_t key;
+            Field field;
+        };
+
+        static const int ATLAS_SIZE = 1024;
+
+        Texture texture;
+        ShelfPacker packer;
+        uint32_t generation;
+        std::string cache_directory;
+
+        std::unordered_map<uint64_t, Glyph> glyphs;     // Packed, by font id and glyph
+        std::unordered_map<uint64_t, Field> fields;     // Generated, by font id and glyph
+        std::unordered_map<uint32_t, std::string> font_cache_files;
+        std::unordered_set<uint64_t> queued;
+
+        std::vector<std::thread> workers;
+        std::mutex queue_mutex;
+        std::condition_variable queue_condition;
+        std::condition_variable done_condition;
+        std::deque<Job> jobs;
+        std::vector<Result> results;
+        int busy_workers;
+        bool stopping;
+        std::mutex file_mutex;
+
+        SDFAtlas();
+        ~SDFAtlas();
+
+        void startWorkers();
+        void stopWorkers();
+        void workerLoop();
+        const std::string& openFontCache(const Font& font);
+        const Glyph* packField(uint64_t key, const Field& field);
+    };
+}
+
+#endif // CRIDGEON_SDF_ATLAS_HPP
@@ -0,0 +1,35 @@
+#include "shelf_packer.hpp"
+
+namespace cridgeon {
+
+    ShelfPacker::ShelfPacker(int size) : size(size), next_shelf_y(0) {}
+
+    bool ShelfPacker::pack(int width, int height, int& x, int& y) {
+        // Best fitting shelf that is not much taller than the rectangle
+        Shelf* best = nullptr;
+        for (auto& shelf : shelves) {
+            if (shelf.height < height || shelf.height > height + height / 2 + 2) continue;
+            if (shelf.x + width > size) continue;
+            if (!best || shelf.height < best->height) {
+                best = &shelf;
+            }
+        }
+
+        if (!best) {
+            if (next_shelf_y + height > size || width > size) return false;
+            shelves.push_back({next_shelf_y, height, 0});
+            next_shelf_y += height;
+            best = &shelves.back();
+        }
+
+        x = best->x;
+        y = best->y;
+        best->x += width;
+        return true;
+    }
+
+    void ShelfPacker::clear() {
+        shelves.clear();
+        next_shelf_y = 0;
+    }
+}
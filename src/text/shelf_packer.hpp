@@ -0,0 +1,42 @@
+/// @file shelf_packer.hpp
+/// @brief Shelf rectangle packer for glyph atlases. Rectangles are placed
+///        left to right on horizontal shelves; a new shelf is opened below
+///        the last one when no existing shelf has a similar height.
+
+#ifndef CRIDGEON_SHELF_PACKER_HPP
+#define CRIDGEON_SHELF_PACKER_HPP
+
+#include <vector>
+
+namespace cridgeon {
+    class ShelfPacker {
+    public:
+        explicit ShelfPacker(int size);
+
+        /// @brief Finds room for a rectangle.
+        /// @param width The rectangle width in pixels.
+        /// @param height The rectangle height in pixels.
+        /// @param x Receives the left edge of the placed rectangle.
+        /// @param y Receives the top edge of the placed rectangle.
+        /// @returns False if the packer is full.
+        bool pack(int width, int height, int& x, int& y);
+
+        /// @brief Forgets every placed rectangle.
+        void clear();
+
+        int getSize() const { return size; }
+
+    private:
+        struct Shelf {
+            int y;
+            int height;
+            int x;
+        };
+
+        int size;
+        std::vector<Shelf> shelves;
+        int next_shelf_y;
+    };
+}
+
+#endif // CRIDGEON_SHELF_PACKER_HPP
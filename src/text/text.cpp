@@ -0,0 +1,284 @@
+#include "text.hpp"
+
+#include "glyph_atlas.hpp"
+#include "sdf_atlas.hpp"
+#include "rendering_system.hpp"
+#include "shader/shader.hpp"
+#include "shader/batch.hpp"
+#include "shader/utility.hpp"
+#include "shader/geometry/texture_quad.hpp"
+#include "software/rasterizer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace cridgeon {
+namespace Render {
+
+    // rect (4) and subtexture (4); the tint is filled in per draw
+    static const int RUN_QUAD_FLOATS = 8;
+
+    // Cached runs are dropped all at once past this many, bounding memory for
+    // applications that draw ever-changing strings (timers, counters)
+    static const size_t MAX_CACHED_RUNS = 32768;
+
+    /// @brief A laid out string: glyph quads relative to the pen origin.
+    struct TextRun {
+        std::vector<float> quads;
+        float width = 0.0f;
+        uint32_t generation = 0;
+        bool valid = false;
+        bool complete = true;   // False while distance field glyphs are pending
+    };
+
+    // Runs keyed by font and size first, so lookups never copy the string
+    static std::unordered_map<uint64_t, std::unordered_map<std::string, TextRun>> runCache;
+    static size_t cachedRunCount = 0;
+
+    // Distance field runs are laid out at SDFAtlas::BASE_SIZE and scaled when drawn
+    static std::unordered_map<uint32_t, std::unordered_map<std::string, TextRun>> sdfRunCache;
+    static size_t cachedSDFRunCount = 0;
+
+    static Shader sdfTextShader;
+
+    /// @brief Binds the distance field shader and the atlas texture in a batch key.
+    static void setupSDFText(uint64_t key) {
+        sdfTextShader.use();
+
+        auto& rs = RenderingSystem::getInstance();
+        glUniform2f(sdfTextShader.getUniformLocation("resolution"),
+                    static_cast<float>(rs.getWindowWidth()),
+                    static_cast<float>(rs.getWindowHeight()));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, static_cast<unsigned int>(key >> 32));
+        glUniform1i(sdfTextShader.getUniformLocation("textureSampler"), 0);
+    }
+
+    // Same instance layout as textured quads: rect (4), subtexture (4), tint (4)
+    static InstanceBatch sdfTextBatch({4, 4, 4}, setupSDFText);
+
+    static uint64_t runGroupKey(const Font& font, float pixelSize) {
+        uint32_t sizeBits;
+        std::memcpy(&sizeBits, &pixelSize, sizeof(sizeBits));
+        return (static_cast<uint64_t>(font.getID()) << 32) | sizeBits;
+    }
+
+    /// @brief Lays out a string, packing any missing glyphs into the atlas.
+    /// @returns False if the atlas was cleared part way through.
+    static bool layoutRun(const Font& font, const std::string& text, float pixelSize, TextRun& run) {
+        GlyphAtlas& atlas = GlyphAtlas::getInstance();
+        uint32_t generation = atlas.getGeneration();
+
+        run.quads.clear();
+        float pen = 0.0f;
+        int previous = -1;
+        size_t index = 0;
+        while (index < text.size()) {
+            int glyph = font.getGlyphIndex(decodeUTF8(text, index));
+            if (previous >= 0) {
+                pen += font.getKerning(previous, glyph, pixelSize);
+            }
+
+            const GlyphAtlas::Glyph* entry = atlas.getGlyph(font, glyph, pixelSize);
+            if (atlas.getGeneration() != generation) return false;
+
+            if (entry && entry->width > 0) {
+                // Snap each glyph to the pixel grid it was rasterized on; the
+                // quad's v runs top to bottom, so flip it for the y-up quad
+                float x = std::floor(pen + 0.5f) + entry->left;
+                float y = static_cast<float>(entry->top - entry->height);
+                const float quad[RUN_QUAD_FLOATS] = {
+                    x, y, static_cast<float>(entry->width), static_cast<float>(entry->height),
+                    entry->u, entry->v + entry->v_size, entry->u_size, -entry->v_size
+                };
+                run.quads.insert(run.quads.end(), quad, quad + RUN_QUAD_FLOATS);
+            }
+
+            pen += font.getAdvance(glyph, pixelSize);
+            previous = glyph;
+        }
+
+        run.width = pen;
+        run.generation = generation;
+        run.valid = true;
+        return true;
+    }
+
+    /// @brief Finds or builds the cached run for a string.
+    static const TextRun* getRun(const Font& font, const std::string& text, float pixelSize) {
+        if (cachedRunCount >= MAX_CACHED_RUNS) {
+            runCache.clear();
+            cachedRunCount = 0;
+        }
+
+        auto& group = runCache[runGroupKey(font, pixelSize)];
+        auto found = group.find(text);
+        if (found == group.end()) {
+            found = group.emplace(text, TextRun()).first;
+            ++cachedRunCount;
+        }
+
+        TextRun& run = found->second;
+        uint32_t generation = GlyphAtlas::getInstance().getGeneration();
+        if (!run.valid || run.generation != generation) {
+            // A clear mid-layout leaves an empty atlas, so the retry fits
+            // unless the string alone needs more than the whole atlas
+            if (!layoutRun(font, text, pixelSize, run) && !layoutRun(font, text, pixelSize, run)) {
+                run.valid = false;
+                return nullptr;
+            }
+        }
+        return &run;
+    }
+
+    void text(const Font& font, const std::string& text,
+              float x, float y, float pixelSize,
+              float r, float g, float b, float a) {
+        if (!font.isValid() || text.empty() || pixelSize <= 0.0f) return;
+
+        const TextRun* run = getRun(font, text, pixelSize);
+        if (!run || run->quads.empty()) return;
+
+        size_t count = run->quads.size() / RUN_QUAD_FLOATS;
+        float* out = appendTextureQuads(GlyphAtlas::getInstance().getTextureID(), count);
+        if (!out) return;
+
+        float originX = std::floor(x + 0.5f);
+        float originY = std::floor(y + 0.5f);
+        const float* quad = run->quads.data();
+        for (size_t i = 0; i < count; ++i, quad += RUN_QUAD_FLOATS, out += TEXTURE_QUAD_FLOATS) {
+            out[0] = quad[0] + originX;
+            out[1] = quad[1] + originY;
+            std::memcpy(out + 2, quad + 2, 6 * sizeof(float));
+            out[8] = r; out[9] = g; out[10] = b; out[11] = a;
+        }
+    }
+
+    /// @brief Lays out a string at the distance field base size. Pending
+    ///        glyphs leave the run incomplete so it is laid out again later.
+    /// @returns False if the atlas was cleared part way through.
+    static bool layoutSDFRun(const Font& font, const std::string& text, TextRun& run) {
+        SDFAtlas& atlas = SDFAtlas::getInstance();
+        uint32_t generation = atlas.getGeneration();
+        const float baseSize = static_cast<float>(SDFAtlas::BASE_SIZE);
+
+        run.quads.clear();
+        run.complete = true;
+        float pen = 0.0f;
+        int previous = -1;
+        size_t index = 0;
+        while (index < text.size()) {
+            int glyph = font.getGlyphIndex(decodeUTF8(text, index));
+            if (previous >= 0) {
+                pen += font.getKerning(previous, glyph, baseSize);
+            }
+
+            bool pending = false;
+            const SDFAtlas::Glyph* entry = atlas.getGlyph(font, glyph, &pending);
+            if (atlas.getGeneration() != generation) return false;
+            if (pending) run.complete = false;
+
+            if (entry && entry->width > 0) {
+                const float quad[RUN_QUAD_FLOATS] = {
+                    pen + entry->left, static_cast<float>(entry->top - entry->height),
+                    static_cast<float>(entry->width), static_cast<float>(entry->height),
+                    entry->u, entry->v + entry->v_size, entry->u_size, -entry->v_size
+                };
+                run.quads.insert(run.quads.end(), quad, quad + RUN_QUAD_FLOATS);
+            }
+
+            pen += font.getAdvance(glyph, baseSize);
+            previous = glyph;
+        }
+
+        run.width = pen;
+        run.generation = generation;
+        run.valid = true;
+        return true;
+    }
+
+    void sdfText(const Font& font, const std::string& text,
+                 float x, float y, float pixelSize,
+                 float r, float g, float b, float a) {
+        if (!font.isValid() || text.empty() || pixelSize <= 0.0f) return;
+
+        const bool software = RenderingSystem::getInstance().getBackend() == RenderBackend::SOFTWARE;
+        if (!software && !sdfTextShader.isValid() && !sdfTextShader.loadFromFile(
+            "resources/shaders/instanced/texture_quad.vert",
+            "resources/shaders/instanced/sdf_text.frag",
+            {"corner", "rect", "subtexture", "tint"})) {
+            std::cerr << "Failed to load SDF text shader" << std::endl;
+            return;
+        }
+
+        if (cachedSDFRunCount >= MAX_CACHED_RUNS) {
+            sdfRunCache.clear();
+            cachedSDFRunCount = 0;
+        }
+
+        auto& group = sdfRunCache[font.getID()];
+        auto found = group.find(text);
+        if (found == group.end()) {
+            found = group.emplace(text, TextRun()).first;
+            ++cachedSDFRunCount;
+        }
+
+        TextRun& run = found->second;
+        SDFAtlas& atlas = SDFAtlas::getInstance();
+        if (!run.valid || !run.complete || run.generation != atlas.getGeneration()) {
+            if (!layoutSDFRun(font, text, run) && !layoutSDFRun(font, text, run)) {
+                run.valid = false;
+                return;
+            }
+        }
+        if (run.quads.empty()) return;
+
+        size_t count = run.quads.size() / RUN_QUAD_FLOATS;
+        float* out = software
+            ? SoftwareRasterizer::getInstance().texturedQuads(atlas.getTextureID(), count, nullptr, 2.0f * SDFAtlas::SPREAD)
+            : sdfTextBatch.append(static_cast<uint64_t>(atlas.getTextureID()) << 32, count);
+        if (!out) return;
+
+        const float scale = pixelSize / SDFAtlas::BASE_SIZE;
+        const float* quad = run.quads.data();
+        for (size_t i = 0; i < count; ++i, quad += RUN_QUAD_FLOATS, out += TEXTURE_QUAD_FLOATS) {
+            out[0] = x + quad[0] * scale;
+            out[1] = y + quad[1] * scale;
+            out[2] = quad[2] * scale;
+            out[3] = quad[3] * scale;
+            std::memcpy(out + 4, quad + 4, 4 * sizeof(float));
+            out[8] = r; out[9] = g; out[10] = b; out[11] = a;
+        }
+    }
+
+    float textWidth(const Font& font, const std::string& text, float pixelSize) {
+        float width = 0.0f;
+        int previous = -1;
+        size_t index = 0;
+        while (index < text.size()) {
+            int glyph = font.getGlyphIndex(decodeUTF8(text, index));
+            if (previous >= 0) {
+                width += font.getKerning(previous, glyph, pixelSize);
+            }
+            width += font.getAdvance(glyph, pixelSize);
+            previous = glyph;
+        }
+        return width;
+    }
+
+    void _destroyText() {
+        runCache.clear();
+        cachedRunCount = 0;
+        sdfRunCache.clear();
+        cachedSDFRunCount = 0;
+        sdfTextBatch.destroy();
+        sdfTextShader.destroy();
+        GlyphAtlas::getInstance().destroy();
+        SDFAtlas::getInstance().destroy();
+    }
+
+} // namespace Render
+} // namespace cridgeon
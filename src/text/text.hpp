@@ -0,0 +1,52 @@
+/// @file text.hpp
+/// @brief Text rendering through the glyph atlases. Strings are laid out once
+///        into runs of glyph quads that are cached per font, size and string;
+///        drawing a cached run only copies its quads into an instanced batch,
+///        so labels share draw calls with each other (and bitmap text with
+///        Render::textureQuad). Distance field runs are cached per font and
+///        string only and scaled when drawn.
+
+#ifndef CRIDGEON_TEXT_HPP
+#define CRIDGEON_TEXT_HPP
+
+#include "font.hpp"
+
+#include <string>
+
+namespace cridgeon {
+namespace Render {
+    /// @brief Draws a single line of UTF-8 text. Positions are snapped to
+    ///        whole pixels so glyphs stay sharp.
+    /// @param font The font to draw with.
+    /// @param text The UTF-8 string.
+    /// @param x The x position of the pen at the start of the baseline.
+    /// @param y The y position of the baseline (y up).
+    /// @param pixelSize The font size in pixels per em.
+    /// @param r Red component (0.0 to 1.0).
+    /// @param g Green component (0.0 to 1.0).
+    /// @param b Blue component (0.0 to 1.0).
+    /// @param a Alpha component (0.0 to 1.0).
+    void text(const Font& font, const std::string& text,
+              float x, float y, float pixelSize,
+              float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f);
+
+    /// @brief Draws a single line of UTF-8 text from the signed distance
+    ///        field atlas. Every size shares one atlas entry per glyph, so
+    ///        this suits text that is scaled or zoomed continuously. Glyphs
+    ///        still being generated are skipped until they are ready; call
+    ///        SDFAtlas::getInstance().finishPending() to wait for them.
+    /// @see text for the parameters.
+    void sdfText(const Font& font, const std::string& text,
+                 float x, float y, float pixelSize,
+                 float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f);
+
+    /// @brief Measures the advance width of a single line of UTF-8 text.
+    /// @returns The width in pixels, including kerning.
+    float textWidth(const Font& font, const std::string& text, float pixelSize);
+
+    /// @brief Clean up the run caches, glyph atlases and SDF shader.
+    void _destroyText();
+} // namespace Render
+} // namespace cridgeon
+
+#endif // CRIDGEON_TEXT_HPP
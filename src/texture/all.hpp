@@ -7,13 +7,14 @@
 #pragma once
 
 #include "texture.hpp"
+#include "sampler.hpp"
 
 namespace cridgeon {
     /// @brief Cleanup function for texture resources.
-    ///        Currently no global texture cleanup needed as textures are RAII.
+    ///        Individual textures handle their own cleanup; this releases the
+    ///        shared sampler objects.
     inline void destroyAllTextures() {
-        // Individual textures handle their own cleanup via RAII
-        // This function exists for consistency with other modules
+        destroyAllSamplers();
     }
 
     /// @brief Example function demonstrating texture usage.
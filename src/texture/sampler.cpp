@@ -0,0 +1,130 @@
+/// @file sampler.cpp
+/// @brief Implementation of the sampler object cache and its texture
+///        parameter fallback for contexts older than GL 3.3.
+
+#include "sampler.hpp"
+#include "gl_capabilities.hpp"
+#include <glad/gl.h>
+
+namespace cridgeon {
+
+    constexpr uint32_t SamplerCache::NO_SAMPLER;
+
+    // Defined in texture.cpp
+    GLenum filterToGL(Texture::Filter filter);
+    GLenum wrapToGL(Texture::Wrap wrap);
+
+    SamplerCache& SamplerCache::getInstance() {
+        static SamplerCache instance;
+        return instance;
+    }
+
+    bool SamplerCache::hasSamplerObjects() const {
+        return glCapabilities().samplerObjects;
+    }
+
+    unsigned int SamplerCache::get(const SamplerState& state) {
+        if (!hasSamplerObjects()) {
+            return 0;
+        }
+
+        uint32_t key = state.key();
+        auto it = samplers.find(key);
+        if (it != samplers.end()) {
+            return it->second;
+        }
+
+        unsigned int sampler = 0;
+        glGenSamplers(1, &sampler);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, filterToGL(state.min_filter));
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, filterToGL(state.mag_filter));
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrapToGL(state.wrap_s));
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrapToGL(state.wrap_t));
+        samplers[key] = sampler;
+        return sampler;
+    }
+
+    void SamplerCache::bind(unsigned int texture_unit, const SamplerState& state, unsigned int texture_id) {
+        uint32_t key = state.key();
+
+        if (hasSamplerObjects()) {
+            if (bound_keys.size() <= texture_unit) {
+                bound_keys.resize(texture_unit + 1, NO_SAMPLER);
+            }
+            if (bound_keys[texture_unit] == key) {
+                return;
+            }
+            glBindSampler(texture_unit, get(state));
+            bound_keys[texture_unit] = key;
+            return;
+        }
+
+        // Fallback: write parameters into the texture, but only when they
+        // differ from what was last written for it. Its own parameters are
+        // kept for unbind().
+        if (texture_id == 0) {
+            return;
+        }
+        auto it = texture_states.find(texture_id);
+        if (it != texture_states.end() && it->second.applied_key == key) {
+            return;
+        }
+
+        glActiveTexture(GL_TEXTURE0 + texture_unit);
+        if (it == texture_states.end()) {
+            TextureState texture_state;
+            texture_state.applied_key = NO_SAMPLER;
+            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &texture_state.own[0]);
+            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &texture_state.own[1]);
+            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &texture_state.own[2]);
+            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &texture_state.own[3]);
+            it = texture_states.emplace(texture_id, texture_state).first;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filterToGL(state.min_filter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filterToGL(state.mag_filter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapToGL(state.wrap_s));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapToGL(state.wrap_t));
+        it->second.applied_key = key;
+    }
+
+    void SamplerCache::unbind(unsigned int texture_unit, unsigned int texture_id) {
+        if (!hasSamplerObjects()) {
+            auto it = texture_states.find(texture_id);
+            if (it == texture_states.end() || it->second.applied_key == NO_SAMPLER) {
+                return;
+            }
+            const int* own = it->second.own;
+            glActiveTexture(GL_TEXTURE0 + texture_unit);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, own[0]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, own[1]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, own[2]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, own[3]);
+            it->second.applied_key = NO_SAMPLER;
+            return;
+        }
+        if (texture_unit >= bound_keys.size() || bound_keys[texture_unit] == NO_SAMPLER) {
+            return;
+        }
+        glBindSampler(texture_unit, 0);
+        bound_keys[texture_unit] = NO_SAMPLER;
+    }
+
+    void SamplerCache::forgetTexture(unsigned int texture_id) {
+        texture_states.erase(texture_id);
+    }
+
+    void SamplerCache::destroy() {
+        for (size_t unit = 0; unit < bound_keys.size(); ++unit) {
+            if (bound_keys[unit] != NO_SAMPLER) {
+                glBindSampler(static_cast<unsigned int>(unit), 0);
+            }
+        }
+        for (auto& entry : samplers) {
+            glDeleteSamplers(1, &entry.second);
+        }
+        samplers.clear();
+        texture_states.clear();
+        bound_keys.clear();
+    }
+
+}
@@ -0,0 +1,116 @@
+/// @file sampler.hpp
+/// @brief Sampler state descriptors and a cache of OpenGL sampler objects.
+///        Sampling state is bound per texture unit at draw time instead of
+///        being written into the texture, so one texture can be sampled
+///        with different filters in the same frame (or the same draw, by
+///        binding it to two units). Contexts without sampler objects
+///        (GL < 3.3) fall back to texture parameters, skipping redundant
+///        parameter writes.
+#ifndef CRIDGEON_SAMPLER_HPP
+#define CRIDGEON_SAMPLER_HPP
+
+#include "texture.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cridgeon {
+    /// @brief Describes how a texture is filtered and wrapped when sampled.
+    struct SamplerState {
+        Texture::Filter min_filter = Texture::Filter::LINEAR;
+        Texture::Filter mag_filter = Texture::Filter::LINEAR;
+        Texture::Wrap wrap_s = Texture::Wrap::CLAMP_TO_EDGE;
+        Texture::Wrap wrap_t = Texture::Wrap::CLAMP_TO_EDGE;
+
+        /// @brief Packs the state into a key suitable for hashing and batching.
+        /// @returns A key that is equal for equal states.
+        uint32_t key() const {
+            return  static_cast<uint32_t>(min_filter)
+                 | (static_cast<uint32_t>(mag_filter) << 4)
+                 | (static_cast<uint32_t>(wrap_s) << 8)
+                 | (static_cast<uint32_t>(wrap_t) << 12);
+        }
+
+        bool operator==(const SamplerState& other) const { return key() == other.key(); }
+        bool operator!=(const SamplerState& other) const { return key() != other.key(); }
+
+        /// @brief Nearest-neighbour filtering with the given wrap mode.
+        static SamplerState nearest(Texture::Wrap wrap = Texture::Wrap::CLAMP_TO_EDGE) {
+            return SamplerState{Texture::Filter::NEAREST, Texture::Filter::NEAREST, wrap, wrap};
+        }
+
+        /// @brief Bilinear filtering with the given wrap mode.
+        static SamplerState linear(Texture::Wrap wrap = Texture::Wrap::CLAMP_TO_EDGE) {
+            return SamplerState{Texture::Filter::LINEAR, Texture::Filter::LINEAR, wrap, wrap};
+        }
+
+        /// @brief Trilinear filtering with the given wrap mode. Requires mipmaps.
+        static SamplerState trilinear(Texture::Wrap wrap = Texture::Wrap::CLAMP_TO_EDGE) {
+            return SamplerState{Texture::Filter::LINEAR_MIPMAP_LINEAR, Texture::Filter::LINEAR, wrap, wrap};
+        }
+    };
+
+    /// @brief Owns one GL sampler object per distinct SamplerState and tracks
+    ///        what is bound on each texture unit to avoid redundant binds.
+    class SamplerCache {
+    public:
+        static SamplerCache& getInstance();
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        /// @brief Checks whether the current context supports sampler objects.
+        /// @returns True on GL 3.3+, false when the texture parameter fallback is used.
+        bool hasSamplerObjects() const;
+
+        /// @brief Gets (creating on first use) the sampler object for a state.
+        /// @param state The sampling state.
+        /// @returns The GL sampler object, or 0 if sampler objects are unsupported.
+        unsigned int get(const SamplerState& state);
+
+        /// @brief Makes a texture unit sample with the given state.
+        /// @param texture_unit The texture unit the texture is bound to.
+        /// @param state The sampling state to use.
+        /// @param texture_id The texture bound on that unit. Only used by the
+        ///                   fallback path, which writes texture parameters.
+        void bind(unsigned int texture_unit, const SamplerState& state, unsigned int texture_id);
+
+        /// @brief Restores the texture's own parameters on a texture unit.
+        /// @param texture_unit The texture unit to unbind the sampler from.
+        /// @param texture_id The texture bound on that unit. Only used by the
+        ///                   fallback path, which writes back the parameters
+        ///                   the texture had before bind() overrode them.
+        void unbind(unsigned int texture_unit, unsigned int texture_id = 0);
+
+        /// @brief Forgets the fallback parameter state recorded for a texture.
+        ///        Call when a texture's parameters are changed or it is deleted.
+        /// @param texture_id The texture whose recorded state is discarded.
+        void forgetTexture(unsigned int texture_id);
+
+        /// @brief Deletes all sampler objects. Requires a current context.
+        void destroy();
+
+    private:
+        SamplerCache() = default;
+
+        static constexpr uint32_t NO_SAMPLER = 0xFFFFFFFFu;
+
+        std::unordered_map<uint32_t, unsigned int> samplers;        // state key -> GL sampler
+        /// @brief Fallback record of a texture whose parameters bind() overrode.
+        struct TextureState {
+            uint32_t applied_key;       // NO_SAMPLER while its own parameters apply
+            int own[4];                 // min filter, mag filter, wrap s, wrap t
+        };
+
+        std::unordered_map<unsigned int, TextureState> texture_states;  // texture -> state (fallback)
+        std::vector<uint32_t> bound_keys;                           // unit -> bound state key
+    };
+
+    /// @brief Deletes all cached sampler objects.
+    inline void destroyAllSamplers() {
+        SamplerCache::getInstance().destroy();
+    }
+}
+
+#endif // CRIDGEON_SAMPLER_HPP
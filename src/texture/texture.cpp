@@ -6,6 +6,9 @@
 ///        parameter setting, and proper resource cleanup.
 
 #include "texture.hpp"
+#include "sampler.hpp"
+#include "shader/batch.hpp"
+#include "software/rasterizer.hpp"
 #include <glad/gl.h>
 #include <iostream>
 
@@ -86,6 +89,10 @@ namespace cridgeon {
 
         // Clean up existing texture if any
         if (texture_id != 0) {
+            // Quads already queued must draw with the old texture
+            Render::flushBatches();
+            SamplerCache::getInstance().forgetTexture(texture_id);
+            SoftwareRasterizer::getInstance().forgetTexture(texture_id);
             glDeleteTextures(1, &texture_id);
         }
 
@@ -174,6 +181,9 @@ namespace cridgeon {
 
         // Clean up existing texture if any
         if (texture_id != 0) {
+            Render::flushBatches();
+            SamplerCache::getInstance().forgetTexture(texture_id);
+            SoftwareRasterizer::getInstance().forgetTexture(texture_id);
             glDeleteTextures(1, &texture_id);
         }
 
@@ -223,6 +233,46 @@ namespace cridgeon {
         return true;
     }
 
+    bool Texture::updateRegion(int x, int y, int width, int height,
+                               const unsigned char* data, Format format) {
+        if (texture_id == 0 || texture_type != Type::TEXTURE_2D) {
+            std::cerr << "Error: Attempting to update region of invalid texture" << std::endl;
+            return false;
+        }
+
+        if (!data || width <= 0 || height <= 0 || x < 0 || y < 0 ||
+            x + width > this->width || y + height > this->height) {
+            std::cerr << "Error: Invalid texture region " << width << "x" << height
+                      << " at " << x << "," << y << std::endl;
+            return false;
+        }
+
+        Render::flushBatches();
+        glBindTexture(GL_TEXTURE_2D, texture_id);
+
+        // Set pixel unpack alignment to 1 to avoid row padding issues
+        GLint prev_unpack_alignment;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack_alignment);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        GLenum gl_format = (format == Format::RGBA) ? GL_RGBA : GL_RGB;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, gl_format, GL_UNSIGNED_BYTE, data);
+        SoftwareRasterizer::getInstance().updateTexture(texture_id, x, y, width, height, data,
+                                                        format == Format::RGBA ? 4 : 3);
+
+        // Restore previous alignment
+        glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack_alignment);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        GLenum error = glGetError();
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Error: OpenGL error during texture region update: " << error << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
     void Texture::bind(unsigned int texture_unit) const {
         if (texture_id == 0) {
             std::cerr << "Warning: Attempting to bind invalid texture" << std::endl;
@@ -237,6 +287,13 @@ namespace cridgeon {
         glBindTexture(typeToGL(texture_type), texture_id);
     }
 
+    void Texture::bind(unsigned int texture_unit, const SamplerState& sampler) const {
+        bind(texture_unit);
+        if (texture_id != 0) {
+            SamplerCache::getInstance().bind(texture_unit, sampler, texture_id);
+        }
+    }
+
     void Texture::unbind(unsigned int texture_unit) {
         glActiveTexture(GL_TEXTURE0 + texture_unit);
         glBindTexture(GL_TEXTURE_2D, 0);
@@ -248,11 +305,14 @@ namespace cridgeon {
             return;
         }
 
+        Render::flushBatches();
         GLenum gl_target = typeToGL(texture_type);
         glBindTexture(gl_target, texture_id);
         glTexParameteri(gl_target, GL_TEXTURE_MIN_FILTER, filterToGL(min_filter));
         glTexParameteri(gl_target, GL_TEXTURE_MAG_FILTER, filterToGL(mag_filter));
         glBindTexture(gl_target, 0);
+        SamplerCache::getInstance().forgetTexture(texture_id);
+        SoftwareRasterizer::getInstance().forgetTexture(texture_id);
     }
 
     void Texture::setWrap(Wrap wrap_s, Wrap wrap_t) {
@@ -261,11 +321,14 @@ namespace cridgeon {
             return;
         }
 
+        Render::flushBatches();
         GLenum gl_target = typeToGL(texture_type);
         glBindTexture(gl_target, texture_id);
         glTexParameteri(gl_target, GL_TEXTURE_WRAP_S, wrapToGL(wrap_s));
         glTexParameteri(gl_target, GL_TEXTURE_WRAP_T, wrapToGL(wrap_t));
         glBindTexture(gl_target, 0);
+        SamplerCache::getInstance().forgetTexture(texture_id);
+        SoftwareRasterizer::getInstance().forgetTexture(texture_id);
     }
 
     void Texture::generateMipmaps() {
@@ -274,6 +337,7 @@ namespace cridgeon {
             return;
         }
 
+        Render::flushBatches();
         GLenum gl_target = typeToGL(texture_type);
         glBindTexture(gl_target, texture_id);
         glGenerateMipmap(gl_target);
@@ -402,6 +466,9 @@ namespace cridgeon {
     void Texture::destroy()
     {
         if (texture_id != 0) {
+            Render::flushBatches();
+            SamplerCache::getInstance().forgetTexture(texture_id);
+            SoftwareRasterizer::getInstance().forgetTexture(texture_id);
             glDeleteTextures(1, &texture_id);
             texture_id = 0;
             width = 0;
@@ -10,6 +10,8 @@
 #include <string>
 
 namespace cridgeon {
+    struct SamplerState;
+
     class Texture {
     public:
         enum class Format {
@@ -71,10 +73,28 @@ namespace cridgeon {
         bool loadFromData(const unsigned char* data, int width, int height, 
                          Format format = Format::RGBA);
 
+        /// @brief Uploads pixel data into a region of an existing 2D texture.
+        /// @param x The x offset of the region in pixels.
+        /// @param y The y offset of the region in pixels.
+        /// @param width The width of the region in pixels.
+        /// @param height The height of the region in pixels.
+        /// @param data Pointer to tightly packed pixel data for the region.
+        /// @param format The format of the input data.
+        /// @returns True if the upload succeeded, false otherwise.
+        bool updateRegion(int x, int y, int width, int height,
+                          const unsigned char* data, Format format = Format::RGBA);
+
         /// @brief Binds the texture to the specified texture unit.
         /// @param texture_unit The texture unit to bind to (0-31).
         void bind(unsigned int texture_unit = 0) const;
 
+        /// @brief Binds the texture to the specified texture unit and samples it
+        ///        with the given state, leaving the texture's parameters untouched
+        ///        when sampler objects are available.
+        /// @param texture_unit The texture unit to bind to (0-31).
+        /// @param sampler The sampling state to use for this unit.
+        void bind(unsigned int texture_unit, const SamplerState& sampler) const;
+
         /// @brief Unbinds any texture from the specified texture unit.
         /// @param texture_unit The texture unit to unbind from.
         static void unbind(unsigned int texture_unit = 0);